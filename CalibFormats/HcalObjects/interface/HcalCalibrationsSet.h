@@ -32,6 +32,11 @@ private:
   };
   typedef CalibSetObject Item;
   HcalCalibrations dummy;
+  // HB, HE, HO and HF cells: position in mDenseItems by dense index
+  // of (subdetector, ieta, iphi, depth), filled on the first such cell
+  std::vector<uint32_t> mDenseIndex;
+  std::vector<CalibSetObject> mDenseItems;
+  // other cells, and the ones out of the dense index range
   std::unordered_map<uint32_t,CalibSetObject> mItems;
 };
 
@@ -5,10 +5,51 @@
 #include <iostream>
 #include <utility>
 
+namespace {
+  constexpr int kMaxIEta = 41;
+  constexpr int kMaxIPhi = 72;
+  constexpr int kMaxDepth = 8;
+  constexpr uint32_t kDenseSize = 4*(2*kMaxIEta+1)*kMaxIPhi*kMaxDepth;
+  constexpr uint32_t kNotDense = 0xFFFFFFFFu;
+
+  // dense index of an HB, HE, HO or HF cell given in either format, from
+  // the bits of its raw id as HcalDetId::newForm unpacks them; kNotDense 
+  // for any other id
+  uint32_t denseIndex(const DetId& id) {
+    if (id.det()!=DetId::Hcal || id.subdetId()<HcalBarrel || id.subdetId()>HcalForward)
+      return kNotDense;
+    const uint32_t raw = id.rawId();
+    int ietaAbs, iphi, depth;
+    bool positive;
+    if (raw&HcalDetId::kHcalIdFormat2) {
+      ietaAbs = (raw>>HcalDetId::kHcalEtaOffset2)&HcalDetId::kHcalEtaMask2;
+      iphi = raw&HcalDetId::kHcalPhiMask2;
+      depth = (raw>>HcalDetId::kHcalDepthOffset2)&HcalDetId::kHcalDepthMask2;
+      positive = raw&HcalDetId::kHcalZsideMask2;
+    } else {
+      ietaAbs = (raw>>HcalDetId::kHcalEtaOffset1)&HcalDetId::kHcalEtaMask1;
+      iphi = raw&HcalDetId::kHcalPhiMask1;
+      depth = (raw>>HcalDetId::kHcalDepthOffset1)&HcalDetId::kHcalDepthMask1&HcalDetId::kHcalDepthMask2;
+      positive = raw&HcalDetId::kHcalZsideMask1;
+    }
+    if (ietaAbs>kMaxIEta || iphi<1 || iphi>kMaxIPhi || depth<1 || depth>kMaxDepth)
+      return kNotDense;
+    const int ieta = positive ? ietaAbs : -ietaAbs;
+    return (((id.subdetId()-1)*(2*kMaxIEta+1) + ieta+kMaxIEta)*kMaxIPhi + iphi-1)*kMaxDepth + depth-1;
+  }
+}
+
 HcalCalibrationsSet::HcalCalibrationsSet() 
 {}
 
 const HcalCalibrations& HcalCalibrationsSet::getCalibrations(const DetId fId) const {
+  // no transformed id for the dense cells: the index is the same in both formats
+  const uint32_t index = denseIndex(fId);
+  if (index!=kNotDense) {
+    if (index<mDenseIndex.size() && mDenseIndex[index]!=kNotDense)
+      return mDenseItems[mDenseIndex[index]].calib;
+    throw cms::Exception ("Conditions not found") << "Unavailable HcalCalibrations for cell " << HcalGenericDetId(fId);
+  }
   DetId fId2(hcalTransformedId(fId));
   auto cell = mItems.find(fId2);
   if ((cell == mItems.end()) || (!hcalEqualDetId(cell->first,fId2)))
@@ -18,6 +59,16 @@ const HcalCalibrations& HcalCalibrationsSet::getCalibrations(const DetId fId) co
 
 void HcalCalibrationsSet::setCalibrations(DetId fId, const HcalCalibrations& ca) {
   DetId fId2(hcalTransformedId(fId));
+  const uint32_t index = denseIndex(fId2);
+  if (index!=kNotDense) {
+    if (mDenseIndex.empty()) mDenseIndex.assign(kDenseSize,kNotDense);
+    if (mDenseIndex[index]==kNotDense) {
+      mDenseIndex[index] = mDenseItems.size();
+      mDenseItems.emplace_back(fId2);
+    }
+    mDenseItems[mDenseIndex[index]].calib=ca;
+    return;
+  }
   auto cell = mItems.find(fId2);
   if (cell==mItems.end()) {
     auto result = mItems.emplace(fId2,fId2);
@@ -28,12 +79,17 @@ void HcalCalibrationsSet::setCalibrations(DetId fId, const HcalCalibrations& ca)
 }
 
 void HcalCalibrationsSet::clear() {
+  mDenseIndex.clear();
+  mDenseItems.clear();
   mItems.clear();
 }
 
 std::vector<DetId> HcalCalibrationsSet::getAllChannels() const {
   std::vector<DetId> channels;
-  channels.reserve(mItems.size());
+  channels.reserve(mDenseItems.size()+mItems.size());
+  for(const auto& tmp : mDenseItems){
+    channels.push_back(tmp.id);
+  }
   for(const auto& tmp : mItems){
     channels.push_back(tmp.second.id);
   }
@@ -0,0 +1,148 @@
+// Check HcalCalibrationsSet against a map keyed by the transformed raw id,
+// which is how the set stored all the cells before the HB, HE, HO and HF
+// cells were given a dense index.  The set is filled with HB, HE, HO and HF
+// cells, some of them given in the old HcalDetId format and some outside
+// the dense index range, and with ZDC and calibration channels.  Every cell
+// must give the calibrations of the map, and the same object whether it is
+// looked up by its old-format or its new-format id; cells never set must
+// throw.  The lookups of the HB, HE, HO and HF cells are then timed for the
+// set and for the map.
+
+#include "CalibFormats/HcalObjects/interface/HcalCalibrationsSet.h"
+#include "CondFormats/HcalObjects/interface/HcalDetIdRelationship.h"
+#include "DataFormats/HcalDetId/interface/HcalCalibDetId.h"
+#include "DataFormats/HcalDetId/interface/HcalDetId.h"
+#include "DataFormats/HcalDetId/interface/HcalZDCDetId.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+  // calibrations told apart by their first pedestal
+  HcalCalibrations calibrations(int n) {
+    const float gain[4] = {0.2, 0.2, 0.2, 0.2};
+    const float pedestal[4] = {float(n), 3., 3., 3.};
+    return HcalCalibrations(gain, pedestal, pedestal, 1., 0., 1.);
+  }
+
+  std::vector<DetId> hcalCells() {
+    std::vector<DetId> cells;
+    for (int side : {-1, 1}) {
+      for (int iphi = 1; iphi <= 72; ++iphi) {
+        for (int ieta = 1; ieta <= 16; ++ieta)
+          for (int depth = 1; depth <= (ieta < 15 ? 1 : 2); ++depth)
+            cells.push_back(HcalDetId(HcalBarrel, side*ieta, iphi, depth));
+        for (int ieta = 16; ieta <= 29; ++ieta)
+          for (int depth = 1; depth <= 7; ++depth)
+            cells.push_back(HcalDetId(HcalEndcap, side*ieta, iphi, depth));
+        for (int ieta = 1; ieta <= 15; ++ieta)
+          cells.push_back(HcalDetId(HcalOuter, side*ieta, iphi, 4));
+        if (iphi%2 == 0) continue;
+        for (int ieta = 29; ieta <= 41; ++ieta)
+          for (int depth = 1; depth <= 4; ++depth)
+            cells.push_back(HcalDetId(HcalForward, side*ieta, iphi, depth));
+      }
+    }
+    return cells;
+  }
+
+  std::vector<DetId> otherCells() {
+    std::vector<DetId> cells;
+    // depths beyond the dense index range
+    for (int iphi = 1; iphi <= 72; ++iphi) cells.push_back(HcalDetId(HcalEndcap, 20, iphi, 9));
+    for (bool positive : {false, true}) {
+      for (int channel = 1; channel <= 5; ++channel) cells.push_back(HcalZDCDetId(HcalZDCDetId::EM, positive, channel));
+      for (int channel = 1; channel <= 4; ++channel) cells.push_back(HcalZDCDetId(HcalZDCDetId::HAD, positive, channel));
+      for (int channel = 1; channel <= 2; ++channel) cells.push_back(HcalZDCDetId(HcalZDCDetId::LUM, positive, channel));
+    }
+    for (int iphi = 1; iphi <= 72; iphi += 4)
+      for (int ctype = 0; ctype < 3; ++ctype) cells.push_back(HcalCalibDetId(HcalBarrel, 1, iphi, ctype));
+    return cells;
+  }
+
+  bool throws(const HcalCalibrationsSet& set, const DetId& id) {
+    try {
+      set.getCalibrations(id);
+    } catch (const cms::Exception&) {
+      return true;
+    }
+    return false;
+  }
+
+}
+
+int main() {
+  const std::vector<DetId> hcal = hcalCells();
+  std::vector<DetId> cells = hcal;
+  for (const DetId& id : otherCells()) cells.push_back(id);
+
+  // the set, and the map it used before the dense index
+  HcalCalibrationsSet set;
+  std::unordered_map<uint32_t, HcalCalibrations> map;
+  assert(throws(set, hcal.front()));
+  for (unsigned int i = 0; i < cells.size(); ++i) {
+    // every third HB/HE/HO/HF cell set with its old-format id
+    const DetId id = i < hcal.size() && i%3 == 0 ? DetId(HcalDetId(cells[i]).otherForm()) : cells[i];
+    set.setCalibrations(id, calibrations(i));
+    map[hcalTransformedId(id).rawId()] = calibrations(i);
+  }
+  // setting again replaces the calibrations of the cell
+  for (unsigned int i = 0; i < cells.size(); i += 7) {
+    set.setCalibrations(cells[i], calibrations(-int(i)));
+    map[hcalTransformedId(cells[i]).rawId()] = calibrations(-int(i));
+  }
+
+  int wrong = 0;
+  for (const DetId& id : cells) {
+    const HcalCalibrations& c = set.getCalibrations(id);
+    const HcalCalibrations& expected = map.at(hcalTransformedId(id).rawId());
+    if (c.pedestal(0) != expected.pedestal(0) || c.respcorrgain(0) != expected.respcorrgain(0)) ++wrong;
+  }
+  int notSame = 0;
+  for (const DetId& id : hcal) {
+    const DetId oldId(HcalDetId(id).otherForm());
+    assert((oldId.rawId() & HcalDetId::kHcalIdFormat2) == 0);
+    if (&set.getCalibrations(oldId) != &set.getCalibrations(id)) ++notSame;
+  }
+  const bool allChannels = set.getAllChannels().size() == map.size();
+  std::cout << cells.size() << " cells, " << map.size() << " channels: " << wrong << " wrong calibrations, "
+            << notSame << " old-format ids with another object" << std::endl;
+
+  // cells never set, with and without a dense index
+  const std::vector<DetId> missing = {
+    HcalDetId(HcalBarrel, 1, 1, 3), HcalDetId(HcalOuter, -16, 5, 4), HcalDetId(HcalForward, 30, 2, 1),
+    DetId(HcalDetId(HcalForward, -30, 2, 1).otherForm()), HcalDetId(HcalEndcap, 20, 1, 10),
+    HcalZDCDetId(HcalZDCDetId::RPD, true, 1), HcalCalibDetId(HcalEndcap, 1, 3, 0)
+  };
+  int notThrown = 0;
+  for (const DetId& id : missing) notThrown += !throws(set, id);
+  std::cout << missing.size() << " missing cells: " << notThrown << " without exception" << std::endl;
+
+  // lookup timing of the HB/HE/HO/HF cells in the order of the digis, by
+  // raw id, with the dense index and with the map as the set used it
+  std::vector<DetId> sorted(hcal);
+  std::sort(sorted.begin(), sorted.end());
+  constexpr int nRepeat = 200;
+  double sum = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < nRepeat; ++r)
+    for (const DetId& id : sorted) sum += set.getCalibrations(id).pedestal(0);
+  const std::chrono::duration<double, std::nano> denseTime = std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < nRepeat; ++r)
+    for (const DetId& id : sorted) sum -= map.find(hcalTransformedId(id).rawId())->second.pedestal(0);
+  const std::chrono::duration<double, std::nano> mapTime = std::chrono::steady_clock::now() - start;
+  const double nLookups = double(nRepeat)*sorted.size();
+  std::cout << "lookup time per cell: " << denseTime.count()/nLookups << " ns with the dense index, "
+            << mapTime.count()/nLookups << " ns with the map" << std::endl;
+
+  const bool ok = wrong == 0 && notSame == 0 && allChannels && notThrown == 0 && sum == 0;
+  assert(ok);
+  return ok ? 0 : 1;
+}
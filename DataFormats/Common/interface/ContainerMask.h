@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstddef>
 #include <algorithm>
+#include <utility>
 
 // user include files
 #include "DataFormats/Common/interface/RefProd.h"
@@ -38,6 +39,7 @@ namespace edm {
    public:
       ContainerMask() {}
       ContainerMask(const edm::RefProd<T>& iProd, const std::vector<bool>& iMask);
+      ContainerMask(const edm::RefProd<T>& iProd, std::vector<bool>&& iMask);
       //virtual ~ContainerMask();
 
       // ---------- const member functions ---------------------
@@ -50,6 +52,8 @@ namespace edm {
      	bool mask(const typename ContainerMaskTraits<T>::value_type *);
      	void applyOrTo( std::vector<bool>&) const;
      	void copyMaskTo( std::vector<bool>&) const;
+     	/// the mask itself, to be used without copying it while the ContainerMask is alive
+     	const std::vector<bool>& maskVector() const { return m_mask; }
 
 
       size_t size() const { return m_mask.size();}
@@ -80,6 +84,12 @@ namespace edm {
    }
    
    
+   template<typename T>
+   ContainerMask<T>::ContainerMask(const edm::RefProd<T>& iProd, std::vector<bool>&& iMask):
+   m_prod(iProd), m_mask(std::move(iMask)) {
+      assert(m_mask.size() <= ContainerMaskTraits<T>::size(m_prod.product()));
+   }
+   
    template<typename T>
    bool ContainerMask<T>::mask(const typename ContainerMaskTraits<T>::value_type * iElement )
    {
@@ -0,0 +1,31 @@
+#ifndef EventFilter_SiPixelRawToDigi_PixelDigiSoA_h
+#define EventFilter_SiPixelRawToDigi_PixelDigiSoA_h
+
+/** \class PixelDigiSoA
+ *
+ *  Per-event structure-of-arrays buffer of the pixel digis of all the
+ *  unpacked FEDs, in the order of the raw data (i.e. grouped by link/ROC,
+ *  not by module). Filled by PixelDataFormatter::interpretRawData.
+ */
+
+#include <cstdint>
+#include <vector>
+
+struct PixelDigiSoA {
+  std::vector<uint32_t> rawId;
+  std::vector<uint16_t> row;
+  std::vector<uint16_t> col;
+  std::vector<uint16_t> adc;
+
+  unsigned int size() const { return rawId.size();}
+  bool empty() const { return rawId.empty();}
+
+  void reserve(unsigned int n) { rawId.reserve(n); row.reserve(n); col.reserve(n); adc.reserve(n);}
+  void clear() { rawId.clear(); row.clear(); col.clear(); adc.clear();}
+
+  void push_back(uint32_t id, uint16_t r, uint16_t c, uint16_t a) {
+    rawId.push_back(id); row.push_back(r); col.push_back(c); adc.push_back(a);
+  }
+};
+
+#endif
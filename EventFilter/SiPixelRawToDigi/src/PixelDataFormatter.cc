@@ -124,7 +124,43 @@ void PixelDataFormatter::passFrameReverter(const SiPixelFrameReverter* reverter)
   theFrameReverter = reverter;
 }
 
+namespace {
+  // where the unpacked digis go
+  struct DetSetVectorOutput {
+    PixelDataFormatter::Collection & digis;
+    edm::DetSet<PixelDigi> * detDigis=nullptr;
+    void newModule(cms_uint32_t rawId) {
+      detDigis = &digis.find_or_insert(rawId);
+      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+    }
+    void push_back(int row, int col, int adc) {
+      (*detDigis).data.emplace_back(row, col, adc);
+      LogTrace("") << (*detDigis).data.back();
+    }
+  };
+
+  struct SoAOutput {
+    PixelDigiSoA & digis;
+    cms_uint32_t rawId=0;
+    void newModule(cms_uint32_t id) { rawId=id;}
+    void push_back(int row, int col, int adc) { digis.push_back(rawId, row, col, adc);}
+  };
+}
+
 void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Collection & digis, Errors& errors)
+{
+  DetSetVectorOutput output{digis};
+  interpretRawDataT(errorsInEvent, fedId, rawData, output, errors);
+}
+
+void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const FEDRawData& rawData, PixelDigiSoA & digis, Errors& errors)
+{
+  SoAOutput output{digis};
+  interpretRawDataT(errorsInEvent, fedId, rawData, output, errors);
+}
+
+template<typename Output>
+void PixelDataFormatter::interpretRawDataT(bool& errorsInEvent, int fedId, const FEDRawData& rawData, Output & output, Errors& errors)
 {
   using namespace sipixelobjects;
 
@@ -166,7 +202,6 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
   int layer = 0;
   PixelROC const * rocp=nullptr;
   bool skipROC=false;
-  edm::DetSet<PixelDigi> * detDigis=nullptr;
 
   const  Word32 * bw =(const  Word32 *)(header+1);
   const  Word32 * ew =(const  Word32 *)(trailer);
@@ -208,8 +243,7 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
       skipROC= modulesToUnpack && ( modulesToUnpack->find(rawId) == modulesToUnpack->end());
       if (skipROC) continue;
       
-      detDigis = &digis.find_or_insert(rawId);
-      if ( (*detDigis).empty() ) (*detDigis).data.reserve(32); // avoid the first relocations
+      output.newModule(rawId);
     }
 
     // skip is roc to be skipped ot invalid
@@ -258,9 +292,8 @@ void PixelDataFormatter::interpretRawData(bool& errorsInEvent, int fedId, const
     }    
 
     GlobalPixel global = rocp->toGlobal( *local ); // global pixel coordinate (in module)
-    (*detDigis).data.emplace_back(global.row, global.col, adc);
+    output.push_back(global.row, global.col, adc);
     //if(DANEK) cout<<global.row<<" "<<global.col<<" "<<adc<<endl;    
-    LogTrace("") << (*detDigis).data.back();
   }
 
 }
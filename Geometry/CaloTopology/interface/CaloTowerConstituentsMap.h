@@ -30,7 +30,7 @@ public:
   /// set the association between a DetId and a tower
   void assign(const DetId& cell, const CaloTowerDetId& tower);
 
-  /// done adding to the association
+  /// done adding to the association (to be called after the useStandard* settings)
   void sort();
 
   /// add standard (hardcoded) HB items?
@@ -63,6 +63,11 @@ private:
   };
 
   edm::SortedCollection<MapItem> m_items;
+  // towers of the EB and EE cells by hashed index, filled by sort()
+  std::vector<MapItem> m_ebItems;
+  std::vector<MapItem> m_eeItems;
+  // whether m_items holds HCAL cells, otherwise they are not searched for
+  bool m_hcalItems;
   mutable std::atomic<std::multimap<CaloTowerDetId,DetId>*> m_reverseItems;
 };
 
@@ -1,10 +1,12 @@
 #include "Geometry/CaloTopology/interface/CaloTowerConstituentsMap.h"
 #include "DataFormats/HcalDetId/interface/HcalDetId.h"
 #include "DataFormats/EcalDetId/interface/EBDetId.h"
+#include "DataFormats/EcalDetId/interface/EEDetId.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "Geometry/CaloTopology/interface/HcalTopology.h"
 #include "Geometry/CaloTopology/interface/CaloTowerTopology.h"
 
+#include <algorithm>
 #include <memory>
 
 //#define EDM_ML_DEBUG
@@ -21,6 +23,7 @@ CaloTowerConstituentsMap::CaloTowerConstituentsMap(const HcalTopology * hcaltopo
   standardHF_(false),
   standardHO_(false),
   standardEB_(false),
+  m_hcalItems(true),
   m_reverseItems(nullptr)
 {
 }
@@ -28,8 +31,29 @@ CaloTowerConstituentsMap::CaloTowerConstituentsMap(const HcalTopology * hcaltopo
 CaloTowerDetId CaloTowerConstituentsMap::towerOf(const DetId& id) const {
   CaloTowerDetId tid; // null to start with
 
-  edm::SortedCollection<MapItem>::const_iterator i=m_items.find(id);
-  if (i!=m_items.end()) tid=i->tower;
+  // ECAL cells: direct lookup in the tables filled by sort()
+  if (id.det()==DetId::Ecal) {
+    const std::vector<MapItem>* table = nullptr;
+    unsigned int index = 0;
+    if (id.subdetId()==EcalBarrel && !m_ebItems.empty()) {
+      table = &m_ebItems;
+      index = EBDetId(id).hashedIndex();
+    } else if (id.subdetId()==EcalEndcap && !m_eeItems.empty()) {
+      EEDetId eeid(id);
+      if (eeid.ix()>=EEDetId::IX_MIN && eeid.ix()<=EEDetId::IX_MAX &&
+	  eeid.iy()>=EEDetId::IY_MIN && eeid.iy()<=EEDetId::IY_MAX) {
+	table = &m_eeItems;
+	index = eeid.hashedIndex();
+      }
+    }
+    if (table!=nullptr && index<table->size() && (*table)[index].cell==id)
+      return (*table)[index].tower;
+  }
+
+  if (id.det()!=DetId::Hcal || m_hcalItems) {
+    edm::SortedCollection<MapItem>::const_iterator i=m_items.find(id);
+    if (i!=m_items.end()) tid=i->tower;
+  }
 
   //use hcaltopo when dealing with hcal detids
   if (tid.null()) {
@@ -62,6 +86,26 @@ void CaloTowerConstituentsMap::assign(const DetId& cell, const CaloTowerDetId& t
 
 void CaloTowerConstituentsMap::sort() {
   m_items.sort();
+  m_hcalItems = std::any_of(m_items.begin(), m_items.end(),
+			    [](const MapItem& item) { return item.cell.det()==DetId::Hcal; });
+
+  // tabulate the towers of all the ECAL cells (from the items and the standard
+  // EB mapping), so that towerOf does not search the items for them
+  m_ebItems.clear();
+  m_eeItems.clear();
+  std::vector<MapItem> ebItems, eeItems;
+  ebItems.reserve(EBDetId::kSizeForDenseIndexing);
+  for (int i=0; i<EBDetId::kSizeForDenseIndexing; ++i) {
+    const EBDetId id(EBDetId::unhashIndex(i));
+    ebItems.emplace_back(id, towerOf(id));
+  }
+  eeItems.reserve(EEDetId::kSizeForDenseIndexing);
+  for (int i=0; i<EEDetId::kSizeForDenseIndexing; ++i) {
+    const EEDetId id(EEDetId::unhashIndex(i));
+    eeItems.emplace_back(id, towerOf(id));
+  }
+  m_ebItems.swap(ebItems);
+  m_eeItems.swap(eeItems);
   
 //  for (auto const & it : m_items)
 //    std::cout << std::hex << it.cell.rawId() << " " << it.tower.rawId() << std::dec << std::endl;
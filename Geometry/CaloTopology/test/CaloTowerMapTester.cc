@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -13,9 +14,12 @@
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 
 #include "Geometry/Records/interface/CaloGeometryRecord.h"
+#include "Geometry/Records/interface/HcalRecNumberingRecord.h"
 #include "Geometry/HcalTowerAlgo/interface/HcalGeometry.h"
 #include "Geometry/CaloGeometry/interface/CaloGeometry.h"
 #include "Geometry/CaloTopology/interface/CaloTowerConstituentsMap.h"
+#include "Geometry/CaloTopology/interface/CaloTowerTopology.h"
+#include "Geometry/CaloTopology/interface/HcalTopology.h"
 #include "DataFormats/CaloTowers/interface/CaloTowerDetId.h"
 #include "DataFormats/EcalDetId/interface/EBDetId.h"
 #include "DataFormats/EcalDetId/interface/EEDetId.h"
@@ -37,6 +41,8 @@ private:
   void beginRun(edm::Run const&, edm::EventSetup const&) override {}
   void endRun(edm::Run const&, edm::EventSetup const&) override {}
   void doTest(const CaloGeometry* geo, const CaloTowerConstituentsMap* ctmap);
+  void compareWithUnsorted(const CaloGeometry* geo, const CaloTowerConstituentsMap* ctmap,
+			   const HcalTopology* hcaltopo, const CaloTowerTopology* cttopo);
 
 private:
   // ----------member data ---------------------------
@@ -56,8 +62,14 @@ void CaloTowerMapTester::analyze(edm::Event const&, edm::EventSetup const& iSetu
   iSetup.get<CaloGeometryRecord>().get(pG);
   edm::ESHandle<CaloTowerConstituentsMap> ct;
   iSetup.get<CaloGeometryRecord>().get(ct);
-  if (pG.isValid() && ct.isValid()) doTest(pG.product(),ct.product());
-  else std::cout << "CaloGeometry in EventSetup " << pG.isValid() 
+  edm::ESHandle<HcalTopology> hcaltopo;
+  iSetup.get<HcalRecNumberingRecord>().get(hcaltopo);
+  edm::ESHandle<CaloTowerTopology> cttopo;
+  iSetup.get<HcalRecNumberingRecord>().get(cttopo);
+  if (pG.isValid() && ct.isValid()) {
+    doTest(pG.product(),ct.product());
+    compareWithUnsorted(pG.product(),ct.product(),hcaltopo.product(),cttopo.product());
+  } else std::cout << "CaloGeometry in EventSetup " << pG.isValid() 
 		 << " and CaloTowerConstituentsMap " << ct.isValid()
 		 << std::endl;
 }
@@ -89,6 +101,67 @@ void CaloTowerMapTester::doTest(const CaloGeometry* geo,
     }
   }
 
+  // the towers of the ECAL cells come from the tables filled when the map is
+  // sorted: check that each cell is a constituent of its tower
+  for (int subdet : {EcalBarrel, EcalEndcap}) {
+    const std::vector<DetId>& ecalDets = geo->getValidDetIds(DetId::Ecal,subdet);
+    unsigned int nbad(0);
+    for (const auto& id: ecalDets) {
+      CaloTowerDetId tower = ctmap->towerOf(id);
+      if (tower.null()) continue;
+      std::vector<DetId> ids = ctmap->constituentsOf(tower);
+      if (std::find(ids.begin(),ids.end(),id) == ids.end()) {
+	std::cout << "ECAL cell " << std::hex << id.rawId() << std::dec
+		  << " is not a constituent of its tower " << tower << std::endl;
+	++nbad;
+      }
+    }
+    std::cout << ecalDets.size() << " cells of ECAL subdetector " << subdet
+	      << " tested, " << nbad << " not found in the constituents of their tower\n";
+  }
+}
+
+// build a second map with the same ECAL items, taken from the constituents of
+// all the towers, and the standard EB mapping, but without calling sort(): its
+// towerOf searches the items, as before the ECAL tables.  The items are
+// assigned in the order of their ids, since the search needs them sorted.
+void CaloTowerMapTester::compareWithUnsorted(const CaloGeometry* geo,
+					     const CaloTowerConstituentsMap* ctmap,
+					     const HcalTopology* hcaltopo,
+					     const CaloTowerTopology* cttopo) {
+
+  std::vector<std::pair<DetId,CaloTowerDetId> > items;
+  for (uint32_t i=0; i<cttopo->sizeForDenseIndexing(); ++i) {
+    const CaloTowerDetId tower = cttopo->detIdFromDenseIndex(i);
+    for (const auto& id : ctmap->constituentsOf(tower)) {
+      if (id.det()!=DetId::Ecal) continue;
+      // the EB cells of the standard mapping are not items
+      if (id.subdetId()==EcalBarrel &&
+	  CaloTowerDetId(EBDetId(id).tower_ieta(),EBDetId(id).tower_iphi())==tower) continue;
+      items.emplace_back(id,tower);
+    }
+  }
+  std::sort(items.begin(),items.end());
+
+  CaloTowerConstituentsMap unsorted(hcaltopo,cttopo);
+  unsorted.useStandardEB(true);
+  for (const auto& item : items) unsorted.assign(item.first,item.second);
+
+  for (int subdet : {EcalBarrel, EcalEndcap}) {
+    const std::vector<DetId>& ecalDets = geo->getValidDetIds(DetId::Ecal,subdet);
+    unsigned int nbad(0);
+    for (const auto& id: ecalDets) {
+      if (ctmap->towerOf(id) != unsorted.towerOf(id)) {
+	std::cout << "ECAL cell " << std::hex << id.rawId() << std::dec
+		  << " is in tower " << ctmap->towerOf(id) << " with the tables, "
+		  << unsorted.towerOf(id) << " without\n";
+	++nbad;
+      }
+    }
+    std::cout << ecalDets.size() << " cells of ECAL subdetector " << subdet
+	      << " compared with the unsorted map (" << items.size() << " ECAL items), "
+	      << nbad << " in another tower\n";
+  }
 }
 
 //define this as a plug-in
@@ -4,5 +4,18 @@ VolumeBasedMagneticFieldESProducer = cms.ESProducer("VolumeBasedMagneticFieldESP
     label = cms.untracked.string(''),
     debugBuilder = cms.untracked.bool(False),
     valueOverride = cms.int32(-1), # Force value of current (in A); take the value from DB if < 0.
+    # Optionally produce, under a separate label, a table of the map
+    # interpolated on a cylindrical grid (cm, Tesla); the map itself is
+    # still produced under the label above
+    tabulation = cms.PSet(
+        enable = cms.bool(False),
+        label = cms.untracked.string('tabulated'),
+        rMax = cms.double(120.),
+        zMax = cms.double(300.),
+        dr = cms.double(2.),
+        dz = cms.double(2.),
+        nPhi = cms.uint32(16),
+        tolerance = cms.double(1.e-3), # max difference wrt the VB map at the cell centers
+    ),
 )
 
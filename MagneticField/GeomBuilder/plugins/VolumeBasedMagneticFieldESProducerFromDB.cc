@@ -13,6 +13,7 @@
 #include "MagneticField/Engine/interface/MagneticField.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "MagneticField/VolumeBasedEngine/interface/VolumeBasedMagneticField.h"
+#include "MagneticField/VolumeBasedEngine/interface/TabulatedMagneticField.h"
 #include "MagneticField/ParametrizedEngine/interface/ParametrizedMagneticFieldFactory.h"
 
 #include "MagneticField/Records/interface/IdealMagneticFieldRecord.h"
@@ -54,6 +55,8 @@ namespace magneticfield {
   
     std::unique_ptr<MagneticField> produce(const IdealMagneticFieldRecord & iRecord);
 
+    std::unique_ptr<MagneticField> produceTabulated(const IdealMagneticFieldRecord & iRecord);
+
   private:
     // forbid copy ctor and assignment op.
     VolumeBasedMagneticFieldESProducerFromDB(const VolumeBasedMagneticFieldESProducerFromDB&) = delete;
@@ -61,6 +64,7 @@ namespace magneticfield {
     std::string closerNominalLabel(float current);
 
     edm::ParameterSet pset;
+    std::string label;
     std::vector<int> nominalCurrents;
     std::vector<std::string> nominalLabels;
 
@@ -68,9 +72,18 @@ namespace magneticfield {
 }
 
 
-VolumeBasedMagneticFieldESProducerFromDB::VolumeBasedMagneticFieldESProducerFromDB(const edm::ParameterSet& iConfig) : pset(iConfig)
+VolumeBasedMagneticFieldESProducerFromDB::VolumeBasedMagneticFieldESProducerFromDB(const edm::ParameterSet& iConfig) :
+  pset(iConfig),
+  label(iConfig.getUntrackedParameter<std::string>("label",""))
 {
-  setWhatProduced(this, pset.getUntrackedParameter<std::string>("label",""));
+  setWhatProduced(this, label);
+  // Optionally, a table of the map under a separate label (see TabulatedMagneticField)
+  if (pset.existsAs<edm::ParameterSet>("tabulation")) {
+    auto const & tpset = pset.getParameter<edm::ParameterSet>("tabulation");
+    if (tpset.getParameter<bool>("enable"))
+      setWhatProduced(this, &VolumeBasedMagneticFieldESProducerFromDB::produceTabulated,
+		      edm::es::Label(tpset.getUntrackedParameter<std::string>("label","tabulated")));
+  }
   nominalCurrents={-1, 0,9558,14416,16819,18268,19262};
   nominalLabels  ={"3.8T","0T","2T", "3T", "3.5T", "3.8T", "4T"};
 }
@@ -153,6 +166,25 @@ std::unique_ptr<MagneticField> VolumeBasedMagneticFieldESProducerFromDB::produce
 }
 
 
+// Table of the map produced above. It refers to the map, which lives in the
+// same record and is therefore replaced at the same time.
+std::unique_ptr<MagneticField> VolumeBasedMagneticFieldESProducerFromDB::produceTabulated(const IdealMagneticFieldRecord & iRecord)
+{
+  ESHandle<MagneticField> field;
+  iRecord.get(label, field);
+
+  auto const & tpset = pset.getParameter<edm::ParameterSet>("tabulation");
+  TabulatedMagneticField::Grid grid;
+  grid.rMax = tpset.getParameter<double>("rMax");
+  grid.zMax = tpset.getParameter<double>("zMax");
+  grid.dr = tpset.getParameter<double>("dr");
+  grid.dz = tpset.getParameter<double>("dz");
+  grid.nPhi = tpset.getParameter<unsigned int>("nPhi");
+  grid.tolerance = tpset.getParameter<double>("tolerance");
+  return std::make_unique<TabulatedMagneticField>(*field, grid);
+}
+
+
 std::string VolumeBasedMagneticFieldESProducerFromDB::closerNominalLabel(float current) {
 
   int i=0;
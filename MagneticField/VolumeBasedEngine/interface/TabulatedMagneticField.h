@@ -0,0 +1,85 @@
+#ifndef MagneticField_TabulatedMagneticField_h
+#define MagneticField_TabulatedMagneticField_h
+
+/** \class TabulatedMagneticField
+ *
+ *  Field engine interpolating a table of the field of another engine
+ *  (typically VolumeBasedMagneticField) precomputed on a regular
+ *  cylindrical (r, phi, z) grid, built once per IOV.
+ *  A query is a direct index computation plus a trilinear interpolation
+ *  of (Br, Bphi, Bz) done on 4-wide float vectors, with no volume finding
+ *  and no virtual calls. Outside the tabulated region the query is
+ *  forwarded to the source engine.
+ *  It is published next to the source, under its own label, so that the
+ *  consumers of the source (some of which use the VolumeBasedMagneticField
+ *  interface) are not affected.
+ *
+ *  At construction the table is compared to the source engine at the
+ *  center of each cell; an exception is thrown if the largest difference
+ *  exceeds the requested tolerance.
+ */
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+#include "DataFormats/Math/interface/ExtVec.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+class TabulatedMagneticField final : public MagneticField {
+ public:
+
+  struct Grid {
+    float rMax=120.f;     // cm
+    float zMax=300.f;     // cm, table covers |z|<zMax
+    float dr=2.f;         // cm
+    float dz=2.f;         // cm
+    unsigned int nPhi=16; // 1 for a phi-symmetric field
+    float tolerance=1.e-3f; // Tesla, max allowed difference wrt the source at the cell centers
+  };
+
+  /// Tabulate source on grid; source must outlive the table
+  TabulatedMagneticField(const MagneticField & source, const Grid & grid);
+
+  /// Tabulate source (ownership is taken) on grid
+  TabulatedMagneticField(std::unique_ptr<MagneticField> source, const Grid & grid);
+  ~TabulatedMagneticField() override;
+
+  GlobalVector inTesla (const GlobalPoint& gp) const override;
+
+  GlobalVector inTeslaUnchecked (const GlobalPoint& gp) const override;
+
+  bool isDefined(const GlobalPoint& gp) const override { return theSource->isDefined(gp);}
+
+  const MagneticField & source() const { return *theSource;}
+
+  /// largest difference wrt the source found at construction (Tesla)
+  float maxDeviation() const { return theMaxDeviation;}
+
+  bool inTable(float r, float z) const { return r<theRMax && std::abs(z)<theZMax;}
+
+ private:
+
+  int computeNominalValue() const override { return theSource->nominalValue();}
+
+  GlobalVector interpolate(float x, float y, float z, float r) const;
+
+  unsigned int index(unsigned int ir, unsigned int iphi, unsigned int iz) const {
+    return (iz*theNPhi+iphi)*theNR+ir;
+  }
+
+  std::unique_ptr<MagneticField> theOwnedSource;
+  const MagneticField * theSource;
+
+  float theRMax, theZMax;
+  float theZ0;             // z of the first node (-zMax rounded to the grid)
+  float theInvDr, theInvDz, theInvDPhi;
+  unsigned int theNR, theNPhi, theNZ;
+
+  // (Br, Bphi, Bz, 0) at each node, r running fastest
+  std::vector<Vec4F> theTable;
+
+  float theMaxDeviation;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "MagneticField/VolumeBasedEngine/interface/TabulatedMagneticField.h"
+#include "DataFormats/Math/interface/approx_atan2.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace {
+  constexpr float twoPi = 2.f*M_PI;
+
+  inline float nodePhi(unsigned int iphi, float dPhi) { return -float(M_PI)+iphi*dPhi;}
+
+  // field of the source in cylindrical components wrt the direction phi
+  inline Vec4F cylindrical(const MagneticField & field, float r, float phi, float z) {
+    float c = std::cos(phi), s = std::sin(phi);
+    GlobalVector b = field.inTesla(GlobalPoint(r*c,r*s,z));
+    return Vec4F{ c*b.x()+s*b.y(), -s*b.x()+c*b.y(), b.z(), 0.f};
+  }
+}
+
+
+TabulatedMagneticField::TabulatedMagneticField(std::unique_ptr<MagneticField> source, const Grid & grid) :
+  TabulatedMagneticField(*source, grid)
+{
+  theOwnedSource = std::move(source);
+}
+
+
+TabulatedMagneticField::TabulatedMagneticField(const MagneticField & source, const Grid & grid) :
+  theSource(&source),
+  theRMax(grid.rMax),
+  theZMax(grid.zMax),
+  theNR(std::ceil(grid.rMax/grid.dr)+1),
+  theNPhi(std::max(1U,grid.nPhi)),
+  theNZ(2*std::ceil(grid.zMax/grid.dz)+1),
+  theMaxDeviation(0)
+{
+  theZ0 = -0.5f*(theNZ-1)*grid.dz;
+  theInvDr = 1.f/grid.dr;
+  theInvDz = 1.f/grid.dz;
+  float dPhi = twoPi/theNPhi;
+  theInvDPhi = 1.f/dPhi;
+
+  theTable.resize(theNR*theNPhi*theNZ);
+  for (unsigned int iz=0; iz<theNZ; ++iz) {
+    float z = theZ0+iz*grid.dz;
+    for (unsigned int iphi=0; iphi<theNPhi; ++iphi) {
+      float phi = nodePhi(iphi,dPhi);
+      for (unsigned int ir=0; ir<theNR; ++ir)
+	theTable[index(ir,iphi,iz)] = cylindrical(*theSource,ir*grid.dr,phi,z);
+    }
+  }
+
+  // check at the center of each cell, where the interpolation is worst
+  for (unsigned int iz=0; iz+1<theNZ; ++iz) {
+    float z = theZ0+(iz+0.5f)*grid.dz;
+    if (!inTable(0,z)) continue;
+    for (unsigned int iphi=0; iphi<theNPhi; ++iphi) {
+      float phi = nodePhi(iphi,dPhi) + (theNPhi>1 ? 0.5f*dPhi : 0.f);
+      float c = std::cos(phi), s = std::sin(phi);
+      for (unsigned int ir=0; ir+1<theNR; ++ir) {
+	float r = (ir+0.5f)*grid.dr;
+	if (!inTable(r,z)) continue;
+	GlobalPoint gp(r*c,r*s,z);
+	theMaxDeviation = std::max(theMaxDeviation, (interpolate(gp.x(),gp.y(),z,r)-theSource->inTesla(gp)).mag());
+      }
+    }
+  }
+
+  edm::LogInfo("MagneticField|TabulatedMagneticField") << "Tabulated field with " << theNR << "x" << theNPhi << "x" << theNZ
+							<< " nodes (r,phi,z), max deviation from source " << theMaxDeviation << " T";
+
+  if (theMaxDeviation>grid.tolerance)
+    throw cms::Exception("TabulatedMagneticField") << "maximum deviation from the source field " << theMaxDeviation
+						   << " T exceeds the tolerance " << grid.tolerance << " T, use a finer grid";
+}
+
+
+TabulatedMagneticField::~TabulatedMagneticField() {}
+
+
+GlobalVector TabulatedMagneticField::inTesla (const GlobalPoint& gp) const {
+  float r = gp.perp();
+  if (!inTable(r,gp.z())) return theSource->inTesla(gp);
+  return interpolate(gp.x(),gp.y(),gp.z(),r);
+}
+
+
+GlobalVector TabulatedMagneticField::inTeslaUnchecked (const GlobalPoint& gp) const {
+  float r = gp.perp();
+  if (!inTable(r,gp.z())) return theSource->inTeslaUnchecked(gp);
+  return interpolate(gp.x(),gp.y(),gp.z(),r);
+}
+
+
+GlobalVector TabulatedMagneticField::interpolate(float x, float y, float z, float r) const {
+  // r and z cells (clamped against rounding at the border of the table)
+  float ur = r*theInvDr;
+  unsigned int ir = std::min((unsigned int)(ur), theNR-2);
+  float fr = ur-ir;
+  float uz = (z-theZ0)*theInvDz;
+  unsigned int iz = std::min((unsigned int)(std::max(uz,0.f)), theNZ-2);
+  float fz = uz-iz;
+
+  // direction (also at r=0 the nodes are consistent with phi=0)
+  float c=1.f, s=0.f;
+  if (r>1.e-6f) { float ir1 = 1.f/r; c = x*ir1; s = y*ir1;}
+
+  auto const * t = theTable.data();
+  Vec4F b;
+  if (theNPhi==1) {
+    auto v0 = t[index(ir,0,iz)]   + fr*(t[index(ir+1,0,iz)]  -t[index(ir,0,iz)]);
+    auto v1 = t[index(ir,0,iz+1)] + fr*(t[index(ir+1,0,iz+1)]-t[index(ir,0,iz+1)]);
+    b = v0 + fz*(v1-v0);
+  } else {
+    float uphi = (unsafe_atan2f<9>(s,c)+float(M_PI))*theInvDPhi;
+    unsigned int ip = std::min((unsigned int)(std::max(uphi,0.f)), theNPhi-1);
+    float fphi = uphi-ip;
+    unsigned int ip1 = ip+1==theNPhi ? 0 : ip+1;
+
+    auto v00 = t[index(ir,ip,iz)]    + fr*(t[index(ir+1,ip,iz)]   -t[index(ir,ip,iz)]);
+    auto v10 = t[index(ir,ip1,iz)]   + fr*(t[index(ir+1,ip1,iz)]  -t[index(ir,ip1,iz)]);
+    auto v01 = t[index(ir,ip,iz+1)]  + fr*(t[index(ir+1,ip,iz+1)] -t[index(ir,ip,iz+1)]);
+    auto v11 = t[index(ir,ip1,iz+1)] + fr*(t[index(ir+1,ip1,iz+1)]-t[index(ir,ip1,iz+1)]);
+    auto v0 = v00 + fphi*(v10-v00);
+    auto v1 = v01 + fphi*(v11-v01);
+    b = v0 + fz*(v1-v0);
+  }
+
+  // back to cartesian
+  return GlobalVector(c*b[0]-s*b[1], s*b[0]+c*b[1], b[2]);
+}
@@ -0,0 +1,80 @@
+#include "MagneticField/VolumeBasedEngine/interface/TabulatedMagneticField.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+  // smooth solenoid-like toy field with a small phi modulation
+  class ToyField final : public MagneticField {
+  public:
+    GlobalVector inTesla(const GlobalPoint& gp) const override {
+      float r = gp.perp(), z = gp.z();
+      float fall = 1.f/(1.f+std::pow(z/400.f,4.f));
+      float bz = 3.8f*fall*(1.f-0.02f*(r/100.f)*(r/100.f));
+      float br = 3.8f*1.e-5f*r*z/100.f*fall;
+      float phi = gp.barePhi();
+      br *= 1.f+0.05f*std::cos(2*phi);
+      float c = r>0 ? gp.x()/r : 1.f, s = r>0 ? gp.y()/r : 0.f;
+      return GlobalVector(br*c, br*s, bz);
+    }
+    bool isDefined(const GlobalPoint& gp) const override { return gp.perp()<900.f && std::abs(gp.z())<1600.f;}
+  };
+
+  template<typename F>
+  double queriesPerSecond(F const & field, std::vector<GlobalPoint> const & points, float & sum) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto const & p : points) sum += field.inTeslaUnchecked(p).z();
+    auto d = std::chrono::duration<double>(std::chrono::high_resolution_clock::now()-start).count();
+    return points.size()/d;
+  }
+}
+
+int main() {
+  TabulatedMagneticField::Grid grid;
+  TabulatedMagneticField field(std::make_unique<ToyField>(), grid);
+  std::cout << "max deviation at the cell centers " << field.maxDeviation() << " T" << std::endl;
+  assert(field.maxDeviation()<grid.tolerance);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> rnd(-1.f,1.f);
+  std::vector<GlobalPoint> points;
+  for (int i=0; i<1000000; ++i)
+    points.emplace_back(110.f*rnd(gen),110.f*rnd(gen),290.f*rnd(gen));
+
+  // random points, including r=0 and outside the table
+  points.emplace_back(0.f,0.f,10.f);
+  points.emplace_back(-0.f,0.f,-10.f);
+  points.emplace_back(500.f,0.f,10.f);
+  points.emplace_back(10.f,0.f,1000.f);
+  float maxd=0;
+  for (auto const & p : points)
+    maxd = std::max(maxd,(field.inTesla(p)-field.source().inTesla(p)).mag());
+  std::cout << "max deviation at random points " << maxd << " T" << std::endl;
+  assert(maxd<grid.tolerance);
+
+  float sum=0;
+  auto qs = queriesPerSecond(field.source(),points,sum);
+  auto qt = queriesPerSecond(field,points,sum);
+  std::cout << "queries/s: source " << qs << " tabulated " << qt << " (" << sum << ")" << std::endl;
+
+  // a table referring to a source it does not own (as published next to the VB map) is the same
+  ToyField toy;
+  TabulatedMagneticField view(toy, grid);
+  assert(&view.source()==&toy);
+  for (auto const & p : points) assert(view.inTesla(p)==field.inTesla(p));
+
+  // a too coarse grid must be refused
+  grid.dr = grid.dz = 50.f; grid.nPhi=2;
+  grid.tolerance = 1.e-5f;
+  bool thrown = false;
+  try {
+    TabulatedMagneticField coarse(std::make_unique<ToyField>(), grid);
+  } catch (cms::Exception const &) { thrown = true;}
+  assert(thrown);
+
+  return 0;
+}
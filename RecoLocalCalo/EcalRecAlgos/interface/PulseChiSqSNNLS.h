@@ -16,7 +16,9 @@ class PulseChiSqSNNLS {
     ~PulseChiSqSNNLS();
     
     
-    bool DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains = -1*SampleGainVector::Ones(), const SampleGainVector &badSamples = SampleGainVector::Zero());
+    // samplecovL: optional lower Cholesky factor of samplecov, used instead of decomposing
+    // the covariance as long as no pulse contributes to it
+    bool DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains = -1*SampleGainVector::Ones(), const SampleGainVector &badSamples = SampleGainVector::Zero(), const SampleMatrix *samplecovL = nullptr);
     
     const SamplePulseMatrix &pulsemat() const { return _pulsemat; }
     const SampleMatrix &invcov() const { return _invcov; }
@@ -40,6 +42,8 @@ class PulseChiSqSNNLS {
     bool updateCov(const SampleMatrix &samplecov, const FullSampleMatrix &fullpulsecov);
     double ComputeChiSq();
     double ComputeApproxUncertainty(unsigned int ipulse);
+    //lower Cholesky factor of the current covariance, given or decomposed in updateCov
+    SampleDecompLLT::Traits::MatrixL covdecompL() const { return _useSamplecovL ? _samplecovL.triangularView<Eigen::Lower>() : _covdecomp.matrixL(); }
     
     
     SampleVector _sampvec;
@@ -50,7 +54,9 @@ class PulseChiSqSNNLS {
     PulseVector _ampvecmin;
     
     SampleDecompLLT _covdecomp;
-    SampleMatrix _covdecompLinv;
+    SampleMatrix _samplecovL;
+    bool _hasSamplecovL;
+    bool _useSamplecovL;
     PulseMatrix _topleft_work;
     PulseDecompLDLT _pulsedecomp;
 
@@ -26,7 +26,7 @@ EcalUncalibRecHitMultiFitAlgo::EcalUncalibRecHitMultiFitAlgo() :
 }
 
 /// compute rechits
-EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX) {
+EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataFrame& dataFrame, const EcalPedestals::Item * aped, const EcalMGPAGainRatio * aGain, const SampleMatrixGainArray &noisecors, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const BXVector &activeBX, const SampleMatrixGainArray *noisecorsL) {
 
   uint32_t flags = 0;
   
@@ -132,7 +132,10 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   }
   
   //compute noise covariance matrix, which depends on the sample gains
+  //when it is a scaled correlation matrix, its decomposition is the scaled decomposition of the correlation matrix
   SampleMatrix noisecov;
+  SampleMatrix noisecovL;
+  bool hasNoisecovL = false;
   if (hasGainSwitch) {
     std::array<double,3> pedrmss = {{aped->rms_x12, aped->rms_x6, aped->rms_x1}};
     std::array<double,3> gainratios = {{ 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()}};
@@ -143,6 +146,10 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
         //add fully correlated component to noise covariance to inflate pedestal uncertainty
         noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
       }
+      else if (noisecorsL) {
+        noisecovL = gainratios[gainidxmax]*pedrmss[gainidxmax]*(*noisecorsL)[gainidxmax];
+        hasNoisecovL = true;
+      }
     }
     else {
       noisecov = SampleMatrix::Zero();
@@ -167,12 +174,16 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
       //add fully correlated component to noise covariance to inflate pedestal uncertainty
       noisecov += _addPedestalUncertainty*_addPedestalUncertainty*SampleMatrix::Ones();
     }
+    else if (noisecorsL) {
+      noisecovL = aped->rms_x12*(*noisecorsL)[0];
+      hasNoisecovL = true;
+    }
   }
   
   //optimized one-pulse fit for hlt
   bool usePrefit = false;
   if (_doPrefit) {
-    status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples);
+    status = _pulsefuncSingle.DoFit(amplitudes,noisecov,_singlebx,fullpulse,fullpulsecov,gainsPedestal,badSamples,hasNoisecovL ? &noisecovL : nullptr);
     amplitude = status ? _pulsefuncSingle.X()[0] : 0.;
     amperr = status ? _pulsefuncSingle.Errors()[0] : 0.;
     chisq = _pulsefuncSingle.ChiSq();
@@ -185,7 +196,7 @@ EcalUncalibratedRecHit EcalUncalibRecHitMultiFitAlgo::makeRecHit(const EcalDataF
   if (!usePrefit) {
   
     if(!_computeErrors) _pulsefunc.disableErrorCalculation();
-    status = _pulsefunc.DoFit(amplitudes,noisecov,activeBX,fullpulse,fullpulsecov,gainsPedestal,badSamples);
+    status = _pulsefunc.DoFit(amplitudes,noisecov,activeBX,fullpulse,fullpulsecov,gainsPedestal,badSamples,hasNoisecovL ? &noisecovL : nullptr);
     chisq = _pulsefunc.ChiSq();
     
     if (!status) {
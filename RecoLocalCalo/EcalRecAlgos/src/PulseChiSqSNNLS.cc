@@ -73,6 +73,8 @@ void eigen_solve_submatrix(PulseMatrix& mat, PulseVector& invec, PulseVector& ou
 }
 
 PulseChiSqSNNLS::PulseChiSqSNNLS() :
+  _hasSamplecovL(false),
+  _useSamplecovL(false),
   _chisq(0.),
   _computeErrors(true),
   _maxiters(50),
@@ -85,10 +87,13 @@ PulseChiSqSNNLS::~PulseChiSqSNNLS() {
   
 }
 
-bool PulseChiSqSNNLS::DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains, const SampleGainVector &badSamples) {
+bool PulseChiSqSNNLS::DoFit(const SampleVector &samples, const SampleMatrix &samplecov, const BXVector &bxs, const FullSampleVector &fullpulse, const FullSampleMatrix &fullpulsecov, const SampleGainVector &gains, const SampleGainVector &badSamples, const SampleMatrix *samplecovL) {
  
   int npulse = bxs.rows();
   
+  _hasSamplecovL = samplecovL!=nullptr;
+  if (_hasSamplecovL) _samplecovL = *samplecovL;
+  
   _sampvec = samples;
   _bxs = bxs;
   _pulsemat.resize(Eigen::NoChange,npulse);
@@ -279,10 +284,12 @@ bool PulseChiSqSNNLS::updateCov(const SampleMatrix &samplecov, const FullSampleM
 
   _invcov = samplecov; //
   
+  bool noisecovonly = true;
   for (unsigned int ipulse=0; ipulse<npulse; ++ipulse) {
     if (_ampvec.coeff(ipulse)==0.) continue;
     int bx = _bxs.coeff(ipulse);
     if (std::abs(bx)>=100) continue; //no contribution to covariance from pedestal or saturation/slew step correction
+    noisecovonly = false;
     
     int firstsamplet = std::max(0,bx + 3);
     int offset = 7-3-bx;
@@ -295,7 +302,9 @@ bool PulseChiSqSNNLS::updateCov(const SampleMatrix &samplecov, const FullSampleM
       ampsq*fullpulsecov.block(firstsamplet+offset,firstsamplet+offset,nsamplepulse,nsamplepulse);   
   }
   
-  _covdecomp.compute(_invcov);
+  //the decomposition of the noise covariance alone may be given by the caller
+  _useSamplecovL = noisecovonly && _hasSamplecovL;
+  if (!_useSamplecovL) _covdecomp.compute(_invcov);
   
   bool status = true;
   return status;
@@ -307,7 +316,7 @@ double PulseChiSqSNNLS::ComputeChiSq() {
 //   SampleVector resvec = _pulsemat*_ampvec - _sampvec;
 //   return resvec.transpose()*_covdecomp.solve(resvec);
   
-  return _covdecomp.matrixL().solve(_pulsemat*_ampvec - _sampvec).squaredNorm();
+  return covdecompL().solve(_pulsemat*_ampvec - _sampvec).squaredNorm();
   
 }
 
@@ -316,7 +325,7 @@ double PulseChiSqSNNLS::ComputeApproxUncertainty(unsigned int ipulse) {
   //(using 1/second derivative since full Hessian is not meaningful in
   //presence of positive amplitude boundaries.)
       
-  return 1./_covdecomp.matrixL().solve(_pulsemat.col(ipulse)).norm();
+  return 1./covdecompL().solve(_pulsemat.col(ipulse)).norm();
   
 }
 
@@ -327,9 +336,9 @@ bool PulseChiSqSNNLS::NNLS() {
   const unsigned int npulse = _bxs.rows();
   constexpr unsigned int nsamples = SampleVector::RowsAtCompileTime;
 
-  invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovp = covdecompL().solve(_pulsemat);
   aTamat.noalias() = invcovp.transpose().lazyProduct(invcovp);
-  aTbvec.noalias() = invcovp.transpose().lazyProduct(_covdecomp.matrixL().solve(_sampvec));
+  aTbvec.noalias() = invcovp.transpose().lazyProduct(covdecompL().solve(_sampvec));
   
   int iter = 0;
   Index idxwmax = 0;
@@ -449,12 +458,12 @@ bool PulseChiSqSNNLS::OnePulseMinimize() {
   
 //   const unsigned int npulse = 1;
 
-  invcovp = _covdecomp.matrixL().solve(_pulsemat);
+  invcovp = covdecompL().solve(_pulsemat);
 //   aTamat = invcovp.transpose()*invcovp;
 //   aTbvec = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
 
   SingleMatrix aTamatval = invcovp.transpose()*invcovp;
-  SingleVector aTbvecval = invcovp.transpose()*_covdecomp.matrixL().solve(_sampvec);
+  SingleVector aTbvecval = invcovp.transpose()*covdecompL().solve(_sampvec);
   _ampvec.coeffRef(0) = std::max(0.,aTbvecval.coeff(0)/aTamatval.coeff(0));
   
   return true;
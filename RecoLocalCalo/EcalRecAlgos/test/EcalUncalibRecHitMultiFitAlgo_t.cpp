@@ -0,0 +1,125 @@
+// Check that the multifit gives the same results when the crystals are fitted
+// in parallel, with one copy of the algorithm per thread, as when they are
+// fitted one after the other with the same algorithm object (as done by
+// EcalUncalibRecHitWorkerMultiFit with multiFitInParallel).  When the
+// decompositions of the noise correlation matrices are given (as done with
+// useNoiseCorrelationDecompositions) the results may only differ by rounding.
+
+#include "RecoLocalCalo/EcalRecAlgos/interface/EcalUncalibRecHitMultiFitAlgo.h"
+#include "DataFormats/EcalDigi/interface/EcalDigiCollections.h"
+#include "DataFormats/EcalDetId/interface/EBDetId.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/task_scheduler_init.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  bool same(const EcalUncalibratedRecHit & a, const EcalUncalibratedRecHit & b, unsigned int nBX) {
+    bool ok = a.id()==b.id() && a.amplitude()==b.amplitude() && a.amplitudeError()==b.amplitudeError()
+      && a.pedestal()==b.pedestal() && a.chi2()==b.chi2();
+    for (unsigned int ibx=0; ibx<nBX; ++ibx) ok &= a.outOfTimeAmplitude(ibx)==b.outOfTimeAmplitude(ibx);
+    return ok;
+  }
+
+}
+
+int main() {
+  tbb::task_scheduler_init init(4);
+
+  // a simple pulse shape, peaking at the sixth sample for the in-time bunch crossing
+  const double shape[12] = {1.13979e-02, 7.58151e-01, 1.00000e+00, 8.87744e-01, 6.73548e-01, 4.74332e-01,
+                            3.19561e-01, 2.15144e-01, 1.47464e-01, 1.01087e-01, 6.93181e-02, 4.75044e-02};
+  FullSampleVector fullpulse(FullSampleVector::Zero());
+  FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+  for (int i=0; i<12; ++i) {
+    fullpulse(i+7) = shape[i];
+    fullpulsecov(i+7,i+7) = 1.e-5;
+  }
+
+  const double corr[10] = {1.00000, 0.71073, 0.55721, 0.46089, 0.40449, 0.35931, 0.33924, 0.32439, 0.31581, 0.30481};
+  SampleMatrixGainArray noisecors;
+  for (auto & m : noisecors)
+    for (int i=0; i<10; ++i)
+      for (int j=0; j<10; ++j)
+        m(i,j) = corr[std::abs(i-j)];
+
+  BXVector activeBX(10);
+  activeBX << -5,-4,-3,-2,-1,0,1,2,3,4;
+
+  EcalPedestals::Item ped;
+  ped.mean_x12 = 200.; ped.rms_x12 = 1.1;
+  ped.mean_x6 = 200.; ped.rms_x6 = 0.9;
+  ped.mean_x1 = 200.; ped.rms_x1 = 0.7;
+  EcalMGPAGainRatio gain;
+  gain.setGain12Over6(2.);
+  gain.setGain6Over1(6.);
+
+  // in-time pulses with random amplitude, some out-of-time pileup and noise
+  std::mt19937 rng(42);
+  std::exponential_distribution<double> amp(1./50.);
+  std::uniform_int_distribution<int> pu(-5, 4);
+  std::normal_distribution<double> noise(0., 1.1);
+  const unsigned int nDigis = 2000;
+  EBDigiCollection digis;
+  for (unsigned int i=0; i<nDigis; ++i) {
+    double samples[10];
+    double a0 = amp(rng), a1 = 0.3*amp(rng);
+    int bx = pu(rng);
+    for (int is=0; is<10; ++is) {
+      samples[is] = ped.mean_x12 + noise(rng);
+      if (is-3 >= 0) samples[is] += a0*shape[is-3];
+      if (is-3-bx >= 0 && is-3-bx < 12) samples[is] += a1*shape[is-3-bx];
+    }
+    digis.push_back(EBDetId::unhashIndex(i).rawId());
+    EBDataFrame frame(digis.back());
+    for (int is=0; is<10; ++is)
+      frame.setSample(is, EcalMGPASample(std::min(4095, int(samples[is]+0.5)), 1));
+  }
+
+  EcalUncalibRecHitMultiFitAlgo algo;
+
+  std::vector<EcalUncalibratedRecHit> serial;
+  for (unsigned int i=0; i<nDigis; ++i)
+    serial.push_back(algo.makeRecHit(EcalDataFrame(digis[i]), &ped, &gain, noisecors, fullpulse, fullpulsecov, activeBX));
+
+  std::vector<EcalUncalibratedRecHit> parallel(nDigis);
+  tbb::enumerable_thread_specific<EcalUncalibRecHitMultiFitAlgo> algos(algo);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, nDigis, 64),
+                    [&](const tbb::blocked_range<size_t>& range) {
+    auto & local = algos.local();
+    for (size_t i=range.begin(); i!=range.end(); ++i)
+      parallel[i] = local.makeRecHit(EcalDataFrame(digis[i]), &ped, &gain, noisecors, fullpulse, fullpulsecov, activeBX);
+  });
+
+  unsigned int nDiff = 0;
+  for (unsigned int i=0; i<nDigis; ++i)
+    if (!same(serial[i], parallel[i], activeBX.size())) ++nDiff;
+
+  std::cout << nDigis << " crystals fitted, " << nDiff << " differences between the serial and the parallel fit" << std::endl;
+  assert(nDiff==0);
+
+  // same fit, with the noise covariance decomposed from the correlation matrix
+  SampleMatrixGainArray noisecorsL;
+  for (unsigned int i=0; i<noisecors.size(); ++i) noisecorsL[i] = SampleDecompLLT(noisecors[i]).matrixL();
+  unsigned int nDiffL = 0;
+  for (unsigned int i=0; i<nDigis; ++i) {
+    auto rh = algo.makeRecHit(EcalDataFrame(digis[i]), &ped, &gain, noisecors, fullpulse, fullpulsecov, activeBX, &noisecorsL);
+    const auto & ref = serial[i];
+    if (std::abs(rh.amplitude()-ref.amplitude()) > 1.e-10*(1.+std::abs(ref.amplitude()))
+        || std::abs(rh.amplitudeError()-ref.amplitudeError()) > 1.e-10*(1.+ref.amplitudeError())
+        || std::abs(rh.chi2()-ref.chi2()) > 1.e-10*(1.+ref.chi2()))
+      ++nDiffL;
+  }
+  std::cout << nDiffL << " differences beyond rounding with the decomposed noise correlation matrices" << std::endl;
+  assert(nDiffL==0);
+
+  return nDiff==0 && nDiffL==0 ? 0 : 1;
+}
@@ -22,6 +22,32 @@
 #include <FWCore/ParameterSet/interface/ParameterSetDescription.h>
 #include <FWCore/ParameterSet/interface/EmptyGroupDescription.h>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
+namespace {
+
+  // sample preceding the first saturated one, -2 if none
+  int lastSampleBeforeSaturation(const EcalDataFrame & frame) {
+    for(unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
+      if ( frame.sample(iSample).gainId() == 0 ) return iSample-1;
+    }
+    return -2;
+  }
+
+  void fillPulse(const EcalPulseShapes::Item * aPulse, const EcalPulseCovariances::Item * aPulseCov,
+                 FullSampleVector & fullpulse, FullSampleMatrix & fullpulsecov) {
+    for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
+      fullpulse(i+7) = aPulse->pdfval[i];
+
+    for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
+      for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
+        fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+  }
+
+}
+
 EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::ParameterSet&ps,edm::ConsumesCollector& c) :
   EcalUncalibRecHitWorkerBaseClass(ps,c)
 {
@@ -35,6 +61,11 @@ EcalUncalibRecHitWorkerMultiFit::EcalUncalibRecHitWorkerMultiFit(const edm::Para
 
   // uncertainty calculation (CPU intensive)
   ampErrorCalculation_ = ps.getParameter<bool>("ampErrorCalculation");
+  // fit the crystals of an event in parallel (same results as the serial fit)
+  multiFitInParallel_ = ps.getParameter<bool>("multiFitInParallel");
+  // use the decompositions of the noise correlation matrices instead of decomposing
+  // the noise covariance of each crystal (same results up to rounding)
+  useNoiseCorrelationDecompositions_ = ps.getParameter<bool>("useNoiseCorrelationDecompositions");
   useLumiInfoRunHeader_ = ps.getParameter<bool>("useLumiInfoRunHeader");
   
   if (useLumiInfoRunHeader_) {
@@ -137,6 +168,11 @@ EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es)
         // for the time correction methods
         es.get<EcalTimeBiasCorrectionsRcd>().get(timeCorrBias_);
 
+        // the noise correlation matrices and their decompositions change with the IOV only
+        unsigned long long cacheId = es.get<EcalSamplesCorrelationRcd>().cacheIdentifier();
+        if (cacheId == noisecovariancesCacheId_) return;
+        noisecovariancesCacheId_ = cacheId;
+
         int nnoise = SampleVector::RowsAtCompileTime;
         SampleMatrix &noisecorEBg12 = noisecors_[1][0];
         SampleMatrix &noisecorEBg6 = noisecors_[1][1];
@@ -156,6 +192,13 @@ EcalUncalibRecHitWorkerMultiFit::set(const edm::EventSetup& es)
             noisecorEEg1(i,j)  = noisecovariances->EEG1SamplesCorrelation[vidx];
           }
 	}
+
+        if (!useNoiseCorrelationDecompositions_) return;
+        for (unsigned int idet=0; idet<noisecors_.size(); ++idet) {
+          for (unsigned int igain=0; igain<noisecors_[idet].size(); ++igain) {
+            noisecorsL_[idet][igain] = SampleDecompLLT(noisecors_[idet][igain]).matrixL();
+          }
+        }
 }
 
 void
@@ -284,6 +327,9 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     FullSampleVector fullpulse(FullSampleVector::Zero());
     FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
 
+    std::vector<EcalUncalibratedRecHit> fitted;
+    if (multiFitInParallel_) fitInParallel(digis, barrel, fitted);
+
     result.reserve(result.size() + digis.size());
     for (auto itdg = digis.begin(); itdg != digis.end(); ++itdg)
     {
@@ -322,12 +368,7 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
         double pedRMSVec[3]  = { aped->rms_x12,  aped->rms_x6,  aped->rms_x1 };
         double gainRatios[3] = { 1., aGain->gain12Over6(), aGain->gain6Over1()*aGain->gain12Over6()};
 
-        for (int i=0; i<EcalPulseShape::TEMPLATESAMPLES; ++i)
-            fullpulse(i+7) = aPulse->pdfval[i];
-    
-        for(int i=0; i<EcalPulseShape::TEMPLATESAMPLES;i++)
-        for(int j=0; j<EcalPulseShape::TEMPLATESAMPLES;j++)
-            fullpulsecov(i+7,j+7) = aPulseCov->covval[i][j];
+        fillPulse(aPulse, aPulseCov, fullpulse, fullpulsecov);
         
 	// compute the right bin of the pulse shape using time calibration constants
 	EcalTimeCalibConstantMap::const_iterator it = itime->find( detid );
@@ -340,13 +381,7 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
             << "! something wrong with EcalTimeCalibConstants in your DB? ";
 	}
 
-        int lastSampleBeforeSaturation = -2;
-        for(unsigned int iSample = 0; iSample < EcalDataFrame::MAXSAMPLES; iSample++) {
-          if ( ((EcalDataFrame)(*itdg)).sample(iSample).gainId() == 0 ) {
-            lastSampleBeforeSaturation=iSample-1;
-            break;
-          }
-        }
+        int lastSampleBeforeSaturation = ::lastSampleBeforeSaturation(*itdg);
 
         // === amplitude computation ===
 
@@ -370,8 +405,12 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
         } else {
             // multifit
             const SampleMatrixGainArray &noisecors = noisecor(barrel);
+            const SampleMatrixGainArray *noisecorsL = useNoiseCorrelationDecompositions_ ? &noisecorsL_[barrel?1:0] : nullptr;
             
-            result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX));
+            if (multiFitInParallel_)
+              result.push_back(fitted[itdg-digis.begin()]);
+            else
+              result.push_back(multiFitMethod_.makeRecHit(*itdg, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX, noisecorsL));
             auto & uncalibRecHit = result.back();
             
             // === time computation ===
@@ -503,6 +542,52 @@ EcalUncalibRecHitWorkerMultiFit::run( const edm::Event & evt,
     }
 }
 
+void
+EcalUncalibRecHitWorkerMultiFit::fitInParallel(const EcalDigiCollection & digis, bool barrel,
+                                               std::vector<EcalUncalibratedRecHit> & fitted) const
+{
+    fitted.resize(digis.size());
+    const SampleMatrixGainArray &noisecors = noisecor(barrel);
+    const SampleMatrixGainArray *noisecorsL = useNoiseCorrelationDecompositions_ ? &noisecorsL_[barrel?1:0] : nullptr;
+
+    // the fit keeps its work matrices in the algorithm: one configured copy per thread
+    tbb::enumerable_thread_specific<EcalUncalibRecHitMultiFitAlgo> algos(multiFitMethod_);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, digis.size(), 64),
+                      [&](const tbb::blocked_range<size_t>& range) {
+      auto & algo = algos.local();
+      FullSampleVector fullpulse(FullSampleVector::Zero());
+      FullSampleMatrix fullpulsecov(FullSampleMatrix::Zero());
+      for (size_t idigi = range.begin(); idigi != range.end(); ++idigi) {
+        EcalDataFrame frame(digis[idigi]);
+        // saturated crystals are not fitted
+        if (lastSampleBeforeSaturation(frame) >= -1) continue;
+
+        DetId detid(frame.id());
+        const EcalPedestals::Item * aped = nullptr;
+        const EcalMGPAGainRatio * aGain = nullptr;
+        const EcalPulseShapes::Item * aPulse = nullptr;
+        const EcalPulseCovariances::Item * aPulseCov = nullptr;
+        if (barrel) {
+            unsigned int hashedIndex = EBDetId(detid).hashedIndex();
+            aped       = &peds->barrel(hashedIndex);
+            aGain      = &gains->barrel(hashedIndex);
+            aPulse     = &pulseshapes->barrel(hashedIndex);
+            aPulseCov  = &pulsecovariances->barrel(hashedIndex);
+        } else {
+            unsigned int hashedIndex = EEDetId(detid).hashedIndex();
+            aped       = &peds->endcap(hashedIndex);
+            aGain      = &gains->endcap(hashedIndex);
+            aPulse     = &pulseshapes->endcap(hashedIndex);
+            aPulseCov  = &pulsecovariances->endcap(hashedIndex);
+        }
+        fillPulse(aPulse, aPulseCov, fullpulse, fullpulsecov);
+        fitted[idigi] = algo.makeRecHit(frame, aped, aGain, noisecors, fullpulse, fullpulsecov, activeBX, noisecorsL);
+      }
+    });
+}
+
+
 edm::ParameterSetDescription 
 EcalUncalibRecHitWorkerMultiFit::getAlgoDescription() {
   
@@ -551,6 +636,8 @@ EcalUncalibRecHitWorkerMultiFit::getAlgoDescription() {
  edm::ParameterSetDescription psd;
  psd.addNode(edm::ParameterDescription<std::vector<int>>("activeBXs", {-5,-4,-3,-2,-1,0,1,2,3,4}, true) and
 	      edm::ParameterDescription<bool>("ampErrorCalculation", true, true) and
+	      edm::ParameterDescription<bool>("multiFitInParallel", false, true) and
+	      edm::ParameterDescription<bool>("useNoiseCorrelationDecompositions", false, true) and
 	      edm::ParameterDescription<bool>("useLumiInfoRunHeader", true, true) and
 	      edm::ParameterDescription<int>("bunchSpacing", 0, true) and
 	      edm::ParameterDescription<bool>("doPrefitEB", false, true) and
@@ -29,6 +29,8 @@
 #include "CondFormats/EcalObjects/interface/EcalPulseCovariances.h"
 #include "RecoLocalCalo/EcalRecAlgos/interface/EigenMatrixTypes.h"
 
+#include <vector>
+
 
 namespace edm {
         class Event;
@@ -62,13 +64,23 @@ class EcalUncalibRecHitWorkerMultiFit final : public EcalUncalibRecHitWorkerBase
 
                 const SampleMatrix & noisecor(bool barrel, int gain) const { return noisecors_[barrel?1:0][gain];}
                 const SampleMatrixGainArray &noisecor(bool barrel) const { return noisecors_[barrel?1:0]; }
+
+                // run the multifit of all the unsaturated crystals of the collection in parallel,
+                // fitted[i] being the result for the i-th digi
+                void fitInParallel(const EcalDigiCollection & digis, bool barrel,
+                                   std::vector<EcalUncalibratedRecHit> & fitted) const;
                 
                 // multifit method
                 std::array<SampleMatrixGainArray, 2> noisecors_;
+                // lower Cholesky factors of the noise correlation matrices, updated with them if useNoiseCorrelationDecompositions
+                std::array<SampleMatrixGainArray, 2> noisecorsL_;
+                unsigned long long noisecovariancesCacheId_ = 0;
                 BXVector activeBX;
                 bool ampErrorCalculation_;
                 bool useLumiInfoRunHeader_;
                 EcalUncalibRecHitMultiFitAlgo multiFitMethod_;
+                bool multiFitInParallel_ = false;
+                bool useNoiseCorrelationDecompositions_ = false;
                 
 		int bunchSpacingManual_;
                 edm::EDGetTokenT<unsigned int> bunchSpacing_; 
@@ -23,6 +23,7 @@
 #include <numeric>
 
 #include "KDTreeLinkerAlgoT.h"
+#include "HGCalLayerTiles.h"
 
 
 template <typename T>
@@ -221,14 +222,13 @@ struct Hexel {
         float thickness;
         const hgcal::RecHitTools *tools;
 
-        Hexel(const HGCRecHit &hit, DetId id_in, bool isHalf, float sigmaNoise_in, float thickness_in, const hgcal::RecHitTools *tools_in) :
+        Hexel(const HGCRecHit &hit, DetId id_in, bool isHalf, float sigmaNoise_in, float thickness_in, const GlobalPoint &position, const hgcal::RecHitTools *tools_in) :
                 isHalfCell(isHalf),
                 weight(0.), fraction(1.0), detid(id_in), rho(0.), delta(0.),
                 nearestHigher(-1), isBorder(false), isHalo(false),
                 clusterIndex(-1), sigmaNoise(sigmaNoise_in), thickness(thickness_in),
                 tools(tools_in)
         {
-                const GlobalPoint position( tools->getPosition( detid ) );
                 weight = hit.energy();
                 x = position.x();
                 y = position.y();
@@ -250,7 +250,6 @@ struct Hexel {
 
 };
 
-typedef KDTreeLinkerAlgo<Hexel,2> KDTree;
 typedef KDTreeNodeInfoT<Hexel,2> KDNode;
 
 
@@ -282,9 +281,11 @@ inline double distance2(const Hexel &pt1, const Hexel &pt2) const{   //distance
 inline double distance(const Hexel &pt1, const Hexel &pt2) const{   //2-d distance on the layer (x-y)
         return std::sqrt(distance2(pt1,pt2));
 }
-double calculateLocalDensity(std::vector<KDNode> &, KDTree &, const unsigned int) const;   //return max density
+// critical distance used for the local density and the cluster borders on a layer
+float criticalDistance(const unsigned int) const;
+double calculateLocalDensity(std::vector<KDNode> &, const HGCalLayerTiles &, const unsigned int) const;   //return max density
 double calculateDistanceToHigher(std::vector<KDNode> &) const;
-int findAndAssignClusters(std::vector<KDNode> &, KDTree &, double, KDTreeBox &, const unsigned int, std::vector<std::vector<KDNode> >&) const;
+int findAndAssignClusters(std::vector<KDNode> &, const HGCalLayerTiles &, double, const unsigned int, std::vector<std::vector<KDNode> >&) const;
 math::XYZPoint calculatePosition(std::vector<KDNode> &) const;
 
 // attempt to find subclusters within a given set of hexels
@@ -0,0 +1,95 @@
+#ifndef RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+#define RecoLocalCalo_HGCalRecAlgos_HGCalLayerTiles_h
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+// Fixed grid of tiles covering the (x,y) extent of the hits of one layer,
+// used instead of a KDTree for the fixed size box searches of the imaging
+// algorithm. The hit coordinates are copied in tile order (structure of
+// arrays) with a counting sort, so the hits of a tile are contiguous and keep
+// their original relative order; a search only visits the tiles overlapping
+// the box and returns the index of each hit inside it (boundaries included).
+class HGCalLayerTiles {
+public:
+  // upper bound on the number of tiles along x and y
+  static const int maxTilesPerDim = 256;
+
+  // fill from nodes holding their coordinates in dims[0] and dims[1]; the
+  // tiles have a side of about tileSize (typically the search half width)
+  template <typename NODE>
+  void fill(const std::vector<NODE> &nodes, const std::array<float, 2> &minpos,
+            const std::array<float, 2> &maxpos, float tileSize) {
+    minX_ = minpos[0];
+    minY_ = minpos[1];
+    nX_ = nTiles(maxpos[0] - minpos[0], tileSize);
+    nY_ = nTiles(maxpos[1] - minpos[1], tileSize);
+    invSizeX_ = maxpos[0] > minpos[0] ? nX_ / (maxpos[0] - minpos[0]) : 0.f;
+    invSizeY_ = maxpos[1] > minpos[1] ? nY_ / (maxpos[1] - minpos[1]) : 0.f;
+
+    const unsigned int n = nodes.size();
+    std::vector<unsigned int> tile(n);
+    offsets_.assign(nX_ * nY_ + 1, 0);
+    for (unsigned int i = 0; i < n; ++i) {
+      tile[i] = binX(nodes[i].dims[0]) + nX_ * binY(nodes[i].dims[1]);
+      ++offsets_[tile[i] + 1];
+    }
+    for (unsigned int t = 1; t < offsets_.size(); ++t)
+      offsets_[t] += offsets_[t - 1];
+
+    std::vector<unsigned int> next(offsets_.begin(), offsets_.end() - 1);
+    indices_.resize(n);
+    x_.resize(n);
+    y_.resize(n);
+    for (unsigned int i = 0; i < n; ++i) {
+      const unsigned int k = next[tile[i]]++;
+      indices_[k] = i;
+      x_[k] = nodes[i].dims[0];
+      y_[k] = nodes[i].dims[1];
+    }
+  }
+
+  // call f(index) for every hit with xmin <= x <= xmax and ymin <= y <= ymax
+  template <typename F>
+  void forEachInBox(float xmin, float xmax, float ymin, float ymax,
+                    F &&f) const {
+    if (indices_.empty())
+      return;
+    const int ixmax = binX(xmax), iymax = binY(ymax);
+    for (int iy = binY(ymin); iy <= iymax; ++iy) {
+      for (int ix = binX(xmin); ix <= ixmax; ++ix) {
+        const unsigned int t = ix + nX_ * iy;
+        for (unsigned int k = offsets_[t]; k < offsets_[t + 1]; ++k) {
+          if (x_[k] >= xmin && x_[k] <= xmax && y_[k] >= ymin && y_[k] <= ymax)
+            f(indices_[k]);
+        }
+      }
+    }
+  }
+
+private:
+  static int nTiles(float range, float tileSize) {
+    if (!(range > 0.f) || !(tileSize > 0.f))
+      return 1;
+    return std::max(1, std::min(maxTilesPerDim,
+                                int(std::ceil(range / tileSize))));
+  }
+  // positions outside the filled extent are clamped to the border tiles
+  int binX(float x) const {
+    return std::min(nX_ - 1, std::max(0, int((x - minX_) * invSizeX_)));
+  }
+  int binY(float y) const {
+    return std::min(nY_ - 1, std::max(0, int((y - minY_) * invSizeY_)));
+  }
+
+  float minX_ = 0.f, minY_ = 0.f;
+  float invSizeX_ = 0.f, invSizeY_ = 0.f;
+  int nX_ = 1, nY_ = 1;
+  std::vector<unsigned int> offsets_; // first hit of each tile, nX_*nY_+1
+  std::vector<unsigned int> indices_; // hit indices in tile order
+  std::vector<float> x_, y_;          // hit coordinates in tile order
+};
+
+#endif
@@ -57,9 +57,9 @@ void HGCalImagingAlgo::populate(const HGCRecHitCollection &hits) {
     const GlobalPoint position(rhtools_.getPosition(detid));
 
     // here's were the KDNode is passed its dims arguments - note that these are
-    // *copied* from the Hexel
+    // *copied* from the Hexel, which takes the position looked up once above
     points[layer].emplace_back(
-        Hexel(hgrh, detid, isHalf, sigmaNoise, thickness, &rhtools_),
+        Hexel(hgrh, detid, isHalf, sigmaNoise, thickness, position, &rhtools_),
         position.x(), position.y());
 
     // for each layer, store the minimum and maximum x and y coordinates for the
@@ -88,23 +88,25 @@ void HGCalImagingAlgo::makeClusters() {
   // assign all hits in each layer to a cluster core or halo
   tbb::this_task_arena::isolate([&] {
     tbb::parallel_for(size_t(0), size_t(2 * maxlayer + 2), [&](size_t i) {
-      KDTreeBox bounds(minpos[i][0], maxpos[i][0], minpos[i][1], maxpos[i][1]);
-      KDTree hit_kdtree;
-      hit_kdtree.build(points[i], bounds);
-
       unsigned int actualLayer =
           i > maxlayer
               ? (i - (maxlayer + 1))
-              : i; // maps back from index used for KD trees to actual layer
+              : i; // maps back from index used for the tiles to actual layer
+
+      // the searches are done within +/- delta_c, so tiles of that size
+      // cover any search box with at most 3x3 of them
+      HGCalLayerTiles tiles;
+      tiles.fill(points[i], minpos[i], maxpos[i],
+                 criticalDistance(actualLayer));
 
       double maxdensity = calculateLocalDensity(
-          points[i], hit_kdtree, actualLayer); // also stores rho (energy
-                                               // density) for each point (node)
+          points[i], tiles, actualLayer); // also stores rho (energy
+                                          // density) for each point (node)
       // calculate distance to nearest point with higher density storing
       // distance (delta) and point's index
       calculateDistanceToHigher(points[i]);
-      findAndAssignClusters(points[i], hit_kdtree, maxdensity, bounds,
-                            actualLayer, layerClustersPerLayer[i]);
+      findAndAssignClusters(points[i], tiles, maxdensity, actualLayer,
+                            layerClustersPerLayer[i]);
     });
   });
 }
@@ -230,35 +232,35 @@ HGCalImagingAlgo::calculatePosition(std::vector<KDNode> &v) const {
   return math::XYZPoint(0, 0, 0);
 }
 
+float HGCalImagingAlgo::criticalDistance(const unsigned int layer) const {
+  if (layer <= lastLayerEE)
+    return vecDeltas[0];
+  else if (layer <= lastLayerFH)
+    return vecDeltas[1];
+  else
+    return vecDeltas[2];
+}
+
 double HGCalImagingAlgo::calculateLocalDensity(std::vector<KDNode> &nd,
-                                               KDTree &lp,
+                                               const HGCalLayerTiles &lp,
                                                const unsigned int layer) const {
 
   double maxdensity = 0.;
-  float delta_c; // maximum search distance (critical distance) for local
-                 // density calculation
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
+  // maximum search distance (critical distance) for local density calculation
+  const float delta_c = criticalDistance(layer);
 
   // for each node calculate local density rho and store it
   for (unsigned int i = 0; i < nd.size(); ++i) {
-    // speec up search by looking within +/- delta_c window only
-    KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                         nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-    std::vector<KDNode> found;
-    lp.search(search_box, found);
-    const unsigned int found_size = found.size();
-    for (unsigned int j = 0; j < found_size; j++) {
-      if (distance(nd[i].data, found[j].data) < delta_c) {
-        nd[i].data.rho += found[j].data.weight;
-        maxdensity = std::max(maxdensity, nd[i].data.rho);
-      }
-    } // end loop found
-  }   // end loop nodes
+    // speed up search by looking within +/- delta_c window only
+    lp.forEachInBox(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
+                    nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c,
+                    [&](unsigned int j) {
+                      if (distance(nd[i].data, nd[j].data) < delta_c) {
+                        nd[i].data.rho += nd[j].data.weight;
+                        maxdensity = std::max(maxdensity, nd[i].data.rho);
+                      }
+                    });
+  } // end loop nodes
   return maxdensity;
 }
 
@@ -315,7 +317,7 @@ HGCalImagingAlgo::calculateDistanceToHigher(std::vector<KDNode> &nd) const {
   return maxdensity;
 }
 int HGCalImagingAlgo::findAndAssignClusters(
-    std::vector<KDNode> &nd, KDTree &lp, double maxdensity, KDTreeBox &bounds,
+    std::vector<KDNode> &nd, const HGCalLayerTiles &lp, double maxdensity,
     const unsigned int layer,
     std::vector<std::vector<KDNode>> &clustersOnLayer) const {
 
@@ -325,13 +327,7 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // cluster centers...
 
   unsigned int nClustersOnLayer = 0;
-  float delta_c; // critical distance
-  if (layer <= lastLayerEE)
-    delta_c = vecDeltas[0];
-  else if (layer <= lastLayerFH)
-    delta_c = vecDeltas[1];
-  else
-    delta_c = vecDeltas[2];
+  const float delta_c = criticalDistance(layer); // critical distance
 
   std::vector<size_t> rs =
       sorted_indices(nd); // indices sorted by decreasing rho
@@ -389,42 +385,40 @@ int HGCalImagingAlgo::findAndAssignClusters(
   // assign points closer than dc to other clusters to border region
   // and find critical border density
   std::vector<double> rho_b(nClustersOnLayer, 0.);
-  lp.clear();
-  lp.build(nd, bounds);
+  // the tiles hold indices, so the cluster indices assigned above are seen
+  // without rebuilding them
   // now loop on all hits again :( and check: if there are hits from another
   // cluster within d_c -> flag as border hit
   for (unsigned int i = 0; i < nd_size; ++i) {
     int ci = nd[i].data.clusterIndex;
     bool flag_isolated = true;
     if (ci != -1) {
-      KDTreeBox search_box(nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
-                           nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c);
-      std::vector<KDNode> found;
-      lp.search(search_box, found);
-
-      const unsigned int found_size = found.size();
-      for (unsigned int j = 0; j < found_size;
-           j++) { // start from 0 here instead of 1
-        // check if the hit is not within d_c of another cluster
-        if (found[j].data.clusterIndex != -1) {
-          float dist = distance(found[j].data, nd[i].data);
-          if (dist < delta_c && found[j].data.clusterIndex != ci) {
-            // in which case we assign it to the border
-            nd[i].data.isBorder = true;
-            break;
-          }
-          // because we are using two different containers, we have to make sure
-          // that we don't unflag the
-          // hit when it finds *itself* closer than delta_c
-          if (dist < delta_c && dist != 0. &&
-              found[j].data.clusterIndex == ci) {
-            // in this case it is not an isolated hit
-            // the dist!=0 is because the hit being looked at is also inside the
-            // search box and at dist==0
-            flag_isolated = false;
-          }
-        }
-      }
+      lp.forEachInBox(
+          nd[i].dims[0] - delta_c, nd[i].dims[0] + delta_c,
+          nd[i].dims[1] - delta_c, nd[i].dims[1] + delta_c,
+          [&](unsigned int j) {
+            // once a border hit, nothing else can change the flags
+            if (nd[i].data.isBorder)
+              return;
+            // check if the hit is not within d_c of another cluster
+            if (nd[j].data.clusterIndex != -1) {
+              float dist = distance(nd[j].data, nd[i].data);
+              if (dist < delta_c && nd[j].data.clusterIndex != ci) {
+                // in which case we assign it to the border
+                nd[i].data.isBorder = true;
+                return;
+              }
+              // we have to make sure that we don't unflag the
+              // hit when it finds *itself* closer than delta_c
+              if (dist < delta_c && dist != 0. &&
+                  nd[j].data.clusterIndex == ci) {
+                // in this case it is not an isolated hit
+                // the dist!=0 is because the hit being looked at is also
+                // inside the search box and at dist==0
+                flag_isolated = false;
+              }
+            }
+          });
       if (flag_isolated)
         nd[i].data.isBorder =
             true; // the hit is more than delta_c from any of its brethren
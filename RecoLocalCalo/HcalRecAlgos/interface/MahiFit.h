@@ -14,6 +14,9 @@
 
 #include <Math/Functor.h>
 
+#include <utility>
+#include <vector>
+
 struct MahiNnlsWorkspace {
 
   unsigned int nPulseTot;
@@ -155,6 +158,7 @@ class MahiFit
   void updatePulseShape(double itQ, FullSampleVector &pulseShape, 
 			FullSampleVector &pulseDeriv,
 			FullSampleMatrix &pulseCov) const;
+  void evalPulseShape(double t0, std::array<double, MaxSVSize> &pulse) const;
 
   double calculateArrivalTime() const;
   double calculateChiSq() const;
@@ -207,5 +211,11 @@ class MahiFit
   std::unique_ptr<FitterFuncs::PulseShapeFunctor> psfPtr_;
   std::unique_ptr<ROOT::Math::Functor> pfunctor_;
 
+  // pulse shapes returned by the functor for a given arrival time; the same
+  // times come back for all the channels without time slew correction, for
+  // those below 1 GeV and between the successive fits of a channel
+  static constexpr unsigned int maxCachedPulseShapes_ = 64;
+  mutable std::vector<std::pair<double, std::array<double, MaxSVSize> > > pulseShapeCache_;
+
 }; 
 #endif
@@ -265,18 +265,9 @@ void MahiFit::updatePulseShape(double itQ, FullSampleVector &pulseShape, FullSam
   nnlsWork_.pulseM.fill(0);
   nnlsWork_.pulseP.fill(0);
 
-  const double xx[4]={t0, 1.0, 0.0, 3};
-  const double xxm[4]={-nnlsWork_.dt+t0, 1.0, 0.0, 3};
-  const double xxp[4]={ nnlsWork_.dt+t0, 1.0, 0.0, 3};
-
-  (*pfunctor_)(&xx[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseN);
-
-  (*pfunctor_)(&xxm[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseM);
-  
-  (*pfunctor_)(&xxp[0]);
-  psfPtr_->getPulseShape(nnlsWork_.pulseP);
+  evalPulseShape(t0, nnlsWork_.pulseN);
+  evalPulseShape(-nnlsWork_.dt+t0, nnlsWork_.pulseM);
+  evalPulseShape( nnlsWork_.dt+t0, nnlsWork_.pulseP);
 
   //in the 2018+ case where the sample of interest (SOI) is in TS3, add an extra offset to align 
   //with previous SOI=TS4 case assumed by psfPtr_->getPulseShape()
@@ -472,6 +463,23 @@ double MahiFit::calculateChiSq() const {
   return (nnlsWork_.covDecomp.matrixL().solve(nnlsWork_.pulseMat*nnlsWork_.ampVec - nnlsWork_.amplitudes)).squaredNorm();
 }
 
+void MahiFit::evalPulseShape(double t0, std::array<double, MaxSVSize> &pulse) const {
+
+  for (auto const& cached : pulseShapeCache_) {
+    if (cached.first == t0) {
+      pulse = cached.second;
+      return;
+    }
+  }
+
+  const double xx[4]={t0, 1.0, 0.0, 3};
+  (*pfunctor_)(&xx[0]);
+  psfPtr_->getPulseShape(pulse);
+
+  if (pulseShapeCache_.size() == maxCachedPulseShapes_) pulseShapeCache_.clear();
+  pulseShapeCache_.emplace_back(t0, pulse);
+}
+
 void MahiFit::setPulseShapeTemplate(const HcalPulseShapes::Shape& ps,const HcalTimeSlew* hcalTimeSlewDelay) {
 
   if (!(&ps == currentPulseShape_ ))
@@ -493,6 +501,7 @@ void MahiFit::resetPulseShapeTemplate(const HcalPulseShapes::Shape& ps) {
   psfPtr_.reset(new FitterFuncs::PulseShapeFunctor(ps,false,false,false,
 						   1,0,0,10));
   pfunctor_ = std::unique_ptr<ROOT::Math::Functor>( new ROOT::Math::Functor(psfPtr_.get(),&FitterFuncs::PulseShapeFunctor::singlePulseShapeFunc, 3) );
+  pulseShapeCache_.clear();
 
 
 }
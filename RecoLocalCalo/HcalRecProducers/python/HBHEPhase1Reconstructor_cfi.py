@@ -51,6 +51,11 @@ hbheprereco = cms.EDProducer(
     sipmQTSShift = cms.int32(0),
     sipmQNTStoSum = cms.int32(3),
 
+    # Number of copies of the reconstruction algorithm used to reconstruct
+    # the channels of an event in parallel. With 0 or 1, the channels are
+    # reconstructed one after the other.
+    nParallelReco = cms.uint32(0),
+
     # Configure the reconstruction algorithm
     algorithm = cms.PSet(
         # Parameters for "Method 3" (non-keyword arguments have to go first)
@@ -21,6 +21,11 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "tbb/parallel_for.h"
+
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
@@ -303,6 +308,7 @@ private:
     bool saveEffectivePedestal_;
     int sipmQTSShift_;
     int sipmQNTStoSum_;
+    unsigned nParallelReco_;
 
     // Parameters for turning status bit setters on/off
     bool setNegativeFlagsQIE8_;
@@ -316,6 +322,9 @@ private:
     edm::EDGetTokenT<HBHEDigiCollection> tok_qie8_;
     edm::EDGetTokenT<QIE11DigiCollection> tok_qie11_;
     std::unique_ptr<AbsHBHEPhase1Algo> reco_;
+    // Additional copies of the algorithm, used together with reco_
+    // when the channels of an event are reconstructed in parallel
+    std::vector<std::unique_ptr<AbsHBHEPhase1Algo> > recoCopies_;
     std::unique_ptr<AbsHcalAlgoData> recoConfig_;
     std::unique_ptr<HcalRecoParams> paramTS_;
 
@@ -367,6 +376,7 @@ HBHEPhase1Reconstructor::HBHEPhase1Reconstructor(const edm::ParameterSet& conf)
       saveEffectivePedestal_(conf.getParameter<bool>("saveEffectivePedestal")),
       sipmQTSShift_(conf.getParameter<int>("sipmQTSShift")),
       sipmQNTStoSum_(conf.getParameter<int>("sipmQNTStoSum")),
+      nParallelReco_(conf.getParameter<unsigned>("nParallelReco")),
       setNegativeFlagsQIE8_(conf.getParameter<bool>("setNegativeFlagsQIE8")),
       setNegativeFlagsQIE11_(conf.getParameter<bool>("setNegativeFlagsQIE11")),
       setNoiseFlagsQIE8_(conf.getParameter<bool>("setNoiseFlagsQIE8")),
@@ -382,6 +392,12 @@ HBHEPhase1Reconstructor::HBHEPhase1Reconstructor(const edm::ParameterSet& conf)
             << "Invalid HBHEPhase1Algo algorithm configuration"
             << std::endl;
 
+    // The algorithms keep state between channels (fit workspaces,
+    // pulse shapes), so each parallel task gets its own copy
+    for (unsigned i=1; i<nParallelReco_; ++i)
+        recoCopies_.push_back(parseHBHEPhase1AlgoDescription(
+            conf.getParameter<edm::ParameterSet>("algorithm")));
+
     // Configure the status bit setters that have been turned on
     if (setNoiseFlagsQIE8_)
         hbheFlagSetterQIE8_ = parse_HBHEStatusBitSetter(
@@ -444,6 +460,13 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
     // not going to be constructed from such channels.
     const bool skipDroppedChannels = !(infos && saveDroppedInfos_);
 
+    // Channels to reconstruct in parallel, once all of them are decoded
+    typedef std::tuple<typename Collection::const_iterator,
+                       const HcalRecoParam*,
+                       const HcalCalibrations*> PendingChannel;
+    std::vector<PendingChannel> pending;
+    std::vector<HBHEChannelInfo> pendingInfos;
+
     // Iterate over the input collection
     for (typename Collection::const_iterator it = coll.begin();
          it != coll.end(); ++it)
@@ -544,6 +567,12 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
             const HcalRecoParam* pptr = nullptr;
             if (recoParamsFromDB_)
                 pptr = param_ts;
+            if (!recoCopies_.empty())
+            {
+                pending.emplace_back(it, pptr, &calib);
+                pendingInfos.push_back(*channelInfo);
+                continue;
+            }
             HBHERecHit rh = reco_->reconstruct(*channelInfo, pptr, calib, isRealData);
             if (rh.id().rawId())
             {
@@ -553,6 +582,41 @@ void HBHEPhase1Reconstructor::processData(const Collection& coll,
             }
         }
     }
+
+    if (pending.empty())
+        return;
+
+    // Each copy of the algorithm reconstructs a contiguous range of
+    // channels. The status bits are set afterwards, in the original
+    // channel order, so the output does not depend on the threading.
+    const unsigned nPending = pending.size();
+    const unsigned nAlgos = recoCopies_.size() + 1;
+    std::vector<HBHERecHit> pendingHits(nPending);
+    tbb::parallel_for(0U, nAlgos, [&](const unsigned ialgo)
+    {
+        AbsHBHEPhase1Algo* reco = ialgo ? recoCopies_[ialgo-1].get() : reco_.get();
+        const unsigned last = nPending*(ialgo+1)/nAlgos;
+        for (unsigned i=nPending*ialgo/nAlgos; i<last; ++i)
+            pendingHits[i] = reco->reconstruct(pendingInfos[i], std::get<1>(pending[i]),
+                                               *std::get<2>(pending[i]), isRealData);
+    });
+
+    for (unsigned i=0; i<nPending; ++i)
+    {
+        HBHERecHit& rh = pendingHits[i];
+        if (rh.id().rawId())
+        {
+            const DFrame& frame(*std::get<0>(pending[i]));
+            const HcalDetId cell(frame.id());
+            const HcalQIECoder* channelCoder = cond.getHcalCoder(cell);
+            const HcalQIEShape* shape = cond.getHcalShape(channelCoder);
+            const HcalCoderDb coder(*channelCoder, *shape);
+            const HcalCalibrations& calib = *std::get<2>(pending[i]);
+            setAsicSpecificBits(frame, coder, pendingInfos[i], calib, &rh);
+            setCommonStatusBits(pendingInfos[i], calib, &rh);
+            rechits->push_back(rh);
+        }
+    }
 }
 
 void HBHEPhase1Reconstructor::setCommonStatusBits(
@@ -704,6 +768,10 @@ HBHEPhase1Reconstructor::beginRun(edm::Run const& r, edm::EventSetup const& es)
     es.get<HcalRecoParamsRcd>().get(p);
     paramTS_ = std::make_unique<HcalRecoParams>(*p.product());
 
+    std::vector<AbsHBHEPhase1Algo*> algos(1, reco_.get());
+    for (auto& copy : recoCopies_)
+        algos.push_back(copy.get());
+
     if (reco_->isConfigurable())
     {
         recoConfig_ = fetchHcalAlgoData(algoConfigClass_, es);
@@ -711,10 +779,11 @@ HBHEPhase1Reconstructor::beginRun(edm::Run const& r, edm::EventSetup const& es)
             throw cms::Exception("HBHEPhase1BadConfig")
                 << "Invalid HBHEPhase1Reconstructor \"algoConfigClass\" parameter value \""
                 << algoConfigClass_ << '"' << std::endl;
-        if (!reco_->configure(recoConfig_.get()))
-            throw cms::Exception("HBHEPhase1BadConfig")
-                << "Failed to configure HBHEPhase1Algo algorithm from EventSetup"
-                << std::endl;
+        for (auto* algo : algos)
+            if (!algo->configure(recoConfig_.get()))
+                throw cms::Exception("HBHEPhase1BadConfig")
+                    << "Failed to configure HBHEPhase1Algo algorithm from EventSetup"
+                    << std::endl;
     }
 
     if (setNoiseFlagsQIE8_ || setNoiseFlagsQIE11_)
@@ -733,13 +802,16 @@ HBHEPhase1Reconstructor::beginRun(edm::Run const& r, edm::EventSetup const& es)
                 "HBHEPhase1Reconstructor failed to get HcalFrontEndMap!" << std::endl;
     }
 
-    reco_->beginRun(r, es);
+    for (auto* algo : algos)
+        algo->beginRun(r, es);
 }
 
 void
 HBHEPhase1Reconstructor::endRun(edm::Run const&, edm::EventSetup const&)
 {
     reco_->endRun();
+    for (auto& copy : recoCopies_)
+        copy->endRun();
 }
 
 #define add_param_set(name) /**/       \
@@ -767,6 +839,7 @@ HBHEPhase1Reconstructor::fillDescriptions(edm::ConfigurationDescriptions& descri
     desc.add<bool>("saveEffectivePedestal", false);
     desc.add<int>("sipmQTSShift", 0);
     desc.add<int>("sipmQNTStoSum", 3);
+    desc.add<unsigned>("nParallelReco", 0U);
     desc.add<bool>("setNegativeFlagsQIE8");
     desc.add<bool>("setNegativeFlagsQIE11");
     desc.add<bool>("setNoiseFlagsQIE8");
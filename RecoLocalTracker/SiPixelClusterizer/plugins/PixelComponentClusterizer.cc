@@ -0,0 +1,133 @@
+#include "PixelComponentClusterizer.h"
+#include "PixelClusterizerBase.h"
+
+#include <algorithm>
+
+namespace {
+  inline unsigned int findRoot(std::vector<unsigned int> & parent, unsigned int i) {
+    while (parent[i]!=i) { parent[i]=parent[parent[i]]; i=parent[i];}
+    return i;
+  }
+}
+
+
+void PixelComponentClusterizer::Workspace::setSize(int nr, int nc) {
+  if (nr*nc > int(grid.size())) grid.resize(nr*nc,-1);
+  nrows=nr; ncols=nc;
+}
+
+
+void PixelComponentClusterizer::clusterize(uint16_t const * row, uint16_t const * col, int const * charge, unsigned int n,
+					   int nrows, int ncols, int clusterThreshold,
+					   Workspace & ws, std::vector<SiPixelCluster> & output) const {
+  ws.setSize(nrows,ncols);
+  auto & grid = ws.grid;
+  auto & pix = ws.pix;
+  auto & parent = ws.parent;
+  pix.clear();
+
+  // fill the compact list and the index grid
+  for (unsigned int i=0; i<n; ++i) {
+    if (charge[i]<theChannelThreshold) continue;
+    auto & g = grid[row[i]*ncols+col[i]];
+    if (g>=0) { // same pixel twice: keep the last one, as set_adc in the buffer does
+      pix[g] = i;
+      continue;
+    }
+    g = pix.size();
+    pix.push_back(i);
+  }
+  auto np = pix.size();
+  if (np==0) return;
+
+  // union with the already visited half of the 8-neighbourhood
+  parent.resize(np);
+  for (unsigned int k=0; k<np; ++k) parent[k]=k;
+  constexpr int dr[4] = {-1,-1,-1, 0};
+  constexpr int dc[4] = {-1, 0, 1,-1};
+  for (unsigned int k=0; k<np; ++k) {
+    int r = row[pix[k]], c = col[pix[k]];
+    for (int d=0; d<4; ++d) {
+      int rr = r+dr[d], cc = c+dc[d];
+      if (rr<0 || cc<0 || cc>=ncols) continue;
+      auto g = grid[rr*ncols+cc];
+      if (g<0) continue;
+      auto a = findRoot(parent,k), b = findRoot(parent,g);
+      if (a!=b) parent[std::max(a,b)] = std::min(a,b);
+    }
+  }
+
+  // group the pixels by component, in input order
+  auto & component = ws.component;
+  auto & first = ws.first;
+  auto & next = ws.next;
+  auto & last = ws.last;
+  auto & hasSeed = ws.hasSeed;
+  component.assign(np,-1);
+  first.clear(); last.clear(); next.assign(np,np); hasSeed.clear();
+  for (unsigned int k=0; k<np; ++k) {
+    auto root = findRoot(parent,k);
+    if (component[root]<0) {
+      component[root] = first.size();
+      first.push_back(k); last.push_back(k); hasSeed.push_back(0);
+    } else {
+      auto ic = component[root];
+      next[last[ic]] = k; last[ic] = k;
+    }
+    if (charge[pix[k]]>=theSeedThreshold) hasSeed[component[root]] = 1;
+  }
+
+  auto store = [&](PixelClusterizerBase::AccretionCluster const & acluster) {
+    // charge as stored in the cluster
+    int q=0;
+    for (unsigned int j=0; j<acluster.isize; ++j) q += acluster.adc[j];
+    if (q<clusterThreshold) return;
+    output.emplace_back(acluster.isize,acluster.adc, acluster.x,acluster.y, acluster.xmin,acluster.ymin);
+  };
+
+  // flood fill from a seed over the unused pixels, in the order of
+  // PixelThresholdClusterizer::make_cluster, until the buffer is full
+  auto & used = ws.used;
+  used.assign(np,0);
+  auto accrete = [&](unsigned int ks, PixelClusterizerBase::AccretionCluster & acluster) {
+    acluster.add(SiPixelCluster::PixelPos(row[pix[ks]],col[pix[ks]]), charge[pix[ks]]);
+    used[ks]=1;
+    while (!acluster.empty()) {
+      auto curInd = acluster.top(); acluster.pop();
+      int x = acluster.x[curInd], y = acluster.y[curInd];
+      for (auto c=std::max(0,y-1); c<std::min(y+2,ncols); ++c) {
+	for (auto r=std::max(0,x-1); r<std::min(x+2,nrows); ++r) {
+	  auto g = grid[r*ncols+c];
+	  if (g<0 || used[g]) continue;
+	  if (!acluster.add(SiPixelCluster::PixelPos(r,c), charge[pix[g]])) return;
+	  used[g]=1;
+	}
+      }
+    }
+  };
+
+  // make the clusters
+  auto firstOut = output.size();
+  for (unsigned int ic=0; ic<first.size(); ++ic) {
+    if (!hasSeed[ic]) continue;
+    PixelClusterizerBase::AccretionCluster acluster;
+    bool full=false;
+    for (auto k=first[ic]; k<np; k=next[k]) {
+      auto i = pix[k];
+      if (!acluster.add(SiPixelCluster::PixelPos(row[i],col[i]), charge[i])) { full=true; break;}
+    }
+    if (!full) { store(acluster); continue;}
+    // too large for one cluster: grow one from each seed still unused
+    for (auto k=first[ic]; k<np; k=next[k]) {
+      if (used[k] || charge[pix[k]]<theSeedThreshold) continue;
+      PixelClusterizerBase::AccretionCluster scluster;
+      accrete(k,scluster);
+      store(scluster);
+    }
+  }
+  std::stable_sort(output.begin()+firstOut,output.end(),
+		   [](SiPixelCluster const & cl1,SiPixelCluster const & cl2) { return cl1.minPixelRow() < cl2.minPixelRow();});
+
+  // reset the grid
+  for (auto i : pix) grid[row[i]*ncols+col[i]] = -1;
+}
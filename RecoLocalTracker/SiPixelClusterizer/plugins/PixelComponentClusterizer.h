@@ -0,0 +1,58 @@
+#ifndef RecoLocalTracker_SiPixelClusterizer_PixelComponentClusterizer_H
+#define RecoLocalTracker_SiPixelClusterizer_PixelComponentClusterizer_H
+
+//----------------------------------------------------------------------------
+//! \class PixelComponentClusterizer
+//! \brief Connected-component labelling of the calibrated pixels of one module.
+//!
+//! Same clusters as PixelThresholdClusterizer (8-connected pixels above the
+//! channel threshold containing at least one seed, kept if above the cluster
+//! threshold), found with a union-find over the pixels instead of a flood
+//! fill of the full module matrix.
+//! A component larger than the accretion buffer is split as in
+//! PixelThresholdClusterizer: each seed not yet used, in input order, is
+//! grown by a flood fill over the unused pixels until the buffer is full,
+//! and the pixels left over are available to the following seeds.
+//! The input is a flat list of (row, col, charge in electrons) of one module;
+//! the only per-module state is a Workspace, so different modules can be
+//! clustered concurrently, each with its own Workspace.
+//----------------------------------------------------------------------------
+
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+
+#include <cstdint>
+#include <vector>
+
+class dso_hidden PixelComponentClusterizer {
+public:
+
+  // scratch memory, to be reused across modules
+  class Workspace {
+  public:
+    void setSize(int nrows, int ncols);
+  private:
+    friend class PixelComponentClusterizer;
+    int nrows=0, ncols=0;
+    std::vector<int> grid;          // pixel index at (row,col) or -1, nrows*ncols, always reset after use
+    std::vector<unsigned int> pix;  // input index of the pixels above the channel threshold
+    std::vector<unsigned int> parent;
+    std::vector<int> component;     // component of each root, -1 if not yet assigned
+    std::vector<unsigned int> first, last, next; // pixels of each component (linked list)
+    std::vector<char> hasSeed;
+    std::vector<char> used;         // pixels already in a cluster, for the components to split
+  };
+
+  PixelComponentClusterizer(int channelThreshold, int seedThreshold) :
+    theChannelThreshold(channelThreshold), theSeedThreshold(seedThreshold) {}
+
+  /// append to output the clusters of one module, sorted by minPixelRow
+  void clusterize(uint16_t const * row, uint16_t const * col, int const * charge, unsigned int n,
+		  int nrows, int ncols, int clusterThreshold,
+		  Workspace & ws, std::vector<SiPixelCluster> & output) const;
+
+private:
+  const int theChannelThreshold;
+  const int theSeedThreshold;
+};
+
+#endif
@@ -0,0 +1,314 @@
+/** SiPixelRawToClusterProducer.cc
+ * ---------------------------------------------------------------
+ * Fused pixel raw data to cluster producer.
+ *
+ * Same output as SiPixelRawToDigi followed by SiPixelClusterProducer
+ * (PixelThresholdClusterizer) without materializing the intermediate
+ * edm::DetSetVector<PixelDigi>:
+ *  - all FEDs are unpacked in a flat per-event PixelDigiSoA,
+ *  - the digis are grouped by module (stable sort by detId, so the
+ *    digi order within a module is the one of the two-step chain),
+ *  - the gain calibration is applied per module (serially: the
+ *    calibration services cache the last column/module),
+ *  - the modules are clustered concurrently with PixelComponentClusterizer,
+ *  - the clusters are filled in the output in increasing detId order.
+ *
+ * Regional unpacking, the raw-data-error/user-error/PixelFEDChannel
+ * products and the stacked-layer ADC conversion are not supported:
+ * use the two-step chain for those.
+ * ---------------------------------------------------------------
+ */
+
+#include "PixelComponentClusterizer.h"
+
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDataFormatter.h"
+#include "EventFilter/SiPixelRawToDigi/interface/PixelDigiSoA.h"
+
+#include "CondFormats/DataRecord/interface/SiPixelFedCablingMapRcd.h"
+#include "CondFormats/DataRecord/interface/SiPixelQualityRcd.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingMap.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelFedCablingTree.h"
+#include "CondFormats/SiPixelObjects/interface/SiPixelQuality.h"
+
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationOfflineService.h"
+#include "CalibTracker/SiPixelESProducers/interface/SiPixelGainCalibrationForHLTService.h"
+
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/CommonTopologies/interface/PixelTopology.h"
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "Geometry/Records/interface/TrackerTopologyRcd.h"
+
+#include "DataFormats/Common/interface/DetSetVectorNew.h"
+#include "DataFormats/DetId/interface/DetIdCollection.h"
+#include "DataFormats/FEDRawData/interface/FEDRawDataCollection.h"
+#include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/SiPixelDigi/interface/PixelDigi.h"
+
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/ESTransientHandle.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/stream/EDProducer.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+
+class dso_hidden SiPixelRawToClusterProducer final : public edm::stream::EDProducer<> {
+public:
+  explicit SiPixelRawToClusterProducer(const edm::ParameterSet& conf);
+  ~SiPixelRawToClusterProducer() override;
+
+  void produce(edm::Event& ev, const edm::EventSetup& es) override;
+
+private:
+
+  // one module with digis
+  struct Module {
+    uint32_t detId;
+    unsigned int begin, end; // range in the sorted digis
+    int nrows, ncols;
+    int clusterThreshold;
+  };
+
+  void unpack(const FEDRawDataCollection& buffers, DetIdCollection& tkErrors);
+  void calibrate(const Module& module, int layer);
+
+  edm::EDGetTokenT<FEDRawDataCollection> tFEDRawDataCollection;
+  edm::ESWatcher<SiPixelFedCablingMapRcd> recordWatcher;
+  edm::ESWatcher<SiPixelQualityRcd> qualityWatcher;
+  std::unique_ptr<SiPixelFedCablingTree> cabling_;
+  std::vector<unsigned int> fedIds;
+  const SiPixelQuality* badPixelInfo_;
+  SiPixelGainCalibrationServiceBase* theSiPixelGainCalibration_;
+
+  const std::string cablingMapLabel;
+  const bool includeErrors;
+  const bool useQuality;
+  const bool usePilotBlade;
+  const bool usePhase1;
+  std::vector<int> tkerrorlist;
+
+  const int theClusterThreshold, theClusterThreshold_L1;
+  const float theConversionFactor, theConversionFactor_L1;
+  const float theOffset, theOffset_L1;
+  const double theElectronPerADCGain;
+  const bool doMissCalibrate;
+  const int32_t maxTotalClusters_;
+
+  const PixelComponentClusterizer clusterizer_;
+
+  // per-event scratch
+  PixelDigiSoA digis_;
+  std::vector<unsigned int> order_;    // digis sorted by module
+  std::vector<uint16_t> row_, col_;    // sorted
+  std::vector<int> charge_;            // sorted, in electrons
+  std::vector<PixelDigi> moduleDigis_; // input of the calibration service
+  std::vector<Module> modules_;
+  std::vector<std::vector<SiPixelCluster>> clusters_; // per module
+  tbb::enumerable_thread_specific<PixelComponentClusterizer::Workspace> workspaces_;
+};
+
+
+SiPixelRawToClusterProducer::SiPixelRawToClusterProducer(const edm::ParameterSet& conf) :
+  badPixelInfo_(nullptr),
+  theSiPixelGainCalibration_(nullptr),
+  cablingMapLabel(conf.getParameter<std::string>("CablingMapLabel")),
+  includeErrors(conf.getParameter<bool>("IncludeErrors")),
+  useQuality(conf.getParameter<bool>("UseQualityInfo")),
+  usePilotBlade(conf.getParameter<bool>("UsePilotBlade")),
+  usePhase1(conf.getParameter<bool>("UsePhase1")),
+  theClusterThreshold(conf.getParameter<int>("ClusterThreshold")),
+  theClusterThreshold_L1(conf.getParameter<int>("ClusterThreshold_L1")),
+  theConversionFactor(conf.getParameter<int>("VCaltoElectronGain")),
+  theConversionFactor_L1(conf.getParameter<int>("VCaltoElectronGain_L1")),
+  theOffset(conf.getParameter<int>("VCaltoElectronOffset")),
+  theOffset_L1(conf.getParameter<int>("VCaltoElectronOffset_L1")),
+  theElectronPerADCGain(conf.existsAs<double>("ElectronPerADCGain") ? conf.getParameter<double>("ElectronPerADCGain") : 135.),
+  doMissCalibrate(conf.getUntrackedParameter<bool>("MissCalibrate",true)),
+  maxTotalClusters_(conf.getParameter<int32_t>("maxNumberOfClusters")),
+  clusterizer_(conf.getParameter<int>("ChannelThreshold"), conf.getParameter<int>("SeedThreshold"))
+{
+  tFEDRawDataCollection = consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("InputLabel"));
+  if (conf.existsAs<std::vector<int>>("ErrorList"))
+    tkerrorlist = conf.getParameter<std::vector<int>>("ErrorList");
+
+  auto const & payloadType = conf.getParameter<std::string>("payloadType");
+  if (payloadType=="HLT")
+    theSiPixelGainCalibration_ = new SiPixelGainCalibrationForHLTService(conf);
+  else if (payloadType=="Offline")
+    theSiPixelGainCalibration_ = new SiPixelGainCalibrationOfflineService(conf);
+  else if (payloadType=="Full")
+    theSiPixelGainCalibration_ = new SiPixelGainCalibrationService(conf);
+  else
+    throw cms::Exception("Configuration") << "SiPixelRawToClusterProducer: unknown payloadType " << payloadType
+					  << ", possible choices are HLT, Offline and Full";
+
+  produces<SiPixelClusterCollectionNew>();
+  if (includeErrors) produces<DetIdCollection>();
+}
+
+SiPixelRawToClusterProducer::~SiPixelRawToClusterProducer() {
+  delete theSiPixelGainCalibration_;
+}
+
+
+void SiPixelRawToClusterProducer::unpack(const FEDRawDataCollection& buffers, DetIdCollection& tkErrors) {
+  const uint32_t dummydetid = 0xffffffff;
+
+  PixelDataFormatter formatter(cabling_.get(), usePhase1);
+  formatter.setErrorStatus(includeErrors);
+  if (useQuality) formatter.setQualityStatus(useQuality, badPixelInfo_);
+
+  bool errorsInEvent = false;
+  for (auto fedId : fedIds) {
+    if (!usePilotBlade && fedId==40) continue; // skip pilot blade data
+    PixelDataFormatter::Errors errors;
+    formatter.interpretRawData(errorsInEvent, fedId, buffers.FEDData(fedId), digis_, errors);
+
+    // detIds to be turned off by tracking, as in SiPixelRawToDigi
+    if (!includeErrors || tkerrorlist.empty()) continue;
+    for (auto const & is : errors) {
+      if (is.first==dummydetid) continue;
+      for (auto const & aPixelError : is.second) {
+	if (aPixelError.getType()==25) continue;
+	if (std::find(tkerrorlist.begin(),tkerrorlist.end(),aPixelError.getType())!=tkerrorlist.end())
+	  tkErrors.push_back(is.first);
+      }
+    }
+  }
+}
+
+
+void SiPixelRawToClusterProducer::calibrate(const Module& module, int layer) {
+  auto n = module.end-module.begin;
+  auto * electron = charge_.data()+module.begin;
+  if (doMissCalibrate) {
+    moduleDigis_.clear();
+    for (auto i=module.begin; i<module.end; ++i)
+      moduleDigis_.emplace_back(row_[i],col_[i],digis_.adc[order_[i]]);
+    if (layer==1)
+      theSiPixelGainCalibration_->calibrate(module.detId,moduleDigis_.begin(),moduleDigis_.end(),theConversionFactor_L1,theOffset_L1,electron);
+    else
+      theSiPixelGainCalibration_->calibrate(module.detId,moduleDigis_.begin(),moduleDigis_.end(),theConversionFactor,theOffset,electron);
+  } else {
+    const float gain = theElectronPerADCGain; // default: 1 ADC = 135 electrons
+    for (unsigned int i=0; i<n; ++i) electron[i] = int(digis_.adc[order_[module.begin+i]]*gain);
+  }
+  // put all negative pixel charges into the 100 elec bin, as PixelThresholdClusterizer
+  for (unsigned int i=0; i<n; ++i) electron[i] = std::max(electron[i],100);
+}
+
+
+void SiPixelRawToClusterProducer::produce(edm::Event& ev, const edm::EventSetup& es) {
+  // initialize cabling map or update if necessary
+  if (recordWatcher.check(es)) {
+    edm::ESTransientHandle<SiPixelFedCablingMap> cablingMap;
+    es.get<SiPixelFedCablingMapRcd>().get(cablingMapLabel, cablingMap);
+    fedIds   = cablingMap->fedIds();
+    cabling_ = cablingMap->cablingTree();
+  }
+  // initialize quality record or update if necessary
+  if (qualityWatcher.check(es) && useQuality) {
+    edm::ESHandle<SiPixelQuality> qualityInfo;
+    es.get<SiPixelQualityRcd>().get(qualityInfo);
+    badPixelInfo_ = qualityInfo.product();
+    if (!badPixelInfo_)
+      edm::LogError("SiPixelQualityNotPresent") << " Configured to use SiPixelQuality, but SiPixelQuality not present";
+  }
+  theSiPixelGainCalibration_->setESObjects(es);
+
+  edm::ESHandle<TrackerGeometry> geom;
+  es.get<TrackerDigiGeometryRecord>().get(geom);
+  edm::ESHandle<TrackerTopology> tTopo;
+  es.get<TrackerTopologyRcd>().get(tTopo);
+
+  edm::Handle<FEDRawDataCollection> buffers;
+  ev.getByToken(tFEDRawDataCollection, buffers);
+
+  auto output = std::make_unique<SiPixelClusterCollectionNew>();
+  auto tkErrors = std::make_unique<DetIdCollection>();
+
+  // Step A: unpack all FEDs
+  digis_.clear();
+  unpack(*buffers, *tkErrors);
+  unsigned int ndigis = digis_.size();
+
+  // Step B: group the digis by module, keeping the unpacking order within a module
+  order_.resize(ndigis);
+  std::iota(order_.begin(),order_.end(),0);
+  auto const & rawId = digis_.rawId;
+  std::stable_sort(order_.begin(),order_.end(),[&](unsigned int i, unsigned int j) { return rawId[i]<rawId[j];});
+  row_.resize(ndigis); col_.resize(ndigis); charge_.resize(ndigis);
+  for (unsigned int i=0; i<ndigis; ++i) { row_[i]=digis_.row[order_[i]]; col_[i]=digis_.col[order_[i]];}
+
+  // Step C: per module setup and calibration (serial)
+  modules_.clear();
+  for (unsigned int b=0; b<ndigis; ) {
+    auto detId = rawId[order_[b]];
+    auto e = b+1;
+    while (e<ndigis && rawId[order_[e]]==detId) ++e;
+    auto pixDet = dynamic_cast<const PixelGeomDetUnit*>(geom->idToDetUnit(DetId(detId)));
+    if (!pixDet)
+      throw cms::Exception("InvalidDetId") << "SiPixelRawToClusterProducer: " << detId << " is not a pixel module";
+    int layer = (DetId(detId).subdetId()==1) ? tTopo->pxbLayer(detId) : 0;
+    Module module{detId, b, e, pixDet->specificTopology().nrows(), pixDet->specificTopology().ncolumns(),
+	layer==1 ? theClusterThreshold_L1 : theClusterThreshold};
+    calibrate(module,layer);
+    modules_.push_back(module);
+    b = e;
+  }
+
+  // Step D: cluster the modules concurrently
+  auto nmodules = modules_.size();
+  if (clusters_.size()<nmodules) clusters_.resize(nmodules);
+  tbb::parallel_for(0UL, nmodules, [&](unsigned long im) {
+      auto const & module = modules_[im];
+      auto & out = clusters_[im];
+      out.clear();
+      clusterizer_.clusterize(row_.data()+module.begin, col_.data()+module.begin, charge_.data()+module.begin,
+			      module.end-module.begin, module.nrows, module.ncols, module.clusterThreshold,
+			      workspaces_.local(), out);
+    });
+
+  // Step E: fill the output in detId order
+  int numberOfClusters = 0;
+  for (unsigned int im=0; im<nmodules; ++im) {
+    auto const & clusters = clusters_[im];
+    if (clusters.empty()) continue;
+    {
+      SiPixelClusterCollectionNew::FastFiller spc(*output, modules_[im].detId);
+      for (auto const & cl : clusters) spc.push_back(cl);
+      numberOfClusters += spc.size();
+    }
+    if ((maxTotalClusters_ >= 0) && (numberOfClusters > maxTotalClusters_)) {
+      edm::LogError("TooManyClusters") << "Limit on the number of clusters exceeded. An empty cluster collection will be produced instead.\n";
+      SiPixelClusterCollectionNew empty;
+      output->swap(empty);
+      break;
+    }
+  }
+
+  LogDebug("SiPixelRawToClusterProducer") << ndigis << " digis in " << nmodules << " modules, " << numberOfClusters << " clusters";
+
+  output->shrink_to_fit();
+  ev.put(std::move(output));
+  if (includeErrors) ev.put(std::move(tkErrors));
+}
+
+DEFINE_FWK_MODULE(SiPixelRawToClusterProducer);
@@ -0,0 +1,43 @@
+import FWCore.ParameterSet.Config as cms
+
+# Fused raw data to clusters: same clusters as siPixelDigis + siPixelClusters
+# (full unpacking only; the only error product is the tracking DetIdCollection)
+from CondTools.SiPixel.SiPixelGainCalibrationService_cfi import *
+siPixelRawToClusters = cms.EDProducer("SiPixelRawToClusterProducer",
+    SiPixelGainCalibrationServiceParameters,
+    # unpacking, as siPixelDigis
+    InputLabel = cms.InputTag("siPixelRawData"),
+    IncludeErrors = cms.bool(True),
+    ## ErrorList: list of error codes used by tracking to invalidate modules
+    ErrorList = cms.vint32(29),
+    UseQualityInfo = cms.bool(False),
+    UsePilotBlade = cms.bool(False),
+    UsePhase1 = cms.bool(False),
+    CablingMapLabel = cms.string(""),
+    # clustering, as siPixelClusters
+    ChannelThreshold = cms.int32(1000),
+    MissCalibrate = cms.untracked.bool(True),
+    VCaltoElectronGain    = cms.int32(65),
+    VCaltoElectronGain_L1 = cms.int32(65),
+    VCaltoElectronOffset    = cms.int32(-414),
+    VCaltoElectronOffset_L1 = cms.int32(-414),
+    payloadType = cms.string('Offline'),
+    SeedThreshold = cms.int32(1000),
+    ClusterThreshold    = cms.int32(4000),
+    ClusterThreshold_L1 = cms.int32(4000),
+    maxNumberOfClusters = cms.int32(-1), # -1 means no limit.
+)
+
+# phase1 pixel
+from Configuration.Eras.Modifier_phase1Pixel_cff import phase1Pixel
+phase1Pixel.toModify(siPixelRawToClusters,
+  UsePhase1               = True,
+  VCaltoElectronGain      = 47,
+  VCaltoElectronGain_L1   = 50,
+  VCaltoElectronOffset    = -60,
+  VCaltoElectronOffset_L1 = -670,
+  ChannelThreshold        = 10,
+  SeedThreshold           = 1000,
+  ClusterThreshold        = 4000,
+  ClusterThreshold_L1     = 2000
+)
@@ -0,0 +1,134 @@
+// Check that PixelComponentClusterizer finds the same clusters as
+// PixelThresholdClusterizer on one module, for sparse hits and for a large
+// blob of connected pixels that does not fit in the accretion buffer and has
+// to be split into several clusters, one per seed left unused by the previous
+// ones.  The clusters are compared as sets of pixels, since the two
+// algorithms do not add the pixels of a cluster in the same order.
+
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelThresholdClusterizer.cc"
+#include "RecoLocalTracker/SiPixelClusterizer/plugins/PixelComponentClusterizer.cc"
+
+#include "DataFormats/DetId/interface/DetId.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetUnit.h"
+#include "Geometry/TrackerGeometryBuilder/interface/PixelGeomDetType.h"
+#include "Geometry/TrackerGeometryBuilder/interface/RectangularPixelTopology.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  constexpr int nrows = 160, ncols = 416;
+  constexpr int channelThreshold = 1000, seedThreshold = 5000, clusterThreshold = 4000;
+
+  // pixels (row, col, adc) of a cluster, in a canonical order
+  std::vector<std::tuple<int,int,int>> content(SiPixelCluster const & cl) {
+    std::vector<std::tuple<int,int,int>> ret;
+    for (auto const & p : cl.pixels()) ret.emplace_back(p.x,p.y,p.adc);
+    std::sort(ret.begin(),ret.end());
+    return ret;
+  }
+
+  std::vector<std::vector<std::tuple<int,int,int>>> contents(std::vector<SiPixelCluster> const & cls) {
+    std::vector<std::vector<std::tuple<int,int,int>>> ret;
+    for (auto const & cl : cls) ret.push_back(content(cl));
+    std::sort(ret.begin(),ret.end());
+    return ret;
+  }
+
+  bool compare(PixelThresholdClusterizer & reference, PixelGeomDetUnit const & det,
+	       std::vector<PixelDigi> const & digis, const char * what) {
+    edm::DetSet<PixelDigi> input(det.geographicalId().rawId());
+    input.data = digis;
+    edmNew::DetSetVector<SiPixelCluster> expected;
+    {
+      edmNew::DetSetVector<SiPixelCluster>::FastFiller filler(expected,input.detId());
+      reference.clusterizeDetUnit(input,&det,nullptr,std::vector<short>(),filler);
+    }
+    std::vector<SiPixelCluster> refClusters;
+    for (auto const & ds : expected) refClusters.insert(refClusters.end(),ds.begin(),ds.end());
+
+    // same calibration as PixelThresholdClusterizer without MissCalibrate
+    std::vector<uint16_t> row, col;
+    std::vector<int> charge;
+    for (auto const & d : digis) {
+      row.push_back(d.row()); col.push_back(d.column());
+      charge.push_back(std::max(100,int(d.adc()*135.f)));
+    }
+    PixelComponentClusterizer clusterizer(channelThreshold,seedThreshold);
+    PixelComponentClusterizer::Workspace ws;
+    std::vector<SiPixelCluster> clusters;
+    clusterizer.clusterize(row.data(),col.data(),charge.data(),digis.size(),nrows,ncols,clusterThreshold,ws,clusters);
+
+    bool sorted = std::is_sorted(clusters.begin(),clusters.end(),
+				 [](SiPixelCluster const & a, SiPixelCluster const & b) { return a.minPixelRow()<b.minPixelRow();});
+    bool ok = sorted && contents(clusters)==contents(refClusters);
+    std::cout << what << ": " << digis.size() << " digis, " << refClusters.size() << " reference clusters, "
+	      << clusters.size() << " clusters" << (ok ? "" : " MISMATCH") << std::endl;
+    return ok;
+  }
+
+}
+
+int main() {
+  edm::ParameterSet conf;
+  conf.addParameter<int>("ChannelThreshold",channelThreshold);
+  conf.addParameter<int>("SeedThreshold",seedThreshold);
+  conf.addParameter<int>("ClusterThreshold",clusterThreshold);
+  conf.addParameter<int>("ClusterThreshold_L1",clusterThreshold);
+  conf.addParameter<int>("VCaltoElectronGain",65);
+  conf.addParameter<int>("VCaltoElectronGain_L1",65);
+  conf.addParameter<int>("VCaltoElectronOffset",-414);
+  conf.addParameter<int>("VCaltoElectronOffset_L1",-414);
+  conf.addParameter<bool>("SplitClusters",false);
+  conf.addUntrackedParameter<bool>("MissCalibrate",false);
+  PixelThresholdClusterizer reference(conf);
+
+  // a forward module, so that no TrackerTopology is needed
+  GeomDetEnumerators::SubDetector subdet = GeomDetEnumerators::PixelEndcap;
+  PixelGeomDetType type(new RectangularPixelTopology(nrows,ncols,0.01,0.015,true,80,52,0,0,2,8),"test",subdet);
+  Plane::PlanePointer plane = Plane::build(Plane::PositionType(),Plane::RotationType());
+  PixelGeomDetUnit det(&(*plane),&type,DetId(DetId::Tracker,PixelSubdetector::PixelEndcap));
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> adc(1,255);
+  bool ok = true;
+
+  // sparse hits, all the components fit in the buffer
+  // (one digi per pixel, as in the data)
+  std::vector<PixelDigi> digis;
+  std::set<std::pair<int,int>> hit;
+  auto add = [&](int r, int c) { if (hit.insert(std::make_pair(r,c)).second) digis.emplace_back(r,c,adc(rng)); };
+  for (int i=0; i<400; ++i) {
+    int r = rng()%nrows, c = rng()%ncols;
+    add(r,c);
+    if (r+1<nrows) add(r+1,c);
+  }
+  ok &= compare(reference,det,digis,"sparse");
+
+  // on top, a 40x30 blob connected to diagonal tracks: components of
+  // more than PixelClusterizerBase::AccretionCluster::MAXSIZE pixels
+  for (int r=60; r<100; ++r)
+    for (int c=200; c<230; ++c)
+      if (rng()%10) add(r,c);
+  for (int k=0; k<180; ++k) add(100+k%60, 230+k);
+  std::shuffle(digis.begin(),digis.end(),rng);
+  ok &= compare(reference,det,digis,"large components");
+
+  // a fully occupied region, seeds everywhere
+  digis.clear(); hit.clear();
+  for (int r=0; r<nrows; ++r)
+    for (int c=0; c<60; ++c)
+      add(r,c);
+  ok &= compare(reference,det,digis,"occupied");
+
+  assert(ok);
+  return ok ? 0 : 1;
+}
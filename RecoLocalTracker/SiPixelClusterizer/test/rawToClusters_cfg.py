@@ -0,0 +1,42 @@
+# Compare siPixelDigis + siPixelClusters with the fused siPixelRawToClusters:
+# both run on the same events, the Timing service reports the time per module.
+#
+#   cmsRun rawToClusters_cfg.py inputFiles=file:raw.root
+##############################################################################
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+
+options = VarParsing('analysis')
+options.parseArguments()
+
+from Configuration.Eras.Era_Run2_2017_cff import Run2_2017
+process = cms.Process("RawToClus", Run2_2017)
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Services_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2017_realistic', '')
+
+process.load("EventFilter.SiPixelRawToDigi.SiPixelRawToDigi_cfi")
+process.load("RecoLocalTracker.SiPixelClusterizer.SiPixelClusterizer_cfi")
+process.load("RecoLocalTracker.SiPixelClusterizer.SiPixelRawToClusters_cfi")
+process.siPixelDigis.InputLabel = 'rawDataCollector'
+process.siPixelRawToClusters.InputLabel = 'rawDataCollector'
+
+process.maxEvents = cms.untracked.PSet( input = cms.untracked.int32(options.maxEvents) )
+process.source = cms.Source("PoolSource", fileNames = cms.untracked.vstring(options.inputFiles))
+
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(0),
+    wantSummary = cms.untracked.bool(True)
+)
+process.Timing = cms.Service("Timing", summaryOnly = cms.untracked.bool(True))
+
+process.twoStep = cms.Path(process.siPixelDigis*process.siPixelClusters)
+process.fused = cms.Path(process.siPixelRawToClusters)
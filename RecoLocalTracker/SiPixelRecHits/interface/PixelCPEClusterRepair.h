@@ -20,6 +20,7 @@
 #include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplate2D.h"
 #include "CondFormats/SiPixelObjects/interface/SiPixel2DTemplateDBObject.h"
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -32,6 +33,7 @@
 #endif
 
 class MagneticField;
+class SiPixelTemplateTable;
 class PixelCPEClusterRepair : public PixelCPEBase
 {
 public:
@@ -95,6 +97,9 @@ private:
    
    bool UseClusterSplitter_;
 
+   // Optional table of interpolated templates (binned track angles)
+   std::unique_ptr<SiPixelTemplateTable> templateTable_;
+
    // Template file management (when not getting the templates from the DB)
    int barrelTemplateID_ ;
    int forwardTemplateID_ ;
@@ -19,6 +19,7 @@
 #include "SiPixelTemplate.h"
 #endif
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,7 @@
 #endif
 
 class MagneticField;
+class SiPixelTemplateTable;
 class PixelCPETemplateReco : public PixelCPEBase
 {
 public:
@@ -79,6 +81,9 @@ private:
    
    bool UseClusterSplitter_;
 
+   // Optional table of interpolated templates (binned track angles)
+   std::unique_ptr<SiPixelTemplateTable> templateTable_;
+
    // Template file management (when not getting the templates from the DB)
    int barrelTemplateID_ ;
    int forwardTemplateID_ ;
@@ -0,0 +1,47 @@
+#ifndef RecoLocalTracker_SiPixelRecHits_SiPixelTemplateTable_H
+#define RecoLocalTracker_SiPixelRecHits_SiPixelTemplateTable_H
+
+#include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplate.h"
+
+#include "tbb/concurrent_unordered_map.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// ******************************************************************************************
+//! \class SiPixelTemplateTable
+//!
+//!  Table of interpolated templates, binned in cot(alpha) and cot(beta).
+//!  The CPE moves the track angles to the center of their bin (binCenter) and takes
+//!  a copy of the SiPixelTemplate interpolated there (find) instead of interpolating
+//!  for every cluster: PixelTempReco1D/2D then find the template already interpolated
+//!  for these angles.
+//!  The table is filled on demand, it lives as long as the template store (one IOV)
+//!  and can be used concurrently. Once maxEntries templates are stored find() returns
+//!  nullptr and the caller interpolates at the bin center itself, so the result does
+//!  not depend on the content of the table.
+// ******************************************************************************************
+class SiPixelTemplateTable {
+public:
+   SiPixelTemplateTable(const std::vector< SiPixelTemplateStore > & thePixelTemp, float cotAlphaStep, float cotBetaStep, unsigned int maxEntries);
+
+   //! move the angles to the center of their bin
+   void binCenter(float & cotalpha, float & cotbeta) const;
+
+   //! template interpolated at (binned) cotalpha, cotbeta, nullptr if it cannot be stored
+   const SiPixelTemplate * find(int id, float cotalpha, float cotbeta, float locBz, float locBx) const;
+
+   unsigned int size() const {return nEntries_;}
+
+private:
+   const std::vector< SiPixelTemplateStore > & thePixelTemp_;
+   const float cotAlphaStep_, cotBetaStep_;
+   const unsigned int maxEntries_;
+
+   // filled concurrently by the const find(), entries are never removed or moved
+   mutable tbb::concurrent_unordered_map<uint64_t, SiPixelTemplate> table_;
+   mutable std::atomic<unsigned int> nEntries_;
+};
+
+#endif
@@ -15,7 +15,13 @@ templates2 = cms.ESProducer("PixelCPEClusterRepairESProducer",
     # True in Run II for offline RECO
     DoLorentz = cms.bool(True),
  
-    LoadTemplatesFromDB = cms.bool(True)
+    LoadTemplatesFromDB = cms.bool(True),
+
+    # Take the interpolated templates from a table binned in cot(alpha), cot(beta)
+    UseTemplateTable = cms.bool(False),
+    TemplateTableCotAlphaStep = cms.double(0.005),
+    TemplateTableCotBetaStep = cms.double(0.02),
+    TemplateTableMaxEntries = cms.uint32(20000)
 
 )
 
@@ -11,6 +11,8 @@
 // Magnetic field
 #include "MagneticField/Engine/interface/MagneticField.h"
 
+#include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateTable.h"
+
 
 // Commented for now (3/10/17) until we figure out how to resuscitate 2D template splitter
 /// #include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateSplit.h"
@@ -86,6 +88,15 @@ PixelCPEClusterRepair::PixelCPEClusterRepair(edm::ParameterSet const & conf,
    
    UseClusterSplitter_ = conf.getParameter<bool>("UseClusterSplitter");   
 
+   // Interpolated 1D templates taken from a table binned in cot(alpha), cot(beta)
+   if ( conf.existsAs<bool>("UseTemplateTable") && conf.getParameter<bool>("UseTemplateTable") )
+   {
+      templateTable_ = std::make_unique<SiPixelTemplateTable>(thePixelTemp_,
+                                                              conf.getParameter<double>("TemplateTableCotAlphaStep"),
+                                                              conf.getParameter<double>("TemplateTableCotBetaStep"),
+                                                              conf.getParameter<unsigned int>("TemplateTableMaxEntries"));
+   }
+
 
    //--- Configure 3D reco.
    if ( conf.exists("MinProbY") )
@@ -286,8 +297,6 @@ PixelCPEClusterRepair::callTempReco2D( DetParam const & theDetParam,
 				       SiPixelTemplateReco::ClusMatrix & clusterPayload,
 				       int ID, LocalPoint & lp ) const
 {
-   SiPixelTemplate templ(thePixelTemp_);
-   
    // Output:
    float nonsense = -99999.9f; // nonsense init value
    theClusterParam.templXrec_ = theClusterParam.templYrec_ = theClusterParam.templSigmaX_ = theClusterParam.templSigmaY_ = nonsense;
@@ -307,8 +316,17 @@ PixelCPEClusterRepair::callTempReco2D( DetParam const & theDetParam,
    std::vector<std::pair<int, int> > zeropix;
    int nypix =0, nxpix = 0;
    //
+   float cotalpha = theClusterParam.cotalpha;
+   float cotbeta = theClusterParam.cotbeta;
+   const SiPixelTemplate * tableTempl = nullptr;
+   if ( templateTable_ ) {
+      templateTable_->binCenter(cotalpha, cotbeta);
+      tableTempl = templateTable_->find(ID, cotalpha, cotbeta, locBz, locBx);
+   }
+   SiPixelTemplate templ = tableTempl ? SiPixelTemplate(*tableTempl) : SiPixelTemplate(thePixelTemp_);
+   //
    theClusterParam.ierr =
-   PixelTempReco2D( ID, theClusterParam.cotalpha, theClusterParam.cotbeta,
+   PixelTempReco2D( ID, cotalpha, cotbeta,
                    locBz, locBx,
                    clusterPayload,
                    templ,
@@ -15,6 +15,7 @@
 
 // The template header files
 #include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateReco.h"
+#include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateTable.h"
 
 // Commented for now (3/10/17) until we figure out how to resuscitate 2D template splitter
 /// #include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateSplit.h"
@@ -93,6 +94,16 @@ PixelCPETemplateReco::PixelCPETemplateReco(edm::ParameterSet const & conf,
    
    UseClusterSplitter_ = conf.getParameter<bool>("UseClusterSplitter");
    
+   // Interpolated templates taken from a table binned in cot(alpha), cot(beta): faster, but
+   // the angles are moved to the center of their bin (see test/TemplateTableValidation.cc)
+   if ( conf.existsAs<bool>("UseTemplateTable") && conf.getParameter<bool>("UseTemplateTable") )
+   {
+      templateTable_ = std::make_unique<SiPixelTemplateTable>(thePixelTemp_,
+                                                              conf.getParameter<double>("TemplateTableCotAlphaStep"),
+                                                              conf.getParameter<double>("TemplateTableCotBetaStep"),
+                                                              conf.getParameter<unsigned int>("TemplateTableMaxEntries"));
+   }
+   
 }
 
 //-----------------------------------------------------------------------------
@@ -141,8 +152,6 @@ PixelCPETemplateReco::localPosition(DetParam const & theDetParam, ClusterParam &
    }
    //cout << "PixelCPETemplateReco : ID = " << ID << endl;
    
-   SiPixelTemplate templ(thePixelTemp_);
-   
    // Preparing to retrieve ADC counts from the SiPixeltheClusterParam.theCluster->  In the cluster,
    // we have the following:
    //   int minPixelRow(); // Minimum pixel index in the x direction (low edge).
@@ -242,8 +251,17 @@ PixelCPETemplateReco::localPosition(DetParam const & theDetParam, ClusterParam &
    float locBz = theDetParam.bz;
    float locBx = theDetParam.bx;
    
+   float cotalpha = theClusterParam.cotalpha;
+   float cotbeta = theClusterParam.cotbeta;
+   const SiPixelTemplate * tableTempl = nullptr;
+   if ( templateTable_ ) {
+      templateTable_->binCenter(cotalpha, cotbeta);
+      tableTempl = templateTable_->find(ID, cotalpha, cotbeta, locBz, locBx);
+   }
+   SiPixelTemplate templ = tableTempl ? SiPixelTemplate(*tableTempl) : SiPixelTemplate(thePixelTemp_);
+   
    theClusterParam.ierr =
-   PixelTempReco2D( ID, theClusterParam.cotalpha, theClusterParam.cotbeta,
+   PixelTempReco2D( ID, cotalpha, cotbeta,
                    locBz, locBx,
                    clusterPayload,
                    templ,
@@ -0,0 +1,47 @@
+#include "RecoLocalTracker/SiPixelRecHits/interface/SiPixelTemplateTable.h"
+
+#include <cmath>
+
+namespace {
+   constexpr int idBits = 24;
+   constexpr int binBits = 18;
+   constexpr float maxBin = 1<<(binBits-1);
+
+   inline uint64_t sign(float x) {return x<0.f ? 0 : (x>0.f ? 2 : 1);}
+}
+
+SiPixelTemplateTable::SiPixelTemplateTable(const std::vector< SiPixelTemplateStore > & thePixelTemp, float cotAlphaStep, float cotBetaStep, unsigned int maxEntries) :
+   thePixelTemp_(thePixelTemp), cotAlphaStep_(cotAlphaStep), cotBetaStep_(cotBetaStep), maxEntries_(maxEntries), nEntries_(0) {}
+
+
+void SiPixelTemplateTable::binCenter(float & cotalpha, float & cotbeta) const
+{
+   cotalpha = (std::floor(cotalpha/cotAlphaStep_)+0.5f)*cotAlphaStep_;
+   cotbeta = (std::floor(cotbeta/cotBetaStep_)+0.5f)*cotBetaStep_;
+}
+
+
+const SiPixelTemplate * SiPixelTemplateTable::find(int id, float cotalpha, float cotbeta, float locBz, float locBx) const
+{
+   float ia = std::floor(cotalpha/cotAlphaStep_);
+   float ib = std::floor(cotbeta/cotBetaStep_);
+   // the interpolation depends on the signs of the field components only
+   if (id<0 || id>=(1<<idBits) || !(std::abs(ia)<maxBin) || !(std::abs(ib)<maxBin)) return nullptr;
+
+   uint64_t key = uint64_t(id);
+   key = (key<<binBits) | uint64_t(int(ia)+int(maxBin));
+   key = (key<<binBits) | uint64_t(int(ib)+int(maxBin));
+   key = (key<<2) | sign(locBz);
+   key = (key<<2) | sign(locBx);
+
+   auto it = table_.find(key);
+   if (it!=table_.end()) return &it->second;
+   if (nEntries_>=maxEntries_) return nullptr;
+
+   // another thread may insert the same entry meanwhile: both are identical, the first one is kept
+   SiPixelTemplate templ(thePixelTemp_);
+   templ.interpolate(id, cotalpha, cotbeta, locBz, locBx);
+   auto ret = table_.insert(std::make_pair(key,templ));
+   if (ret.second) ++nEntries_;
+   return &ret.first->second;
+}
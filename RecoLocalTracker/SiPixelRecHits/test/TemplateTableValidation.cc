@@ -0,0 +1,117 @@
+// Compare the template CPE using the table of interpolated templates (UseTemplateTable)
+// to the full template reconstruction, on the pixel hits of refitted tracks:
+// residuals to the combined (unbiased) track state for both, and their difference.
+
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "DataFormats/Common/interface/Handle.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "CommonTools/UtilAlgos/interface/TFileService.h"
+
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
+#include "Geometry/Records/interface/TrackerDigiGeometryRecord.h"
+#include "Geometry/TrackerGeometryBuilder/interface/TrackerGeometry.h"
+#include "RecoLocalTracker/ClusterParameterEstimator/interface/PixelClusterParameterEstimator.h"
+#include "RecoLocalTracker/Records/interface/TkPixelCPERecord.h"
+#include "TrackingTools/PatternTools/interface/TrajTrackAssociation.h"
+#include "TrackingTools/TrackFitters/interface/TrajectoryStateCombiner.h"
+
+#include "TH1F.h"
+
+class TemplateTableValidation : public edm::EDAnalyzer {
+ public:
+  explicit TemplateTableValidation(const edm::ParameterSet& pset) :
+    trajTrackToken_(consumes<TrajTrackAssociationCollection>(pset.getParameter<edm::InputTag>("trajectoryInput"))),
+    fullCPEName_(pset.getParameter<std::string>("fullCPE")),
+    tableCPEName_(pset.getParameter<std::string>("tableCPE"))
+  {
+    edm::Service<TFileService> fs;
+    const char * part[2] = {"BPix","FPix"};
+    for (int i=0; i<2; ++i) {
+      std::string p(part[i]);
+      hResXFull_[i] = fs->make<TH1F>(("resXFull"+p).c_str(), ("x residual, full template reco, "+p+";#mum").c_str(), 200, -100., 100.);
+      hResYFull_[i] = fs->make<TH1F>(("resYFull"+p).c_str(), ("y residual, full template reco, "+p+";#mum").c_str(), 200, -200., 200.);
+      hResXTable_[i] = fs->make<TH1F>(("resXTable"+p).c_str(), ("x residual, template table, "+p+";#mum").c_str(), 200, -100., 100.);
+      hResYTable_[i] = fs->make<TH1F>(("resYTable"+p).c_str(), ("y residual, template table, "+p+";#mum").c_str(), 200, -200., 200.);
+      hDiffX_[i] = fs->make<TH1F>(("diffX"+p).c_str(), ("x table - full, "+p+";#mum").c_str(), 200, -10., 10.);
+      hDiffY_[i] = fs->make<TH1F>(("diffY"+p).c_str(), ("y table - full, "+p+";#mum").c_str(), 200, -20., 20.);
+      hDiffErrX_[i] = fs->make<TH1F>(("diffErrX"+p).c_str(), ("#sigma_{x} table - full, "+p+";#mum").c_str(), 200, -5., 5.);
+      hDiffErrY_[i] = fs->make<TH1F>(("diffErrY"+p).c_str(), ("#sigma_{y} table - full, "+p+";#mum").c_str(), 200, -10., 10.);
+    }
+  }
+
+  void analyze(const edm::Event& event, const edm::EventSetup& setup) override {
+    constexpr float cmToMicrons = 1.e4;
+
+    edm::ESHandle<PixelClusterParameterEstimator> fullCPE, tableCPE;
+    setup.get<TkPixelCPERecord>().get(fullCPEName_, fullCPE);
+    setup.get<TkPixelCPERecord>().get(tableCPEName_, tableCPE);
+    edm::ESHandle<TrackerGeometry> geom;
+    setup.get<TrackerDigiGeometryRecord>().get(geom);
+
+    edm::Handle<TrajTrackAssociationCollection> trajTracks;
+    event.getByToken(trajTrackToken_, trajTracks);
+
+    TrajectoryStateCombiner combiner;
+    for (auto const & tt : *trajTracks) {
+      for (auto const & tm : tt.key->measurements()) {
+	if (!tm.updatedState().isValid()) continue;
+	auto const & hit = tm.recHit();
+	if (!hit->isValid() || hit->geographicalId().det() != DetId::Tracker) continue;
+	auto subdet = hit->geographicalId().subdetId();
+	if (subdet != PixelSubdetector::PixelBarrel && subdet != PixelSubdetector::PixelEndcap) continue;
+	auto const * pixhit = dynamic_cast<const SiPixelRecHit*>(hit->hit());
+	if (pixhit == nullptr || pixhit->cluster().isNull()) continue;
+
+	auto tsos = combiner(tm.forwardPredictedState(), tm.backwardPredictedState());
+	if (!tsos.isValid()) continue;
+	auto const & det = *geom->idToDetUnit(hit->geographicalId());
+	auto const & cluster = *pixhit->cluster();
+
+	auto full = fullCPE->localParameters(cluster, det, tsos);
+	auto table = tableCPE->localParameters(cluster, det, tsos);
+	auto const & tp = tsos.localPosition();
+
+	int i = subdet == PixelSubdetector::PixelBarrel ? 0 : 1;
+	hResXFull_[i]->Fill(cmToMicrons*(full.first.x()-tp.x()));
+	hResYFull_[i]->Fill(cmToMicrons*(full.first.y()-tp.y()));
+	hResXTable_[i]->Fill(cmToMicrons*(table.first.x()-tp.x()));
+	hResYTable_[i]->Fill(cmToMicrons*(table.first.y()-tp.y()));
+	hDiffX_[i]->Fill(cmToMicrons*(table.first.x()-full.first.x()));
+	hDiffY_[i]->Fill(cmToMicrons*(table.first.y()-full.first.y()));
+	hDiffErrX_[i]->Fill(cmToMicrons*(std::sqrt(table.second.xx())-std::sqrt(full.second.xx())));
+	hDiffErrY_[i]->Fill(cmToMicrons*(std::sqrt(table.second.yy())-std::sqrt(full.second.yy())));
+      }
+    }
+  }
+
+  void endJob() override {
+    const char * part[2] = {"BPix","FPix"};
+    for (int i=0; i<2; ++i)
+      std::cout << part[i] << " residual rms (um), full/table: x "
+		<< hResXFull_[i]->GetRMS() << "/" << hResXTable_[i]->GetRMS() << " y "
+		<< hResYFull_[i]->GetRMS() << "/" << hResYTable_[i]->GetRMS()
+		<< ", table-full rms: x " << hDiffX_[i]->GetRMS() << " y " << hDiffY_[i]->GetRMS() << std::endl;
+  }
+
+private:
+  edm::EDGetTokenT<TrajTrackAssociationCollection> trajTrackToken_;
+  std::string fullCPEName_, tableCPEName_;
+  TH1F *hResXFull_[2], *hResYFull_[2], *hResXTable_[2], *hResYTable_[2];
+  TH1F *hDiffX_[2], *hDiffY_[2], *hDiffErrX_[2], *hDiffErrY_[2];
+};
+
+// define this as a plug-in
+DEFINE_FWK_MODULE(TemplateTableValidation);
@@ -0,0 +1,48 @@
+#
+# compare the template CPE with the table of interpolated templates
+# (UseTemplateTable) to the full template reconstruction
+# on the pixel hits of refitted generalTracks (RECO input)
+#
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TemplateTable")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.load("Configuration.StandardSequences.GeometryRecoDB_cff")
+process.load("Configuration.StandardSequences.MagneticField_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+process.load("Configuration.StandardSequences.Reconstruction_cff")
+process.load("RecoTracker.TrackProducer.TrackRefitters_cff")
+
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2017_realistic', '')
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.source = cms.Source("PoolSource",
+  fileNames = cms.untracked.vstring(
+    'file:reco.root'
+  )
+)
+
+process.TFileService = cms.Service("TFileService",
+    fileName = cms.string('templateTable.root')
+)
+
+# the same template CPE, with the table
+process.templatesWithTable = process.templates.clone(
+    ComponentName = 'PixelCPETemplateRecoWithTable',
+    UseTemplateTable = True
+)
+
+process.analysis = cms.EDAnalyzer("TemplateTableValidation",
+    trajectoryInput = cms.InputTag("TrackRefitter"),
+    fullCPE = cms.string("PixelCPETemplateReco"),
+    tableCPE = cms.string("PixelCPETemplateRecoWithTable"),
+)
+
+#process.Timing = cms.Service("Timing")
+
+process.p = cms.Path(process.MeasurementTrackerEvent*process.TrackRefitter*process.analysis)
@@ -64,6 +64,7 @@ class StripClusterizerAlgorithm {
   virtual Det stripByStripBegin(uint32_t id)const  = 0;
 
   virtual void addFed(Det const & det, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out)  const {}
+  virtual void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out)  const {}
   virtual void stripByStripAdd(State & state, uint16_t strip, uint8_t adc, std::vector<SiStripCluster>& out)  const{}
   virtual void stripByStripEnd(State & state, std::vector<SiStripCluster>& out)  const {}
 
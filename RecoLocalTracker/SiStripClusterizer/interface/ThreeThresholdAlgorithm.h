@@ -20,7 +20,7 @@ class ThreeThresholdAlgorithm final : public StripClusterizerAlgorithm {
   void stripByStripAdd(State & state, uint16_t strip, uint8_t adc, std::vector<SiStripCluster>& out) const override;
   void stripByStripEnd(State & state, std::vector<SiStripCluster>& out) const override;
 
-  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const {
+  void addFed(State & state, sistrip::FEDZSChannelUnpacker & unpacker, uint16_t ipair, std::vector<SiStripCluster>& out) const override {
     while (unpacker.hasData()) {
       stripByStripAdd(state,unpacker.sampleNumber()+ipair*256,unpacker.adc(),out);
       unpacker++;
@@ -31,6 +31,10 @@
 #include <atomic>
 #include <mutex>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
 #include "FWCore/Utilities/interface/GCC11Compatibility.h"
 
 
@@ -121,6 +125,14 @@ namespace {
     ~ClusterFiller() override { printStat();}
     
     void fill(StripClusterizerAlgorithm::output_t::TSFastFiller & record) override;
+
+    // unpack and cluster one det into a TSFastFiller or a std::vector<SiStripCluster>,
+    // using the given raw processing algorithms (not thread safe, one per concurrent task)
+    template<typename OUT>
+    bool fillDet(uint32_t idet, OUT & record, SiStripRawProcessingAlgorithms & algos);
+
+    // create the FEDBuffer of fedId if not done yet (thread safe)
+    sistrip::FEDBuffer * buffer(uint16_t fedId);
     
   private:
     
@@ -192,7 +204,10 @@ class SiStripClusterizerFromRaw final : public edm::stream::EDProducer<>  {
     cabling_(nullptr),
     clusterizer_(StripClusterizerAlgorithmFactory::create(conf.getParameter<edm::ParameterSet>("Clusterizer"))),
     rawAlgos_(SiStripRawProcessingFactory::create(conf.getParameter<edm::ParameterSet>("Algorithms"))),
-    doAPVEmulatorCheck_(conf.existsAs<bool>("DoAPVEmulatorCheck") ? conf.getParameter<bool>("DoAPVEmulatorCheck") : true)
+    algorithmsPSet_(conf.getParameter<edm::ParameterSet>("Algorithms")),
+    doAPVEmulatorCheck_(conf.existsAs<bool>("DoAPVEmulatorCheck") ? conf.getParameter<bool>("DoAPVEmulatorCheck") : true),
+    detsPerTask_(conf.existsAs<unsigned int>("detsPerTask") ? conf.getParameter<unsigned int>("detsPerTask") : 0),
+    nEvents_(0)
       {
 	productToken_ = consumes<FEDRawDataCollection>(conf.getParameter<edm::InputTag>("ProductLabel"));
 	produces< edmNew::DetSetVector<SiStripCluster> > ();
@@ -229,7 +244,8 @@ class SiStripClusterizerFromRaw final : public edm::stream::EDProducer<>  {
 
 
     if (!onDemand) {
-      run(*rawData, *output);
+      if (detsPerTask_>0) runConcurrently(*rawData, es, *output);
+      else run(*rawData, *output);
       output->shrink_to_fit();   
       COUT << output->dataSize() << " clusters from " 
 	   << output->size()     << " modules" 
@@ -246,6 +262,9 @@ private:
 
   void run(const FEDRawDataCollection& rawColl, edmNew::DetSetVector<SiStripCluster> & output);
 
+  // same output as run: FEDs unpacked and dets clustered in TBB tasks, merged in det order
+  void runConcurrently(const FEDRawDataCollection& rawColl, const edm::EventSetup& es, edmNew::DetSetVector<SiStripCluster> & output);
+
 
  private:
 
@@ -259,9 +278,22 @@ private:
   std::unique_ptr<SiStripRawProcessingAlgorithms> rawAlgos_;
   
   
+  // raw processing algorithms of the concurrent tasks (they keep per-APV state)
+  struct TaskAlgorithms {
+    std::unique_ptr<SiStripRawProcessingAlgorithms> algos;
+    unsigned long long event=0; // initialized for this event
+  };
+  const edm::ParameterSet algorithmsPSet_;
+  tbb::enumerable_thread_specific<TaskAlgorithms> taskAlgos_;
+  
   // March 2012: add flag for disabling APVe check in configuration
   bool doAPVEmulatorCheck_; 
 
+  // dets per concurrent task, 0 for the serial loop
+  const unsigned int detsPerTask_;
+  unsigned long long nEvents_;
+  std::vector<std::vector<SiStripCluster>> detClusters_;
+
 };
 
 #include "FWCore/Framework/interface/MakerMacros.h"
@@ -295,6 +327,56 @@ void SiStripClusterizerFromRaw::run(const FEDRawDataCollection& rawColl,
   } // end loop over dets
 }
 
+void SiStripClusterizerFromRaw::runConcurrently(const FEDRawDataCollection& rawColl,
+						const edm::EventSetup& es,
+						edmNew::DetSetVector<SiStripCluster> & output) {
+
+  ClusterFiller filler(rawColl, *clusterizer_, *rawAlgos_, doAPVEmulatorCheck_);
+  ++nEvents_;
+
+  // unpack the FEDs
+  tbb::parallel_for(sistrip::FED_ID_MIN, uint16_t(sistrip::FED_ID_MAX+1), [&](uint16_t fedId) {
+      if (rawColl.FEDData(fedId).size()) filler.buffer(fedId);
+    });
+
+  // cluster ranges of dets in per-det buffers
+  auto const & detIds = clusterizer_->allDetIds();
+  detClusters_.resize(detIds.size());
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, detIds.size(), detsPerTask_),
+		    [&](const tbb::blocked_range<unsigned int> & r) {
+      auto & task = taskAlgos_.local();
+      if (!task.algos) task.algos.reset(SiStripRawProcessingFactory::create(algorithmsPSet_).release());
+      if (task.event!=nEvents_) { task.algos->initialize(es); task.event=nEvents_;}
+      for (auto i=r.begin(); i<r.end(); ++i) {
+	detClusters_[i].clear();
+	filler.fillDet(detIds[i], detClusters_[i], *task.algos);
+      }
+    });
+
+  // merge, as the serial loop does
+  for (unsigned int i=0; i<detIds.size(); ++i) {
+    StripClusterizerAlgorithm::output_t::TSFastFiller record(output, detIds[i]);
+    for (auto & cl : detClusters_[i]) record.push_back(std::move(cl));
+    if (record.full()) {
+      edm::LogError(sistrip::mlRawToCluster_) << "too many Sistrip Clusters to fit space allocated for OnDemand for " << record.id() << ' ' << record.size();
+      record.abort();
+    }
+    if(record.empty()) record.abort();
+  }
+}
+
+sistrip::FEDBuffer * ClusterFiller::buffer(uint16_t fedId) {
+  sistrip::FEDBuffer * buffer = done[fedId];
+  if (!buffer) { 
+    buffer = fillBuffer(fedId, rawColl).release();
+    if (!buffer) return nullptr;
+    sistrip::FEDBuffer * exp = nullptr;
+    if (done[fedId].compare_exchange_strong(exp, buffer)) buffers[fedId].reset(buffer);
+    else { delete buffer; buffer = done[fedId]; }
+  }
+  return buffer;
+}
+
 void ClusterFiller::fill(StripClusterizerAlgorithm::output_t::TSFastFiller & record) {
 try { // edmNew::CapacityExaustedException
   incReady();
@@ -303,8 +385,32 @@ try { // edmNew::CapacityExaustedException
 
   COUT << "filling " << idet << std::endl;
 
+  if (!fillDet(idet, record, rawAlgos)) return;
+
+  incAct();
+ 
+  if (record.full()) {
+    edm::LogError(sistrip::mlRawToCluster_) << "too many Sistrip Clusters to fit space allocated for OnDemand for " << record.id() << ' ' << record.size();
+    record.abort();
+    incAbrt();
+  }
+  
+  if(!record.empty()) incNoZ();
+
+  COUT << "filled " << record.size() << std::endl;
+  for ( auto const & cl : record ) COUT << cl.firstStrip() << ','<<  cl.amplitudes().size() << std::endl;
+  incClus(record.size());
+} catch (edmNew::CapacityExaustedException) {
+  edm::LogError(sistrip::mlRawToCluster_) << "too many Sistrip Clusters to fit space allocated for OnDemand";
+}  
+
+}
+
+template<typename OUT>
+bool ClusterFiller::fillDet(uint32_t idet, OUT & record, SiStripRawProcessingAlgorithms & rawAlgos) {
+
   auto const & det = clusterizer.stripByStripBegin(idet);
-  if (!det.valid()) return; 
+  if (!det.valid()) return false; 
   StripClusterizerAlgorithm::State state(det);
 
   incSet();
@@ -320,15 +426,8 @@ try { // edmNew::CapacityExaustedException
     
 
     // If Fed hasnt already been initialised, extract data and initialise
-    sistrip::FEDBuffer * buffer = done[fedId];
-    if (!buffer) { 
-      buffer = fillBuffer(fedId, rawColl).release();
-      if (!buffer) { continue;}
-      sistrip::FEDBuffer * exp = nullptr;
-      if (done[fedId].compare_exchange_strong(exp, buffer)) buffers[fedId].reset(buffer);
-      else { delete buffer; buffer = done[fedId]; }
-    }
-    assert(buffer);
+    sistrip::FEDBuffer * buffer = this->buffer(fedId);
+    if (!buffer) { continue;}
 
     // check channel
     const uint8_t fedCh = conn->fedCh();
@@ -460,24 +559,6 @@ try { // edmNew::CapacityExaustedException
     
   } // end loop over conn
   clusterizer.stripByStripEnd(state,record);
-  
-  incAct();
- 
-  if (record.full()) {
-    edm::LogError(sistrip::mlRawToCluster_) << "too many Sistrip Clusters to fit space allocated for OnDemand for " << record.id() << ' ' << record.size();
-    record.abort();
-    incAbrt();
-  }
-  
-  if(!record.empty()) incNoZ();
-
-  COUT << "filled " << record.size() << std::endl;
-  for ( auto const & cl : record ) COUT << cl.firstStrip() << ','<<  cl.amplitudes().size() << std::endl;
-  incClus(record.size());
-} catch (edmNew::CapacityExaustedException) {
-  edm::LogError(sistrip::mlRawToCluster_) << "too many Sistrip Clusters to fit space allocated for OnDemand";
-}  
 
+  return true;
 }
-
-
@@ -7,5 +7,7 @@ SiStripClustersFromRawFacility = cms.EDProducer("SiStripClusterizerFromRaw",
                                                 Clusterizer = DefaultClusterizer,
                                                 Algorithms = DefaultAlgorithms,
                                                 DoAPVEmulatorCheck = cms.bool(False),
+                                                # >0: unpack FEDs and cluster dets in concurrent tasks of detsPerTask dets (onDemand=False only)
+                                                detsPerTask = cms.uint32(0),
                                                 ProductLabel = cms.InputTag('rawDataCollector')
                                                 )
@@ -0,0 +1,58 @@
+# Run SiStripClusterizerFromRaw twice on the same RAW events, with the serial
+# loop over the dets (detsPerTask = 0) and with the FEDs unpacked and the dets
+# clustered in concurrent tasks (detsPerTask > 0), and check with
+# CompareClusters that the two DetSetVector<SiStripCluster> are identical.
+#
+#   cmsRun ClustersFromRawConcurrent_cfg.py inputFiles=file:raw.root maxEvents=100
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.StandardSequences.Eras import eras
+
+options = VarParsing('analysis')
+options.register('detsPerTask', 64, VarParsing.multiplicity.singleton, VarParsing.varType.int,
+                 "dets per concurrent task of the tested module")
+options.parseArguments()
+
+process = cms.Process("TEST",eras.Run2_2017)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+# threads for the concurrent tasks
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag,'auto:phase1_2017_realistic', '')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+
+from RecoLocalTracker.SiStripClusterizer.SiStripClustersFromRaw_cfi import SiStripClustersFromRawFacility
+process.clustersSerial = SiStripClustersFromRawFacility.clone(
+    detsPerTask = 0
+)
+process.clustersConcurrent = SiStripClustersFromRawFacility.clone(
+    detsPerTask = options.detsPerTask
+)
+
+# the digis are only read to print the dets that differ
+process.compareClusters = cms.EDAnalyzer("CompareClusters",
+    Clusters1 = cms.InputTag('clustersSerial'),
+    Clusters2 = cms.InputTag('clustersConcurrent'),
+    Digis = cms.InputTag('siStripDigis','ZeroSuppressed'),
+    FailOnDifference = cms.bool(True)
+)
+
+process.p = cms.Path(process.siStripDigis
+                     * process.clustersSerial
+                     * process.clustersConcurrent
+                     * process.compareClusters)
@@ -9,6 +9,8 @@
 #include "CalibTracker/Records/interface/SiStripGainRcd.h"
 #include "CalibTracker/Records/interface/SiStripQualityRcd.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -19,15 +21,19 @@ CompareClusters::
 CompareClusters(const edm::ParameterSet& conf) 
   : clusters1( conf.getParameter<edm::InputTag>("Clusters1")),
     clusters2( conf.getParameter<edm::InputTag>("Clusters2")),
-    digis( conf.getParameter<edm::InputTag>("Digis"))
+    digis( conf.getParameter<edm::InputTag>("Digis")),
+    failOnDifference( conf.existsAs<bool>("FailOnDifference") ? conf.getParameter<bool>("FailOnDifference") : false),
+    nEvents(0), nDifferent(0)
 {}
 
 void CompareClusters::
 analyze(const edm::Event& event, const edm::EventSetup& es) {
   event.getByLabel(clusters1, clusterHandle1);  if(!clusterHandle1.isValid()) throw cms::Exception("Input Not found") << clusters1;
   event.getByLabel(clusters2, clusterHandle2);  if(!clusterHandle2.isValid()) throw cms::Exception("Input Not found") << clusters2;
+  nEvents++;
   if( identicalDSV( *clusterHandle1, *clusterHandle2) ) 
     return;
+  nDifferent++;
 
   {//digi access
     event.getByLabel(digis, digiHandle);  if(!digiHandle.isValid()) throw cms::Exception("Input Not found") << digis;
@@ -56,6 +62,15 @@ analyze(const edm::Event& event, const edm::EventSetup& es) {
   return;
 }
 
+void CompareClusters::
+endJob() {
+  edm::LogPrint("CompareClusters") << nEvents << " events, " << nDifferent << " with different clusters in "
+				   << clusters1.label() << " and " << clusters2.label();
+  if( failOnDifference && nDifferent )
+    throw cms::Exception("Not Identical") << nDifferent << " events with different clusters in "
+					  << clusters1.label() << " and " << clusters2.label();
+}
+
 void CompareClusters::
 show( uint32_t id) {
   message << std::endl << "detId: " << id << std::endl;
@@ -26,6 +26,7 @@ class CompareClusters : public edm::EDAnalyzer {
  private:
   
   void analyze(const edm::Event&, const edm::EventSetup&);
+  void endJob();
 
   void show( uint32_t);
   std::string printDigis(uint32_t);
@@ -36,6 +37,8 @@ class CompareClusters : public edm::EDAnalyzer {
 
   std::stringstream message;
   edm::InputTag clusters1, clusters2, digis;
+  bool failOnDifference;
+  unsigned nEvents, nDifferent;
   edm::Handle<input_t> clusterHandle1, clusterHandle2;
 
   edm::Handle<edm::DetSetVector<SiStripDigi> > digiHandle;
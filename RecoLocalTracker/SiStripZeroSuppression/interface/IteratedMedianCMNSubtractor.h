@@ -11,6 +11,7 @@ class SiStripQuality;
 class IteratedMedianCMNSubtractor : public SiStripCommonModeNoiseSubtractor {
   
   friend class SiStripRawProcessingFactory;
+  friend class VectorizedCMNSubtractorTest;
   
  public:
   
@@ -0,0 +1,54 @@
+#ifndef RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_VECTORIZEDCMNSUBTRACTOR_H
+#define RECOLOCALTRACKER_SISTRIPZEROSUPPRESSION_VECTORIZEDCMNSUBTRACTOR_H
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripCommonModeNoiseSubtractor.h"
+
+#include "FWCore/Framework/interface/ESHandle.h"
+
+class SiStripNoises;
+class SiStripQuality;
+
+/*
+ * Median, Percentile and IteratedMedian common mode subtraction done on
+ * batches of APVs: the 128 strips of up to 8 APVs are transposed in a
+ * [strip][APV] block and sorted with a bitonic sorting network, whose
+ * compare-exchanges are min/max over the APV lanes (auto-vectorized).
+ * Strips excluded by the IteratedMedian (bad or above threshold) are
+ * replaced by a sentinel sorted at the end.
+ * The offsets, and hence the output, are the same as the ones of
+ * MedianCMNSubtractor, PercentileCMNSubtractor and IteratedMedianCMNSubtractor.
+ */
+class VectorizedCMNSubtractor : public SiStripCommonModeNoiseSubtractor {
+
+  friend class SiStripRawProcessingFactory;
+  friend class VectorizedCMNSubtractorTest;
+
+ public:
+
+  enum Mode { Median, Percentile, IteratedMedian };
+
+  void init(const edm::EventSetup& es) override;
+  void subtract(const uint32_t&,const uint16_t&, std::vector<int16_t>&) override;
+  void subtract(const uint32_t&,const uint16_t&, std::vector<float>&) override;
+
+ private:
+
+  template<typename T> void subtract_(const uint32_t&, const uint16_t&, std::vector<T>&);
+  template<typename T> void iteratedOffsets(const uint32_t&, const uint16_t&, const std::vector<T>&, unsigned int firstLane, unsigned int nLanes, float& offset, float* offsets);
+
+  VectorizedCMNSubtractor(Mode mode, double percentile, double sigma, int iterations) :
+    mode_(mode),
+    percentile_(percentile),
+    cut_to_avoid_signal_(sigma),
+    iterations_(iterations),
+    noise_cache_id(0),
+    quality_cache_id(0) {};
+
+  const Mode mode_;
+  double percentile_;
+  double cut_to_avoid_signal_;
+  int iterations_;
+  edm::ESHandle<SiStripNoises> noiseHandle;
+  edm::ESHandle<SiStripQuality> qualityHandle;
+  uint32_t noise_cache_id, quality_cache_id;
+};
+#endif
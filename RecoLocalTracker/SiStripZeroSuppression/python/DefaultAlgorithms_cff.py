@@ -9,6 +9,7 @@ DefaultAlgorithms = cms.PSet(
     ## Baseline finder ---------------------
     ## Supported CMN modes: Median, Percentile, IteratedMedian, TT6, FastLinear
     CommonModeNoiseSubtractionMode = cms.string('IteratedMedian'),     
+    VectorizedCMN = cms.bool(False),     ## APV-batched Median, Percentile, IteratedMedian (same output)
 
     #CutToAvoidSignal = cms.double(3.0), ## for TT6
     
@@ -3,6 +3,8 @@
 #include "CondFormats/DataRecord/interface/SiStripPedestalsRcd.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include <algorithm>
+
 void SiStripPedestalsSubtractor::init(const edm::EventSetup& es){
   uint32_t p_cache_id = es.get<SiStripPedestalsRcd>().cacheIdentifier();
   if(p_cache_id != peds_cache_id) {
@@ -24,24 +26,16 @@ subtract_(const uint32_t& id, const uint16_t& firstStrip, const input_t& input,
     SiStripPedestals::Range pedestalsRange = pedestalsHandle->getRange(id);
     pedestalsHandle->allPeds(pedestals, pedestalsRange);
 
-    typename input_t::const_iterator inDigi = input.begin();
-    std::vector<int>::const_iterator ped = pedestals.begin() + firstStrip;  
-    std::vector<int16_t>::iterator   outDigi = output.begin();
-
-    while( inDigi != input.end() ) {
-      
-      *outDigi = ( *ped > 895 )        
-	? eval(*inDigi) - *ped + 1024
-	: eval(*inDigi) - *ped;
-      
-      if(fedmode_ && *outDigi < 0) //FED bottoms out at 0
-	*outDigi=0;
-      
-      ++inDigi; 
-      ++ped; 
-      ++outDigi;
-    }
+    // branch-free loops over plain arrays, to be vectorized
+    const unsigned int n = input.size();
+    const int * ped = pedestals.data() + firstStrip;
+    int16_t * outDigi = output.data();
+    for (unsigned int i=0; i<n; ++i)
+      outDigi[i] = eval(input[i]) - ped[i] + ( ped[i] > 895 ? 1024 : 0 );
 
+    if(fedmode_) //FED bottoms out at 0
+      for (unsigned int i=0; i<n; ++i)
+	outDigi[i] = std::max(outDigi[i], int16_t(0));
 
   } catch(cms::Exception& e){
     edm::LogError("SiStripPedestalsSubtractor")  
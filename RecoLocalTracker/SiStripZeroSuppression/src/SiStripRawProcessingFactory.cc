@@ -9,6 +9,7 @@
 #include "RecoLocalTracker/SiStripZeroSuppression/interface/IteratedMedianCMNSubtractor.h"
 #include "RecoLocalTracker/SiStripZeroSuppression/interface/FastLinearCMNSubtractor.h"
 #include "RecoLocalTracker/SiStripZeroSuppression/interface/TT6CMNSubtractor.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/VectorizedCMNSubtractor.h"
 
 
 std::auto_ptr<SiStripRawProcessingAlgorithms> SiStripRawProcessingFactory::
@@ -43,6 +44,19 @@ std::auto_ptr<SiStripCommonModeNoiseSubtractor> SiStripRawProcessingFactory::
 create_SubtractorCMN(const edm::ParameterSet& conf) {
   std::string mode = conf.getParameter<std::string>("CommonModeNoiseSubtractionMode");
 
+  // APV-batched sorting network version of Median, Percentile and IteratedMedian (same output)
+  if ( conf.exists("VectorizedCMN") && conf.getParameter<bool>("VectorizedCMN") ) {
+    if ( mode == "Median")
+      return std::auto_ptr<SiStripCommonModeNoiseSubtractor>( new VectorizedCMNSubtractor(VectorizedCMNSubtractor::Median,0,0,0) );
+    if ( mode == "Percentile")
+      return std::auto_ptr<SiStripCommonModeNoiseSubtractor>( new VectorizedCMNSubtractor(VectorizedCMNSubtractor::Percentile,
+													  conf.getParameter<double>("Percentile"),0,0) );
+    if ( mode == "IteratedMedian")
+      return std::auto_ptr<SiStripCommonModeNoiseSubtractor>( new VectorizedCMNSubtractor(VectorizedCMNSubtractor::IteratedMedian,0,
+													  conf.getParameter<double>("CutToAvoidSignal"),
+													  conf.getParameter<int>("Iterations")) );
+  }
+
   if ( mode == "Median")
     return std::auto_ptr<SiStripCommonModeNoiseSubtractor>( new MedianCMNSubtractor() );
 
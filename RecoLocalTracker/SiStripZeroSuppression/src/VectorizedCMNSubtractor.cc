@@ -0,0 +1,180 @@
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/VectorizedCMNSubtractor.h"
+
+#include "CondFormats/SiStripObjects/interface/SiStripNoises.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripQuality.h"
+#include "CondFormats/DataRecord/interface/SiStripNoisesRcd.h"
+#include "CalibTracker/Records/interface/SiStripQualityRcd.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+  constexpr unsigned int nStrips = 128;
+  constexpr unsigned int nLanes = 8; // APVs processed together
+
+  // nLanes APVs, stored as 16-byte (SSE) vectors of strips
+  template<typename T>
+  struct APVBlock {
+    static constexpr unsigned int width = 16/sizeof(T);
+    static constexpr unsigned int nVec = nLanes/width;
+    typedef T __attribute__( ( vector_size( 16 ) ) ) V;
+    V v[nStrips][nVec];
+    T & at(unsigned int s, unsigned int l) { return v[s][l/width][l%width];}
+    T at(unsigned int s, unsigned int l) const { return v[s][l/width][l%width];}
+  };
+
+  template<typename V, unsigned int N>
+  inline void compareExchange(V (&lo)[N], V (&hi)[N]) {
+    for (unsigned int k=0; k<N; ++k) {
+      V a = lo[k], b = hi[k];
+      auto less = a<b;
+      lo[k] = less ? a : b;
+      hi[k] = less ? b : a;
+    }
+  }
+
+  // ascending bitonic sort of each lane
+  template<typename T>
+  void bitonicSort(APVBlock<T> & b) {
+    for (unsigned int k=2; k<=nStrips; k*=2)
+      for (unsigned int j=k/2; j>0; j/=2)
+	for (unsigned int i0=0; i0<nStrips; i0+=2*j)
+	  for (unsigned int i=i0; i<i0+j; ++i) {
+	    if ((i&k)==0) compareExchange(b.v[i],b.v[i+j]);
+	    else compareExchange(b.v[i+j],b.v[i]);
+	  }
+  }
+
+  // as SiStripCommonModeNoiseSubtractor::median on the n first sorted values of lane l
+  template<typename T>
+  inline float sortedMedian(APVBlock<T> const & s, unsigned int n, unsigned int l) {
+    auto mid = n/2;
+    if (n & 1) return s.at(mid,l);
+    return ( s.at(mid-1,l) + s.at(mid,l) ) / 2.;
+  }
+
+}
+
+
+void VectorizedCMNSubtractor::init(const edm::EventSetup& es){
+  if (mode_!=IteratedMedian) return;
+  uint32_t n_cache_id = es.get<SiStripNoisesRcd>().cacheIdentifier();
+  uint32_t q_cache_id = es.get<SiStripQualityRcd>().cacheIdentifier();
+
+  if(n_cache_id != noise_cache_id) {
+    es.get<SiStripNoisesRcd>().get( noiseHandle );
+    noise_cache_id = n_cache_id;
+  }
+  if(q_cache_id != quality_cache_id) {
+    es.get<SiStripQualityRcd>().get( qualityHandle );
+    quality_cache_id = q_cache_id;
+  }
+}
+
+void VectorizedCMNSubtractor::subtract(const uint32_t& detId, const uint16_t& firstAPV, std::vector<int16_t>& digis) {subtract_(detId, firstAPV, digis);}
+void VectorizedCMNSubtractor::subtract(const uint32_t& detId, const uint16_t& firstAPV, std::vector<float>& digis) {subtract_(detId, firstAPV, digis);}
+
+template<typename T>
+inline
+void VectorizedCMNSubtractor::
+subtract_(const uint32_t& detId, const uint16_t& firstAPV, std::vector<T>& digis) {
+
+  _vmedians.clear();
+
+  const unsigned int nAPVs = digis.size()/nStrips;
+  const unsigned int iPercentile = std::min(int(nStrips*percentile_/100.0), int(nStrips-1));
+  float offsets[nLanes];
+  float offset = 0; // IteratedMedian: offset of the previous APV, kept for APVs without good strips
+  APVBlock<T> block;
+
+  for (unsigned int a0=0; a0<nAPVs; a0+=nLanes) {
+    const unsigned int n = std::min(nLanes, nAPVs-a0);
+
+    if (mode_==IteratedMedian) {
+      iteratedOffsets(detId, firstAPV, digis, a0, n, offset, offsets);
+    } else {
+      for (unsigned int l=0; l<nLanes; ++l) {
+	T const * in = digis.data()+(a0+l)*nStrips;
+	for (unsigned int s=0; s<nStrips; ++s) block.at(s,l) = l<n ? in[s] : T(0);
+      }
+      bitonicSort(block);
+      for (unsigned int l=0; l<n; ++l)
+	offsets[l] = mode_==Median ? sortedMedian(block,nStrips,l) : float(block.at(iPercentile,l));
+    }
+
+    for (unsigned int l=0; l<n; ++l) {
+      _vmedians.push_back(std::pair<short,float>(a0+l+firstAPV,offsets[l]));
+      const float off = offsets[l];
+      T * strip = digis.data()+(a0+l)*nStrips;
+      for (unsigned int s=0; s<nStrips; ++s) strip[s] = static_cast<T>(strip[s]-off);
+    }
+  }
+}
+
+template<typename T>
+void VectorizedCMNSubtractor::
+iteratedOffsets(const uint32_t& detId, const uint16_t& firstAPV, const std::vector<T>& digis,
+		unsigned int a0, unsigned int n, float& offset, float* offsets) {
+
+  constexpr float removed = std::numeric_limits<float>::max();
+
+  SiStripNoises::Range detNoiseRange = noiseHandle->getRange(detId);
+  SiStripQuality::Range detQualityRange = qualityHandle->getRange(detId);
+
+  // good strips and their noises, removed strips set to the sentinel
+  APVBlock<float> values, sorted;
+  float noises[nStrips][nLanes];
+  unsigned int count[nLanes], firstCount[nLanes];
+  for (unsigned int l=0; l<nLanes; ++l) {
+    count[l] = 0;
+    uint16_t APV = firstAPV+a0+l;
+    for (unsigned int s=0; s<nStrips; ++s) {
+      uint16_t istrip = APV*nStrips+s;
+      values.at(s,l) = removed; noises[s][l] = 0;
+      if (l>=n || qualityHandle->IsStripBad(detQualityRange,istrip)) continue;
+      values.at(s,l) = digis[(a0+l)*nStrips+s];
+      noises[s][l] = noiseHandle->getNoiseFast(istrip,detNoiseRange);
+      ++count[l];
+    }
+    firstCount[l] = count[l];
+  }
+
+  // first iteration on all good strips
+  float off[nLanes];
+  bool active[nLanes];
+  sorted = values;
+  bitonicSort(sorted);
+  for (unsigned int l=0; l<n; ++l) {
+    active[l] = count[l]>0;
+    if (active[l]) off[l] = sortedMedian(sorted,count[l],l);
+  }
+
+  // next iterations: remove strips over threshold and recompute on the remaining ones
+  for (int ii=0; ii<iterations_-1; ++ii) {
+    for (unsigned int s=0; s<nStrips; ++s)
+      for (unsigned int l=0; l<n; ++l) {
+	if (!active[l] || values.at(s,l)==removed) continue;
+	if (values.at(s,l)-off[l] > cut_to_avoid_signal_*noises[s][l]) {
+	  values.at(s,l) = removed;
+	  --count[l];
+	}
+      }
+    bool any = false;
+    for (unsigned int l=0; l<n; ++l) {
+      active[l] = active[l] && count[l]>0;
+      any |= active[l];
+    }
+    if (!any) break;
+    sorted = values;
+    bitonicSort(sorted);
+    for (unsigned int l=0; l<n; ++l)
+      if (active[l]) off[l] = sortedMedian(sorted,count[l],l);
+  }
+
+  // APVs without good strips keep the offset of the previous one
+  for (unsigned int l=0; l<n; ++l) {
+    if (firstCount[l]>0) offset = off[l];
+    offsets[l] = offset;
+  }
+}
@@ -0,0 +1,140 @@
+// Check that VectorizedCMNSubtractor (VectorizedCMN = True) gives exactly the
+// same digis and common modes as MedianCMNSubtractor, PercentileCMNSubtractor
+// and IteratedMedianCMNSubtractor.  The modules have 2, 4 or 6 APVs of random
+// int16 and float digis, with some signal, including saturated APVs, APVs
+// with half of their strips saturated, flat APVs, and for the IteratedMedian
+// random bad strips and fully bad APVs (which keep the offset of the previous
+// APV).
+
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripRawProcessingFactory.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/SiStripCommonModeNoiseSubtractor.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/IteratedMedianCMNSubtractor.h"
+#include "RecoLocalTracker/SiStripZeroSuppression/interface/VectorizedCMNSubtractor.h"
+#include "CondFormats/SiStripObjects/interface/SiStripNoises.h"
+#include "CalibFormats/SiStripObjects/interface/SiStripQuality.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// sets the conditions otherwise taken from the EventSetup in init()
+class VectorizedCMNSubtractorTest {
+public:
+  template<typename S>
+  static void setConditions(SiStripCommonModeNoiseSubtractor & subtractor,
+			    const SiStripNoises & noises, const SiStripQuality & quality) {
+    auto & s = dynamic_cast<S&>(subtractor);
+    s.noiseHandle = edm::ESHandle<SiStripNoises>(&noises);
+    s.qualityHandle = edm::ESHandle<SiStripQuality>(&quality);
+  }
+};
+
+namespace {
+
+  constexpr unsigned int nDets = 60;
+
+  edm::ParameterSet config(const std::string & mode, bool vectorized) {
+    edm::ParameterSet conf;
+    conf.addParameter<std::string>("CommonModeNoiseSubtractionMode",mode);
+    conf.addParameter<bool>("VectorizedCMN",vectorized);
+    conf.addParameter<double>("Percentile",25.);
+    conf.addParameter<double>("CutToAvoidSignal",3.);
+    conf.addParameter<int>("Iterations",3);
+    return conf;
+  }
+
+  unsigned int nAPVs(uint32_t detId) { return 2+2*(detId%3); }
+
+  // digis and common modes, compared bit by bit
+  template<typename T>
+  bool same(SiStripCommonModeNoiseSubtractor & vectorized, SiStripCommonModeNoiseSubtractor & scalar,
+	    uint32_t detId, uint16_t firstAPV, std::vector<T> digis) {
+    auto reference = digis;
+    vectorized.subtract(detId,firstAPV,digis);
+    scalar.subtract(detId,firstAPV,reference);
+    bool ok = std::memcmp(digis.data(),reference.data(),digis.size()*sizeof(T))==0;
+    auto const & cm = vectorized.getAPVsCM();
+    auto const & cmReference = scalar.getAPVsCM();
+    ok &= cm.size()==cmReference.size();
+    for (unsigned int i=0; ok && i<cm.size(); ++i)
+      ok &= cm[i].first==cmReference[i].first && std::memcmp(&cm[i].second,&cmReference[i].second,sizeof(float))==0;
+    return ok;
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::normal_distribution<float> gauss(0.,1.);
+  std::uniform_real_distribution<float> flat(0.,1.);
+
+  // noises and bad strips: the first APV of every fifth module and the third
+  // APV of every seventh module are bad
+  SiStripNoises noises;
+  SiStripQuality quality;
+  for (uint32_t detId=1; detId<=nDets; ++detId) {
+    const unsigned int nStrips = 128*nAPVs(detId);
+    SiStripNoises::InputVector noiseVector;
+    for (unsigned int s=0; s<nStrips; ++s) noises.setData(2.f+3.f*flat(rng),noiseVector);
+    noises.put(detId,noiseVector);
+    SiStripBadStrip::InputVector bad;
+    if (detId%5==0) bad.push_back(quality.encode(0,128));
+    for (unsigned int s=128; s<nStrips; ++s) {
+      if (detId%7==0 && s==256) { bad.push_back(quality.encode(256,128)); s += 127; continue; }
+      if (flat(rng)<0.05f) bad.push_back(quality.encode(s,1));
+    }
+    quality.put(detId,bad);
+  }
+
+  const char * modes[3] = {"Median","Percentile","IteratedMedian"};
+  bool ok = true;
+  for (auto mode : modes) {
+    auto vectorized = SiStripRawProcessingFactory::create_SubtractorCMN(config(mode,true));
+    auto scalar = SiStripRawProcessingFactory::create_SubtractorCMN(config(mode,false));
+    assert(dynamic_cast<VectorizedCMNSubtractor*>(vectorized.get()));
+    if (std::string(mode)=="IteratedMedian") {
+      VectorizedCMNSubtractorTest::setConditions<VectorizedCMNSubtractor>(*vectorized,noises,quality);
+      VectorizedCMNSubtractorTest::setConditions<IteratedMedianCMNSubtractor>(*scalar,noises,quality);
+    }
+
+    unsigned int nDiff = 0, nTests = 0;
+    for (uint32_t detId=1; detId<=nDets; ++detId) {
+      for (unsigned int kind=0; kind<4; ++kind) {
+	const unsigned int n = nAPVs(detId);
+	std::vector<int16_t> digis(128*n);
+	std::vector<float> fdigis(128*n);
+	for (unsigned int a=0; a<n; ++a) {
+	  // 0: baseline with noise and signal, 1: saturated, 2: flat, 3: one strip in two saturated
+	  const unsigned int type = (kind+a)%4;
+	  const float baseline = 100.f+40.f*gauss(rng);
+	  for (unsigned int s=0; s<128; ++s) {
+	    float adc = baseline+3.f*gauss(rng);
+	    if (flat(rng)<0.05f) adc += 50.f+200.f*flat(rng);
+	    if (type==1 || (type==3 && s%2)) adc = 1023.f;
+	    if (type==2) adc = std::round(baseline);
+	    digis[128*a+s] = static_cast<int16_t>(std::lround(adc));
+	    fdigis[128*a+s] = type==2 ? 37.5f : adc;
+	  }
+	}
+	nDiff += !same(*vectorized,*scalar,detId,0,digis);
+	nDiff += !same(*vectorized,*scalar,detId,0,fdigis);
+	nTests += 2;
+	// modules of 2 APVs read as the second half of a 4-APV module
+	if (n==2 && detId<nDets) {
+	  nDiff += !same(*vectorized,*scalar,detId+1,2,digis);
+	  nDiff += !same(*vectorized,*scalar,detId+1,2,fdigis);
+	  nTests += 2;
+	}
+      }
+    }
+    std::cout << mode << ": " << nTests << " modules, " << nDiff << " differences" << std::endl;
+    ok &= nDiff==0;
+  }
+
+  assert(ok);
+  return ok ? 0 : 1;
+}
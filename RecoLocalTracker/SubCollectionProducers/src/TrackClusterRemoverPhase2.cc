@@ -200,14 +200,14 @@ namespace {
     }
 
 
-    auto removedPixelClusterMask= 
-      std::make_unique<PixelMaskContainer>(edm::RefProd<edmNew::DetSetVector<SiPixelCluster>>(pixelClusters),collectedPixels);      
     LogDebug("TrackClusterRemoverPhase2")<<"total pxl to skip: "<<std::count(collectedPixels.begin(),collectedPixels.end(),true);
+    auto removedPixelClusterMask= 
+      std::make_unique<PixelMaskContainer>(edm::RefProd<edmNew::DetSetVector<SiPixelCluster>>(pixelClusters),std::move(collectedPixels));
     iEvent.put(std::move(removedPixelClusterMask));
  
-    auto removedPhase2OTClusterMask= 
-      std::make_unique<Phase2OTMaskContainer>(edm::RefProd<edmNew::DetSetVector<Phase2TrackerCluster1D>>(phase2OTClusters),collectedPhase2OTs);      
     LogDebug("TrackClusterRemoverPhase2")<<"total ph2OT to skip: "<<std::count(collectedPhase2OTs.begin(),collectedPhase2OTs.end(),true);
+    auto removedPhase2OTClusterMask= 
+      std::make_unique<Phase2OTMaskContainer>(edm::RefProd<edmNew::DetSetVector<Phase2TrackerCluster1D>>(phase2OTClusters),std::move(collectedPhase2OTs));
     iEvent.put(std::move(removedPhase2OTClusterMask));
 
 
@@ -20,6 +20,7 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
 	      reco::PFClusterCollection& output) {
   auto const & hits = *input;  
   std::vector<bool> used(hits.size(),false);
+  _thresholdState.assign(hits.size(),0);
   std::vector<unsigned int> seeds;
   
   // get the seeds and sort them descending in energy
@@ -41,13 +42,8 @@ buildClusters(const edm::Handle<reco::PFRecHitCollection>& input,
   }
 }
 
-void Basic2DGenericTopoClusterizer::
-buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
-		 const std::vector<bool>& rechitMask,
-		 unsigned int kcell,
-		 std::vector<bool>& used,		 
-		 reco::PFCluster& topocluster) {
-  auto const & cell = (*input)[kcell];
+bool Basic2DGenericTopoClusterizer::
+passesThresholds(const reco::PFRecHit& cell) const {
   int cell_layer = (int)cell.layer();
   if( cell_layer == PFLayer::HCAL_BARREL2 && 
       std::abs(cell.positionREP().eta()) > 0.34 ) {
@@ -73,19 +69,44 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
     LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
       << "RecHit " << cell.detId() << " with enegy "
       << cell.energy() << " GeV was rejected!." << std::endl;
-    return;
+    return false;
   }
+  return true;
+}
+
+// Depth-first walk over the neighbour indices of the rechits, with an
+// explicit stack instead of recursion: the rechits are added in the same
+// order, and the thresholds of a rechit are evaluated only once per event
+// even when it is reached from several of its neighbours.
+void Basic2DGenericTopoClusterizer::
+buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
+		 const std::vector<bool>& rechitMask,
+		 unsigned int kcell,
+		 std::vector<bool>& used,		 
+		 reco::PFCluster& topocluster) {
+  auto const & hits = *input;
+  auto accept = [&](unsigned int k) {
+    if( _thresholdState[k] == 0 ) _thresholdState[k] = passesThresholds(hits[k]) ? 1 : 2;
+    if( _thresholdState[k] != 1 ) return false;
+    used[k] = true;
+    auto ref = makeRefhit(input,k);
+    topocluster.addRecHitFraction(reco::PFRecHitFraction(ref, 1.0));
+    _stack.emplace_back(k,0);
+    return true;
+  };
 
+  _stack.clear();
+  if( !accept(kcell) ) return;
 
-  auto k = kcell;
-  used[k] = true;
-  auto ref = makeRefhit(input,k);
-  topocluster.addRecHitFraction(reco::PFRecHitFraction(ref, 1.0));
-  
-  auto const & neighbours = 
-    ( _useCornerCells ? cell.neighbours8() : cell.neighbours4() );
-  
-  for( auto nb : neighbours ) {
+  while( !_stack.empty() ) {
+    auto const & cell = hits[_stack.back().first];
+    auto const & neighbours = 
+      ( _useCornerCells ? cell.neighbours8() : cell.neighbours4() );
+    if( _stack.back().second == neighbours.size() ) {
+      _stack.pop_back();
+      continue;
+    }
+    auto nb = neighbours.begin()[_stack.back().second++];
     if( used[nb] || !rechitMask[nb] ) {
       LOGDRESSED("GenericTopoCluster::buildTopoCluster()")
       	<< "  RecHit " << cell.detId() << "\'s" 
@@ -96,6 +117,6 @@ buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>& input,
 	<< !rechitMask[nb] << " (masked)." << std::endl;
       continue;
     }
-    buildTopoCluster(input,rechitMask,nb,used,topocluster);
+    accept(nb);
   }
 }
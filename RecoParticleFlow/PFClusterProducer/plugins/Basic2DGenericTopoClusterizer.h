@@ -22,6 +22,12 @@ class Basic2DGenericTopoClusterizer : public InitialClusteringStepBase {
   
  private:  
   const bool _useCornerCells;
+  // state of each rechit: 0 not tested yet, 1 passes the thresholds, 2 fails
+  std::vector<unsigned char> _thresholdState;
+  // rechits being expanded and position in their neighbour list
+  std::vector<std::pair<unsigned int,unsigned int> > _stack;
+
+  bool passesThresholds(const reco::PFRecHit&) const;
   void buildTopoCluster(const edm::Handle<reco::PFRecHitCollection>&,
 			const std::vector<bool>&, // masked rechits
 			unsigned int, //present rechit
@@ -4,6 +4,7 @@
 #include "DataFormats/ParticleFlowReco/interface/PFRecHitFraction.h"
 #include "DataFormats/ParticleFlowReco/interface/PFBlockElement.h"
 
+#include <utility>
 #include <vector>
 
 class KDTreeLinkerBase
@@ -71,6 +72,14 @@ class KDTreeLinkerBase
   // updatePFBlockEltWithLinks() and clear()
   virtual void process();
 
+  // The target/field pairs found linked (or, for the linkers which only look
+  // for candidates, which may be linked) by the last call to process(). They
+  // are the only pairs of these types that the block algorithm needs to test.
+  const std::vector<std::pair<const reco::PFBlockElement*,
+			      const reco::PFBlockElement*> >& linkedPairs() const {
+    return linkedPairs_;
+  }
+
  protected:
   // target and field
   reco::PFBlockElement::Type _targetType,_fieldType;
@@ -86,6 +95,10 @@ class KDTreeLinkerBase
 
   // Debug boolean. Not used until now.
   bool			debug_;
+
+  // Filled by updatePFBlockEltWithLinks() in the derived classes.
+  std::vector<std::pair<const reco::PFBlockElement*,
+			const reco::PFBlockElement*> > linkedPairs_;
 };
 
 
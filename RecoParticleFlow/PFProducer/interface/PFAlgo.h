@@ -60,6 +60,9 @@ class PFAlgo {
   virtual ~PFAlgo();
 
   void setHOTag(bool ho) { useHO_ = ho;}
+
+  /// process the blocks concurrently (not with the PF electron and photon algorithms)
+  void setParallelBlocks(bool parallel) { parallelBlocks_ = parallel; }
   void setAlgo( int algo ) {algo_ = algo;}
   void setPFMuonAlgo(PFMuonAlgo* algo) {pfmu_ =algo;}
   void setMuonHandle(const edm::Handle<reco::MuonCollection>&);
@@ -244,11 +247,18 @@ class PFAlgo {
   virtual void processBlock( const reco::PFBlockRef& blockref,
                              std::list<reco::PFBlockRef>& hcalBlockRefs, 
                              std::list<reco::PFBlockRef>& ecalBlockRefs ); 
+
+  /// process one block, adding the candidates to pfCandidates
+  void processBlock( const reco::PFBlockRef& blockref,
+                     std::list<reco::PFBlockRef>& hcalBlockRefs, 
+                     std::list<reco::PFBlockRef>& ecalBlockRefs,
+                     reco::PFCandidateCollection& pfCandidates ); 
   
   /// Reconstruct a charged particle from a track
-  /// Returns the index of the newly created candidate in pfCandidates_
+  /// Returns the index of the newly created candidate in pfCandidates
   /// Michalis added a flag here to treat muons inside jets
-  unsigned reconstructTrack( const reco::PFBlockElement& elt,bool allowLoose= false);
+  unsigned reconstructTrack( reco::PFCandidateCollection& pfCandidates,
+                             const reco::PFBlockElement& elt,bool allowLoose= false);
 
   /// Reconstruct a neutral particle from a cluster. 
   /// If chargedEnergy is specified, the neutral 
@@ -256,7 +266,8 @@ class PFAlgo {
   /// larger than the chargedEnergy. In this case, the energy of the 
   /// neutral particle is cluster energy - chargedEnergy
 
-  unsigned reconstructCluster( const reco::PFCluster& cluster,
+  unsigned reconstructCluster( reco::PFCandidateCollection& pfCandidates,
+                               const reco::PFCluster& cluster,
                                double particleEnergy,
 			       bool useDirection = false,
 			       double particleX=0.,
@@ -413,6 +424,8 @@ class PFAlgo {
 
   edm::Handle<reco::MuonCollection> muonHandle_;
 
+  bool parallelBlocks_ = false;
+
 };
 
 
@@ -117,6 +117,9 @@ class PFBlockAlgo {
 
   // run all of the importers and build KDtrees
   void buildElements(const edm::Event&);
+
+  // same, from elements already imported
+  void buildElements(ElementList&&);
   
   /// build blocks
   void findBlocks();
@@ -171,6 +174,8 @@ class PFBlockAlgo {
     elementTypes_;
   std::vector<LinkTestPtr> linkTests_;
   unsigned int linkTestSquare_[reco::PFBlockElement::kNBETypes][reco::PFBlockElement::kNBETypes];
+  // link tests whose candidate pairs are all found by a KDTree
+  std::vector<bool> linkTestByKDTree_;
   
   std::vector<KDTreePtr> kdtrees_;
 };
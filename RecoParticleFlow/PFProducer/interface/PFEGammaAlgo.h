@@ -105,7 +105,20 @@ class PFEGammaAlgo {
     // last brem tangent cluster if neither of those work
     std::vector<const PFClusterElement*> electronClusters; 
     int firstBrem, lateBrem, nBremsWithClusters;
+    // back to the default state, keeping the capacity of the containers
+    void clear();
   };  
+
+  // links of the ECAL clusters of a block to its GSF tracks, rebuilt from 
+  // the link data for each block: the (distance, GSF index) pairs of the 
+  // ECAL element of index i are links[begin[i]] to links[begin[i+1]-1],
+  // by increasing distance as from PFBlock::associatedElements
+  struct GSFLinksOfECAL {
+    std::vector<unsigned> begin;
+    std::vector<std::pair<double,unsigned> > links;
+    std::vector<unsigned> gsfs; // GSF element indices of the block
+    void fill(const reco::PFBlock&);
+  };
   
   struct PFEGConfigInfo {
     double mvaEleCut;
@@ -203,6 +216,8 @@ private:
   // sadly we're mashing together two ways of thinking about the block
   std::vector<std::vector<PFFlaggedElement> > _splayedblock; 
   ElementMap _recoveredlinks;
+  // flat GSF-ECAL links of the current block
+  GSFLinksOfECAL _gsfLinksOfECAL;
 
   // pre-cleaning for the splayed block
   bool isAMuon(const reco::PFBlockElement&);
@@ -216,6 +231,10 @@ private:
   // flow.
   // use list for constant-time removals
   std::list<ProtoEGObject> _refinableObjects;
+  // removed objects, whose nodes and containers are reused for the next ones
+  std::list<ProtoEGObject> _protoObjectPool;
+  // a cleared object appended to _refinableObjects, from the pool if possible
+  std::list<ProtoEGObject>::iterator addRefinableObject();
   // final list of fully refined objects in this block
   reco::PFCandidateCollection _finalCandidates;
 
@@ -23,8 +23,12 @@
 #include "CondFormats/ESObjects/interface/ESChannelStatus.h"
 
 #include "DataFormats/Common/interface/RefToPtr.h"
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
+#include "tbb/parallel_for.h"
+
 #include "TFile.h"
 
 //#define PFLOW_DEBUG
@@ -168,6 +172,11 @@ PFEGammaProducer::PFEGammaProducer(const edm::ParameterSet& iConfig,
   useCalibrationsFromDB_
     = iConfig.getParameter<bool>("useCalibrationsFromDB");    
 
+  // number of algorithm objects running on the blocks of an event concurrently
+  nParallelBlocks_ = 0;
+  if( iConfig.existsAs<unsigned>("nParallelBlocks") )
+    nParallelBlocks_ = iConfig.getParameter<unsigned>("nParallelBlocks");
+
   algo_config.thePFEnergyCalibration.reset(new PFEnergyCalibration());
 
   int algoType 
@@ -256,15 +265,18 @@ PFEGammaProducer::produce(edm::Event& iEvent,
   edm::Handle<reco::PFCluster::EEtoPSAssociation> eetops;
   iEvent.getByToken(eetopsSrc_,eetops);
   pfeg_->setEEtoPSAssociation(eetops);
+  for( auto& pfeg : pfegCopies_ ) pfeg->setEEtoPSAssociation(eetops);
 
   // preshower conditions                                                                                                                    
   edm::ESHandle<ESEEIntercalibConstants> esEEInterCalibHandle_;
   iSetup.get<ESEEIntercalibConstantsRcd>().get(esEEInterCalibHandle_);
+  // the energy calibration is shared by all the algorithm objects
   pfeg_->setAlphaGamma_ESplanes_fromDB(esEEInterCalibHandle_.product());
 
   edm::ESHandle<ESChannelStatus> esChannelStatusHandle_;
   iSetup.get<ESChannelStatusRcd>().get(esChannelStatusHandle_);
   pfeg_->setESChannelStatus(esChannelStatusHandle_.product());
+  for( auto& pfeg : pfegCopies_ ) pfeg->setESChannelStatus(esChannelStatusHandle_.product());
 
   // Get The vertices from the event
   // and assign dynamic vertex parameters
@@ -362,52 +374,93 @@ PFEGammaProducer::produce(edm::Event& iEvent,
   // single hcal and produce unbiased collection of EGamma Candidates
 
   //printf("loop over blocks\n");
-  unsigned nblcks = 0;
-
-  // this auto is a const reco::PFBlockRef&
-  for( const auto& blockref : otherBlockRefs ) {
-    ++nblcks;
-    // this auto is a: const edm::OwnVector< reco::PFBlockElement >&
-    const auto& elements = blockref->elements();
-    // make a copy of the link data, which will be edited.
-    //PFBlock::LinkData linkData =  block.linkData();
+  if( !pfegCopies_.empty() && otherBlockRefs.size() > 1 ) {
+    // each algorithm object takes a contiguous chunk of blocks, the outputs
+    // are stored per block and merged in the order of the serial loop
+    const std::vector<reco::PFBlockRef> blockRefs(otherBlockRefs.begin(),
+                                                  otherBlockRefs.end());
+    const unsigned nBlocks = blockRefs.size();
+    const unsigned nAlgos = std::min<unsigned>(pfegCopies_.size() + 1, nBlocks);
+    const unsigned chunk = (nBlocks + nAlgos - 1)/nAlgos;
+    std::vector<reco::PFCandidateCollection> blockCandidates(nBlocks);
+    std::vector<reco::PFCandidateEGammaExtraCollection> blockExtra(nBlocks);
+    std::vector<reco::SuperClusterCollection> blockSCs(nBlocks);
+    tbb::parallel_for(0U, nAlgos, [&](unsigned ialgo) {
+      PFEGammaAlgo& pfeg = ialgo == 0 ? *pfeg_ : *pfegCopies_[ialgo-1];
+      const unsigned last = std::min(nBlocks, (ialgo+1)*chunk);
+      for( unsigned iblock = ialgo*chunk; iblock < last; ++iblock ) {
+        std::vector<bool> active( blockRefs[iblock]->elements().size(), true );
+        pfeg.RunPFEG(globalCache(),blockRefs[iblock],active);
+        blockCandidates[iblock] = std::move(pfeg.getCandidates());
+        blockExtra[iblock] = std::move(pfeg.getEGExtra());
+        blockSCs[iblock] = std::move(pfeg.getRefinedSCs());
+      }
+    });
+
+    size_t ncands = 0, nscs = 0;
+    for( unsigned iblock = 0; iblock < nBlocks; ++iblock ) {
+      ncands += blockCandidates[iblock].size();
+      nscs += blockSCs[iblock].size();
+    }
+    egCandidates_->reserve(ncands);
+    egExtra_->reserve(ncands);
+    sClusters_->reserve(nscs);
+    for( unsigned iblock = 0; iblock < nBlocks; ++iblock ) {
+      std::move(blockCandidates[iblock].begin(), blockCandidates[iblock].end(),
+                std::back_inserter(*egCandidates_));
+      std::move(blockExtra[iblock].begin(), blockExtra[iblock].end(),
+                std::back_inserter(*egExtra_));
+      std::move(blockSCs[iblock].begin(), blockSCs[iblock].end(),
+                std::back_inserter(*sClusters_));
+    }
+  } else {
+    unsigned nblcks = 0;
+
+    // this auto is a const reco::PFBlockRef&
+    for( const auto& blockref : otherBlockRefs ) {
+      ++nblcks;
+      // this auto is a: const edm::OwnVector< reco::PFBlockElement >&
+      const auto& elements = blockref->elements();
+      // make a copy of the link data, which will be edited.
+      //PFBlock::LinkData linkData =  block.linkData();
     
-    // keep track of the elements which are still active.
-    std::vector<bool> active( elements.size(), true );      
+      // keep track of the elements which are still active.
+      std::vector<bool> active( elements.size(), true );      
     
-    pfeg_->RunPFEG(globalCache(),blockref,active);
-
-    if( !pfeg_->getCandidates().empty() ) {
-      LOGDRESSED("PFEGammaProducer")
-      << "Block with " << elements.size() 
-      << " elements produced " 
-      << pfeg_->getCandidates().size() 
-      << " e-g candidates!" << std::endl;      
-    }
+      pfeg_->RunPFEG(globalCache(),blockref,active);
+
+      if( !pfeg_->getCandidates().empty() ) {
+        LOGDRESSED("PFEGammaProducer")
+        << "Block with " << elements.size() 
+        << " elements produced " 
+        << pfeg_->getCandidates().size() 
+        << " e-g candidates!" << std::endl;      
+      }
 
-    const size_t egsize = egCandidates_->size();
-    egCandidates_->resize(egsize + pfeg_->getCandidates().size());
-    reco::PFCandidateCollection::iterator eginsertfrom = 
-      egCandidates_->begin() + egsize;
-    std::move(pfeg_->getCandidates().begin(),
-	      pfeg_->getCandidates().end(),
-	      eginsertfrom);
+      const size_t egsize = egCandidates_->size();
+      egCandidates_->resize(egsize + pfeg_->getCandidates().size());
+      reco::PFCandidateCollection::iterator eginsertfrom = 
+        egCandidates_->begin() + egsize;
+      std::move(pfeg_->getCandidates().begin(),
+	        pfeg_->getCandidates().end(),
+	        eginsertfrom);
     
-    const size_t egxsize = egExtra_->size();
-    egExtra_->resize(egxsize + pfeg_->getEGExtra().size());
-    reco::PFCandidateEGammaExtraCollection::iterator egxinsertfrom = 
-      egExtra_->begin() + egxsize;
-    std::move(pfeg_->getEGExtra().begin(),
-	      pfeg_->getEGExtra().end(),
-	      egxinsertfrom);
-
-    const size_t rscsize = sClusters_->size();
-    sClusters_->resize(rscsize + pfeg_->getRefinedSCs().size());
-    reco::SuperClusterCollection::iterator rscinsertfrom = 
-      sClusters_->begin() + rscsize;
-    std::move(pfeg_->getRefinedSCs().begin(),
-	      pfeg_->getRefinedSCs().end(),
-	      rscinsertfrom);    
+      const size_t egxsize = egExtra_->size();
+      egExtra_->resize(egxsize + pfeg_->getEGExtra().size());
+      reco::PFCandidateEGammaExtraCollection::iterator egxinsertfrom = 
+        egExtra_->begin() + egxsize;
+      std::move(pfeg_->getEGExtra().begin(),
+	        pfeg_->getEGExtra().end(),
+	        egxinsertfrom);
+
+      const size_t rscsize = sClusters_->size();
+      sClusters_->resize(rscsize + pfeg_->getRefinedSCs().size());
+      reco::SuperClusterCollection::iterator rscinsertfrom = 
+        sClusters_->begin() + rscsize;
+      std::move(pfeg_->getRefinedSCs().begin(),
+	        pfeg_->getRefinedSCs().end(),
+	        rscinsertfrom);    
+    }
   }
 
   LOGDRESSED("PFEGammaProducer")
@@ -542,6 +595,9 @@ PFEGammaProducer::setPFEGParameters(PFEGammaAlgo::PFEGConfigInfo& cfg) {
   }  
   cfg.primaryVtx = &primaryVertex_;  
   pfeg_.reset(new PFEGammaAlgo(cfg));
+  pfegCopies_.clear();
+  for( unsigned i = 1; i < nParallelBlocks_; ++i )
+    pfegCopies_.emplace_back(new PFEGammaAlgo(cfg));
 }
 
 /*
@@ -568,6 +624,7 @@ PFEGammaProducer::setPFVertexParameters(bool useVertex,
   //bool primaryVertexFound = false;
   int nVtx=primaryVertices->size();
   pfeg_->setnPU(nVtx);
+  for( auto& pfeg : pfegCopies_ ) pfeg->setnPU(nVtx);
 //   if(usePFPhotons_){
 //     pfpho_->setnPU(nVtx);
 //   }
@@ -583,6 +640,7 @@ PFEGammaProducer::setPFVertexParameters(bool useVertex,
     }
   
   pfeg_->setPhotonPrimaryVtx(primaryVertex_ );
+  for( auto& pfeg : pfegCopies_ ) pfeg->setPhotonPrimaryVtx(primaryVertex_ );
   
 }
 
@@ -139,6 +139,11 @@ class PFEGammaProducer : public edm::stream::EDProducer<edm::GlobalCache<pfEGHel
   
   /// particle flow algorithm
   std::unique_ptr<PFEGammaAlgo>      pfeg_;
+
+  /// number of algorithm objects processing the blocks concurrently (0 or 1: serial)
+  unsigned nParallelBlocks_;
+  /// additional algorithm objects, one per concurrent chunk of blocks beyond the first
+  std::vector<std::unique_ptr<PFEGammaAlgo> > pfegCopies_;
   
   std::string ebeeClustersCollection_;
   std::string esClustersCollection_;
@@ -0,0 +1,143 @@
+#include "KDTreeLinkerClusterWindow.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/Math/interface/normalizedPhi.h"
+
+#include <algorithm>
+#include <cmath>
+
+KDTreeLinkerClusterWindow::KDTreeLinkerClusterWindow(double window1, double window2, bool phiLike)
+  : KDTreeLinkerBase(),
+    window1_(window1),
+    window2_(window2),
+    phiLike_(phiLike)
+{
+}
+
+KDTreeLinkerClusterWindow::~KDTreeLinkerClusterWindow()
+{
+  clear();
+}
+
+void
+KDTreeLinkerClusterWindow::insertTargetElt(reco::PFBlockElement *target)
+{
+  Entry entry;
+  entry.elt = target;
+  if( coordinates(target, true, entry.c1, entry.c2) )
+    targets_.push_back(entry);
+}
+
+void
+KDTreeLinkerClusterWindow::insertFieldClusterElt(reco::PFBlockElement *cluster)
+{
+  Entry entry;
+  entry.elt = cluster;
+  if( coordinates(cluster, false, entry.c1, entry.c2) )
+    fields_.push_back(entry);
+}
+
+void
+KDTreeLinkerClusterWindow::buildTree()
+{
+  std::sort(fields_.begin(), fields_.end(),
+	    [](const Entry &a, const Entry &b) { return a.c1 < b.c1; });
+}
+
+void
+KDTreeLinkerClusterWindow::searchLinks()
+{
+  for(const auto &target : targets_) {
+    auto first = std::lower_bound(fields_.begin(), fields_.end(), target.c1 - window1_,
+				  [](const Entry &e, double c1) { return e.c1 < c1; });
+    for(auto it = first; it != fields_.end() && it->c1 <= target.c1 + window1_; ++it) {
+      const double d2 = ( phiLike_ ? normalizedPhi(it->c2 - target.c2) : it->c2 - target.c2 );
+      if( std::abs(d2) <= window2_ )
+	linkedPairs_.emplace_back(target.elt, it->elt);
+    }
+  }
+}
+
+void
+KDTreeLinkerClusterWindow::updatePFBlockEltWithLinks()
+{
+}
+
+void
+KDTreeLinkerClusterWindow::clear()
+{
+  targets_.clear();
+  fields_.clear();
+}
+
+
+// The window linkers: the windows are those of the link tests of the
+// corresponding linkers, with a small margin against rounding.
+
+// ECALAndHCALLinker: ECAL clusters beyond |eta| = 2.5, at less than 0.2 in
+// (eta, phi) from the HCAL cluster.
+class KDTreeLinkerEcalHcal : public KDTreeLinkerClusterWindow
+{
+ public:
+  KDTreeLinkerEcalHcal() : KDTreeLinkerClusterWindow(0.201, 0.201, true) {}
+
+ protected:
+  bool coordinates(const reco::PFBlockElement *cluster, bool isTarget,
+		   double &c1, double &c2) const override {
+    if( cluster->clusterRef().isNull() ) return false;
+    const reco::PFCluster::REPPoint &posrep = cluster->clusterRef()->positionREP();
+    c1 = posrep.Eta();
+    c2 = posrep.Phi();
+    return !isTarget || std::abs(c1) > 2.5;
+  }
+};
+
+// HCALAndHOLinker: HCAL clusters within |eta| = 1.5, at less than 0.2 in
+// (eta, phi) from the HO cluster.
+class KDTreeLinkerHcalHo : public KDTreeLinkerClusterWindow
+{
+ public:
+  KDTreeLinkerHcalHo() : KDTreeLinkerClusterWindow(0.201, 0.201, true) {}
+
+ protected:
+  bool coordinates(const reco::PFBlockElement *cluster, bool isTarget,
+		   double &c1, double &c2) const override {
+    if( cluster->clusterRef().isNull() ) return false;
+    const reco::PFCluster::REPPoint &posrep = cluster->clusterRef()->positionREP();
+    c1 = posrep.Eta();
+    c2 = posrep.Phi();
+    return !isTarget || std::abs(c1) < 1.5;
+  }
+};
+
+// HFEMAndHFHADLinker (LinkByRecHit::testHFEMAndHFHADByRecHit): less than
+// sqrt(0.1) cm apart in the transverse plane.
+class KDTreeLinkerHfemHfhad : public KDTreeLinkerClusterWindow
+{
+ public:
+  KDTreeLinkerHfemHfhad() : KDTreeLinkerClusterWindow(0.317, 0.317, false) {}
+
+ protected:
+  bool coordinates(const reco::PFBlockElement *cluster, bool,
+		   double &c1, double &c2) const override {
+    if( cluster->clusterRef().isNull() ) return false;
+    const auto &pos = cluster->clusterRef()->position();
+    c1 = pos.X();
+    c2 = pos.Y();
+    return true;
+  }
+};
+
+// the text names are different so that we can easily
+// construct them when calling the factory
+DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
+		  KDTreeLinkerEcalHcal,
+		  "KDTreeECALAndHCALLinker");
+
+DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
+		  KDTreeLinkerHcalHo,
+		  "KDTreeHCALAndHOLinker");
+
+DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
+		  KDTreeLinkerHfemHfhad,
+		  "KDTreeHFEMAndHFHADLinker");
@@ -0,0 +1,58 @@
+#ifndef KDTreeLinkerClusterWindow_h
+#define KDTreeLinkerClusterWindow_h
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
+
+#include <vector>
+
+// This class is used to find the candidate links between two types of
+// clusters whose link test only depends on the two cluster positions, and
+// fails when they are further apart than a fixed distance in each of two
+// coordinates (eta/phi or x/y).
+// It is not a tree: the field clusters are sorted in the first coordinate,
+// and each target only looks at the field clusters within the window of its
+// own first coordinate. The pairs found are only candidates, the link itself
+// is still decided by the linker: no multilinks are set.
+// It is used in PFBlockAlgo.cc in the function findBlocks().
+class KDTreeLinkerClusterWindow : public KDTreeLinkerBase
+{
+ public:
+  // window: largest difference of a linked pair in each coordinate,
+  // phiLike: the second coordinate is an angle in [-Pi,Pi]
+  KDTreeLinkerClusterWindow(double window1, double window2, bool phiLike);
+  ~KDTreeLinkerClusterWindow() override;
+
+  void insertTargetElt(reco::PFBlockElement *target) override;
+
+  void insertFieldClusterElt(reco::PFBlockElement *cluster) override;
+
+  // Sort the field clusters in the first coordinate.
+  void buildTree() override;
+
+  // Find, for each target, the field clusters within the window.
+  void searchLinks() override;
+
+  // Nothing to store in the elements, the pairs are already in linkedPairs_.
+  void updatePFBlockEltWithLinks() override;
+
+  void clear() override;
+
+ protected:
+  // The coordinates of a cluster; false if it cannot be linked at all.
+  virtual bool coordinates(const reco::PFBlockElement *cluster, bool isTarget,
+			   double &c1, double &c2) const = 0;
+
+ private:
+  struct Entry {
+    double c1, c2;
+    const reco::PFBlockElement *elt;
+  };
+
+  const double window1_, window2_;
+  const bool phiLike_;
+
+  std::vector<Entry> targets_;
+  std::vector<Entry> fields_;
+};
+
+#endif /* !KDTreeLinkerClusterWindow_h */
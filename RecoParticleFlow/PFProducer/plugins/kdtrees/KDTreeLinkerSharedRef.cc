@@ -0,0 +1,103 @@
+#include "KDTreeLinkerSharedRef.h"
+
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementCluster.h"
+
+#include <algorithm>
+
+KDTreeLinkerSharedRef::KDTreeLinkerSharedRef()
+  : KDTreeLinkerBase()
+{
+}
+
+KDTreeLinkerSharedRef::~KDTreeLinkerSharedRef()
+{
+  clear();
+}
+
+void
+KDTreeLinkerSharedRef::insertTargetElt(reco::PFBlockElement *target)
+{
+  refs_.clear();
+  references(target, refs_);
+  for(const auto &ref : refs_)
+    entries_.emplace_back(ref, target);
+}
+
+void
+KDTreeLinkerSharedRef::insertFieldClusterElt(reco::PFBlockElement *)
+{
+}
+
+void
+KDTreeLinkerSharedRef::buildTree()
+{
+  std::sort(entries_.begin(), entries_.end(),
+	    [](const auto &a, const auto &b) { return a.first < b.first; });
+}
+
+void
+KDTreeLinkerSharedRef::searchLinks()
+{
+  // all the pairs within each run of equal references; the pairs found
+  // through several references are removed by PFBlockAlgo
+  for(auto first = entries_.begin(); first != entries_.end(); ) {
+    auto last = first + 1;
+    while( last != entries_.end() && last->first == first->first ) ++last;
+    for(auto it = first; it != last; ++it)
+      for(auto jt = it + 1; jt != last; ++jt)
+	if( it->second != jt->second )
+	  linkedPairs_.emplace_back(it->second, jt->second);
+    first = last;
+  }
+}
+
+void
+KDTreeLinkerSharedRef::updatePFBlockEltWithLinks()
+{
+}
+
+void
+KDTreeLinkerSharedRef::clear()
+{
+  entries_.clear();
+}
+
+
+// TrackAndTrackLinker: tracks to or from the same displaced vertex, from the
+// same conversion or from the same V0.
+class KDTreeLinkerTrackTrack : public KDTreeLinkerSharedRef
+{
+ protected:
+  void references(const reco::PFBlockElement *track,
+		  std::vector<RefKey> &refs) const override {
+    for(auto type : {reco::PFBlockElement::T_TO_DISP, reco::PFBlockElement::T_FROM_DISP}) {
+      const auto &vertex = track->displacedVertexRef(type);
+      if( vertex.isNonnull() ) refs.emplace_back(vertex.id(), vertex.key());
+    }
+    for(const auto &conv : track->convRefs())
+      if( conv.isNonnull() ) refs.emplace_back(conv.id(), conv.key());
+    const auto &v0 = track->V0Ref();
+    if( v0.isNonnull() ) refs.emplace_back(v0.id(), v0.key());
+  }
+};
+
+// ECALAndECALLinker: clusters of the same supercluster.
+class KDTreeLinkerEcalEcal : public KDTreeLinkerSharedRef
+{
+ protected:
+  void references(const reco::PFBlockElement *ecal,
+		  std::vector<RefKey> &refs) const override {
+    const auto &sc = static_cast<const reco::PFBlockElementCluster*>(ecal)->superClusterRef();
+    if( sc.isNonnull() ) refs.emplace_back(sc.id(), sc.key());
+  }
+};
+
+// the text names are different so that we can easily
+// construct them when calling the factory
+DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
+		  KDTreeLinkerTrackTrack,
+		  "KDTreeTrackAndTrackLinker");
+
+DEFINE_EDM_PLUGIN(KDTreeLinkerFactory,
+		  KDTreeLinkerEcalEcal,
+		  "KDTreeECALAndECALLinker");
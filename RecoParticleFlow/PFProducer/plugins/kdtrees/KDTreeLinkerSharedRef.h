@@ -0,0 +1,54 @@
+#ifndef KDTreeLinkerSharedRef_h
+#define KDTreeLinkerSharedRef_h
+
+#include "RecoParticleFlow/PFProducer/interface/KDTreeLinkerBase.h"
+#include "DataFormats/Provenance/interface/ProductID.h"
+
+#include <utility>
+#include <vector>
+
+// This class is used to find the candidate links between elements of the same
+// type whose link test requires them to refer to the same object (displaced
+// vertex, conversion, V0, supercluster...), instead of testing all the pairs.
+// It is not a tree: the elements are sorted by the references they hold, and
+// the candidates are the pairs of elements sharing one of them. The pairs
+// found are only candidates, the link itself is still decided by the linker:
+// no multilinks are set.
+// Since target and field have the same type, only the targets are used.
+// It is used in PFBlockAlgo.cc in the function findBlocks().
+class KDTreeLinkerSharedRef : public KDTreeLinkerBase
+{
+ public:
+  KDTreeLinkerSharedRef();
+  ~KDTreeLinkerSharedRef() override;
+
+  void insertTargetElt(reco::PFBlockElement *target) override;
+
+  void insertFieldClusterElt(reco::PFBlockElement *cluster) override;
+
+  // Sort the elements by reference.
+  void buildTree() override;
+
+  // Pair the elements holding the same reference.
+  void searchLinks() override;
+
+  // Nothing to store in the elements, the pairs are already in linkedPairs_.
+  void updatePFBlockEltWithLinks() override;
+
+  void clear() override;
+
+ protected:
+  // product and index of a reference
+  typedef std::pair<edm::ProductID, unsigned long> RefKey;
+
+  // Append the (non null) references of an element which a linked partner
+  // has to share.
+  virtual void references(const reco::PFBlockElement *elt,
+			  std::vector<RefKey> &refs) const = 0;
+
+ private:
+  std::vector<std::pair<RefKey, const reco::PFBlockElement*> > entries_;
+  std::vector<RefKey> refs_;
+};
+
+#endif /* !KDTreeLinkerSharedRef_h */
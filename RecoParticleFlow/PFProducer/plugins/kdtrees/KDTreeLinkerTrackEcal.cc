@@ -228,6 +228,7 @@ KDTreeLinkerTrackEcal::updatePFBlockEltWithLinks()
       double clustereta = (*jt)->clusterRef()->positionREP().eta();
 
       multitracks.linkedClusters.push_back(std::make_pair(clusterphi, clustereta));
+      linkedPairs_.emplace_back(it->first, *jt);
     }
 
     it->first->setMultilinks(multitracks);
@@ -200,6 +200,7 @@ KDTreeLinkerTrackHcal::updatePFBlockEltWithLinks()
       double trackphi = atHCAL.positionREP().phi();
       
       multitracks.linkedClusters.push_back(std::make_pair(trackphi, tracketa));
+      linkedPairs_.emplace_back(it->first, *jt);
     }
 
     it->first->setMultilinks(multitracks);
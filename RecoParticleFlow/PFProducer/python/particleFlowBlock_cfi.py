@@ -94,19 +94,19 @@ particleFlowBlock = cms.EDProducer(
                   useKDTree  = cms.bool(False) ),
         cms.PSet( linkerName = cms.string("ECALAndHCALLinker"),
                   linkType   = cms.string("ECAL:HCAL"),
-                  useKDTree  = cms.bool(False) ),
+                  useKDTree  = cms.bool(True) ),
         cms.PSet( linkerName = cms.string("HCALAndHOLinker"),
                   linkType   = cms.string("HCAL:HO"),
-                  useKDTree  = cms.bool(False) ),
+                  useKDTree  = cms.bool(True) ),
         cms.PSet( linkerName = cms.string("HFEMAndHFHADLinker"),
                   linkType   = cms.string("HFEM:HFHAD"),
-                  useKDTree  = cms.bool(False) ),
+                  useKDTree  = cms.bool(True) ),
         cms.PSet( linkerName = cms.string("TrackAndTrackLinker"),
                   linkType   = cms.string("TRACK:TRACK"),
-                  useKDTree  = cms.bool(False) ),
+                  useKDTree  = cms.bool(True) ),
         cms.PSet( linkerName = cms.string("ECALAndECALLinker"),
                   linkType   = cms.string("ECAL:ECAL"),
-                  useKDTree  = cms.bool(False) ),
+                  useKDTree  = cms.bool(True) ),
         cms.PSet( linkerName = cms.string("GSFAndECALLinker"), 
                   linkType   = cms.string("GSF:ECAL"),
                   useKDTree  = cms.bool(False) ),
@@ -22,6 +22,9 @@ particleFlowEGamma = cms.EDProducer("PFEGammaProducer",
     # Algorithm type ?
     algoType = cms.uint32(0),
 
+    # Number of algorithm objects running on the blocks concurrently (0: serial)
+    nParallelBlocks = cms.uint32(0),
+
     # Verbose and debug flags
     verbose = cms.untracked.bool(True),
     debug = cms.untracked.bool(True),
@@ -23,6 +23,9 @@ particleFlowTmp = cms.EDProducer("PFProducer",
     # Use HO clusters in PF hadron reconstruction
     useHO = cms.bool(True),                                 
 
+    # Process the PF blocks concurrently (ignored with usePFElectrons or usePFPhotons)
+    parallelBlocks = cms.bool(False),
+
     # Use electron identification in PFAlgo
     usePFElectrons = cms.bool(False),
     pf_electron_output_col=cms.string('electrons'),
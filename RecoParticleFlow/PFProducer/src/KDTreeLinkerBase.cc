@@ -59,6 +59,7 @@ KDTreeLinkerBase::getPhiOffset() const
 void
 KDTreeLinkerBase::process()
 {
+  linkedPairs_.clear();
   buildTree();
   searchLinks();
   updatePFBlockEltWithLinks();
@@ -91,6 +91,7 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
      }
    }
   linkTests_.resize(rowsize*rowsize);
+  linkTestByKDTree_.assign(rowsize*rowsize,false);
   const std::string prefix("PFBlockElement::");
   const std::string pfx_kdtree("KDTree");
   for( const auto& conf : confs ) {
@@ -126,6 +127,7 @@ void PFBlockAlgo::setLinkers(const std::vector<edm::ParameterSet>& confs) {
 								linkerName) );
       kdtrees_.back()->setTargetType(std::min(type1,type2));
       kdtrees_.back()->setFieldType(std::max(type1,type2));
+      linkTestByKDTree_[index] = true;
     }
   }
 }
@@ -164,24 +166,67 @@ void PFBlockAlgo::findBlocks() {
 
   QuickUnion qu(bare_elements_.size());
   const auto elem_size = bare_elements_.size();
+
+  // For the types linked with a KDTree, the only pairs which can be linked
+  // are those found by the KDTree: keep, for each element, the sorted
+  // indices of its partners instead of testing the whole range of the
+  // other type.
+  std::vector<std::vector<unsigned> > kdTreePartners;
+  if( !kdtrees_.empty() ) {
+    std::unordered_map<const PFBlockElement*,unsigned> elementIndex(elem_size);
+    for( unsigned i = 0; i < elem_size; ++i ) {
+      elementIndex.emplace(bare_elements_[i],i);
+    }
+    kdTreePartners.resize(elem_size);
+    for( const auto& kdtree : kdtrees_ ) {
+      for( const auto& linked : kdtree->linkedPairs() ) {
+        const unsigned i1 = elementIndex.at(linked.first);
+        const unsigned i2 = elementIndex.at(linked.second);
+        kdTreePartners[i1].push_back(i2);
+        kdTreePartners[i2].push_back(i1);
+      }
+    }
+    for( auto& partners : kdTreePartners ) {
+      std::sort(partners.begin(),partners.end());
+      partners.erase(std::unique(partners.begin(),partners.end()),partners.end());
+    }
+  }
+
+  // test the pair (i,j), uniting the two elements if they are linked
+  auto testAndUnite = [&](unsigned i, unsigned j, unsigned index) {
+    auto p1(bare_elements_[i]), p2(bare_elements_[j]);
+    if( linkTests_[index]->linkPrefilter(p1,p2) ) {
+      const double dist = linkTests_[index]->testLink(p1,p2);
+      // compute linking info if it is possible
+      if( dist > -0.5 ) {
+        qu.unite(i,j);
+      }
+    }
+  };
+
+  // the pairs are visited in the same order with or without the KDTree
+  // partners, so that the blocks come out identical
   for( unsigned i = 0; i < elem_size; ++i ) {
+    const PFBlockElement::Type type1 = bare_elements_[i]->type();
     for( unsigned j = 0; j < elem_size; ++j ) {
-      if( qu.connected(i,j) || j == i ) continue;
-      if( !linkTests_[linkTestSquare_[bare_elements_[i]->type()][bare_elements_[j]->type()]] ) {
-        j = ranges_[bare_elements_[j]->type()].second;
+      const PFBlockElement::Type type2 = bare_elements_[j]->type();
+      const unsigned index = linkTestSquare_[type1][type2];
+      if( !linkTests_[index] ) {
+        j = ranges_[type2].second;
         continue;
       }
-      auto p1(bare_elements_[i]), p2(bare_elements_[j]);
-      const PFBlockElement::Type type1 = p1->type();
-      const PFBlockElement::Type type2 = p2->type();
-      const unsigned index = linkTestSquare_[type1][type2];
-      if( linkTests_[index]->linkPrefilter(p1,p2) ) {
-        const double dist = linkTests_[index]->testLink(p1,p2);
-        // compute linking info if it is possible
-        if( dist > -0.5 ) {
-          qu.unite(i,j);
+      if( linkTestByKDTree_[index] ) {
+        const auto& range = ranges_[type2];
+        for( const unsigned k : kdTreePartners[i] ) {
+          if( k < range.first || k > range.second ) continue;
+          if( qu.connected(i,k) || k == i ) continue;
+          testAndUnite(i,k,index);
         }
+        j = range.second;
+        continue;
       }
+      if( qu.connected(i,j) || j == i ) continue;
+      testAndUnite(i,j,index);
     }
   }
   
@@ -334,11 +379,16 @@ void PFBlockAlgo::updateEventSetup(const edm::EventSetup& es) {
 // and kdtree preprocessors
 void PFBlockAlgo::buildElements(const edm::Event& evt) {
   // import block elements as defined in python configuration
-  ranges_.fill(std::make_pair(0,0));
-  elements_.clear();
+  ElementList elements;
   for( const auto& importer : importers_ ) {
-    importer->importToBlock(evt,elements_);
+    importer->importToBlock(evt,elements);
   }
+  buildElements(std::move(elements));
+}
+
+void PFBlockAlgo::buildElements(ElementList&& elements) {
+  ranges_.fill(std::make_pair(0,0));
+  elements_ = std::move(elements);
 
   std::sort(elements_.begin(),elements_.end(),
             [](const auto& a, const auto& b) { return a->type() < b->type(); } );
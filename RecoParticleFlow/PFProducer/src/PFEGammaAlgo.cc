@@ -30,6 +30,7 @@
 #include <TVector2.h>
 #include <iomanip>
 #include <algorithm>
+#include <iterator>
 #include <numeric>
 #include <TMath.h>
 #include "TMVA/MethodBDT.h"
@@ -183,15 +184,78 @@ namespace {
     }
   }; 
   
+  // true if none of the (distance, index) associates [first,last) of the 
+  // test element is closer to it than the key element, at distance dist
+  template<bool useConvs, class AssociateIterator>
+  bool noCloserAssociate(const reco::PFBlockRef& block,
+			 const PFBlockElement::Type& keytype,
+			 const size_t key, 
+			 const PFBlockElement::Type& valtype,
+			 const size_t test,
+			 const float EoPin_cut,
+			 const float dist,
+			 AssociateIterator first,
+			 AssociateIterator last) {
+    constexpr reco::PFBlockElement::TrackType ConvType =
+	reco::PFBlockElement::T_FROM_GAMMACONV;
+    for( ; first != last; ++first ) {
+      const auto& valdist = *first;
+      const size_t idx = valdist.second;
+      // check track types for conversion info
+      switch( keytype ) {
+      case reco::PFBlockElement::GSF:
+	{
+	  const reco::PFBlockElementGsfTrack* elemasgsf  =  
+	    docast(const reco::PFBlockElementGsfTrack*,
+		   &(block->elements()[idx]));
+	  if( !useConvs && elemasgsf->trackType(ConvType) ) return false;
+	  if( elemasgsf && valtype == PFBlockElement::ECAL ) {
+	    const ClusterElement* elemasclus =
+	      docast(const ClusterElement*,&(block->elements()[test]));
+	    float cluster_e = elemasclus->clusterRef()->correctedEnergy();
+	    float trk_pin   = elemasgsf->Pin().P();
+	    if( cluster_e / trk_pin > EoPin_cut ) continue;
+	  }
+	}
+	break;
+      case reco::PFBlockElement::TRACK:
+	{
+	  const reco::PFBlockElementTrack* elemaskf  = 
+	    docast(const reco::PFBlockElementTrack*,
+		   &(block->elements()[idx]));
+	  if( !useConvs && elemaskf->trackType(ConvType) ) return false;
+	  if( elemaskf && valtype == PFBlockElement::ECAL ) {
+	    const ClusterElement* elemasclus =
+	    reinterpret_cast<const ClusterElement*>(&(block->elements()[test]));
+	    float cluster_e = elemasclus->clusterRef()->correctedEnergy();
+	    float trk_pin   = 
+	      std::sqrt(elemaskf->trackRef()->innerMomentum().mag2());
+	    if( cluster_e / trk_pin > EoPin_cut ) continue;
+	  }
+	}	
+	break;
+      default:
+	break;
+      }	        
+      if( valdist.first < dist && idx != key ) {
+	LOGDRESSED("elementNotCloserToOther") 
+	  << "key element of type " << keytype 
+	  << " is closer to another element of type" << valtype 
+	  << std::endl;
+	return false; // false if closer element of specified type found
+      }
+    }
+    return true;
+  }
+
   template<bool useConvs=false>
   bool elementNotCloserToOther(const reco::PFBlockRef& block,
 			       const PFBlockElement::Type& keytype,
 			       const size_t key, 
 			       const PFBlockElement::Type& valtype,
 			       const size_t test,
-			       const float EoPin_cut = 1.0e6) {
-    constexpr reco::PFBlockElement::TrackType ConvType =
-	reco::PFBlockElement::T_FROM_GAMMACONV;
+			       const float EoPin_cut = 1.0e6,
+			       const PFEGammaAlgo::GSFLinksOfECAL* gsfLinks = nullptr) {
     // this is inside out but I just want something that works right now
     switch( keytype ) {
     case reco::PFBlockElement::GSF:
@@ -238,57 +302,21 @@ namespace {
     const float dist = 
       block->dist(key,test,block->linkData(),reco::PFBlock::LINKTEST_ALL);
     if( dist == -1.0f ) return false; // don't associate non-linked elems
+    if( gsfLinks && keytype == PFBlockElement::GSF && 
+	valtype == PFBlockElement::ECAL ) {
+      // the GSF tracks linked to the cluster, from the flat table
+      const auto& links = gsfLinks->links;
+      return noCloserAssociate<useConvs>(block,keytype,key,valtype,test,
+					 EoPin_cut,dist,
+					 links.begin()+gsfLinks->begin[test],
+					 links.begin()+gsfLinks->begin[test+1]);
+    }
     std::multimap<double, unsigned> dists_to_val; 
     block->associatedElements(test,block->linkData(),dists_to_val,keytype,
 			      reco::PFBlock::LINKTEST_ALL); 
-  
-    for( const auto& valdist : dists_to_val ) {
-      const size_t idx = valdist.second;
-      // check track types for conversion info
-      switch( keytype ) {
-      case reco::PFBlockElement::GSF:
-	{
-	  const reco::PFBlockElementGsfTrack* elemasgsf  =  
-	    docast(const reco::PFBlockElementGsfTrack*,
-		   &(block->elements()[idx]));
-	  if( !useConvs && elemasgsf->trackType(ConvType) ) return false;
-	  if( elemasgsf && valtype == PFBlockElement::ECAL ) {
-	    const ClusterElement* elemasclus =
-	      docast(const ClusterElement*,&(block->elements()[test]));
-	    float cluster_e = elemasclus->clusterRef()->correctedEnergy();
-	    float trk_pin   = elemasgsf->Pin().P();
-	    if( cluster_e / trk_pin > EoPin_cut ) continue;
-	  }
-	}
-	break;
-      case reco::PFBlockElement::TRACK:
-	{
-	  const reco::PFBlockElementTrack* elemaskf  = 
-	    docast(const reco::PFBlockElementTrack*,
-		   &(block->elements()[idx]));
-	  if( !useConvs && elemaskf->trackType(ConvType) ) return false;
-	  if( elemaskf && valtype == PFBlockElement::ECAL ) {
-	    const ClusterElement* elemasclus =
-	    reinterpret_cast<const ClusterElement*>(&(block->elements()[test]));
-	    float cluster_e = elemasclus->clusterRef()->correctedEnergy();
-	    float trk_pin   = 
-	      std::sqrt(elemaskf->trackRef()->innerMomentum().mag2());
-	    if( cluster_e / trk_pin > EoPin_cut ) continue;
-	  }
-	}	
-	break;
-      default:
-	break;
-      }	        
-      if( valdist.first < dist && idx != key ) {
-	LOGDRESSED("elementNotCloserToOther") 
-	  << "key element of type " << keytype 
-	  << " is closer to another element of type" << valtype 
-	  << std::endl;
-	return false; // false if closer element of specified type found
-      }
-    }
-    return true;
+    return noCloserAssociate<useConvs>(block,keytype,key,valtype,test,
+				       EoPin_cut,dist,
+				       dists_to_val.begin(),dists_to_val.end());
   }
 
   struct CompatibleEoPOut : public PFFlaggedElementMatcher {
@@ -324,28 +352,36 @@ namespace {
     const reco::PFBlockRef& block;
     const reco::PFBlock::LinkData& links;   
     const float EoPin_cut;
+    // flat GSF-ECAL links of the block, used instead of the link data if set
+    const PFEGammaAlgo::GSFLinksOfECAL* gsfLinks;
     NotCloserToOther(const reco::PFBlockRef& b,
 		     const reco::PFBlock::LinkData& l,
 		     const PFFlaggedElement* e,
-		     const float EoPcut=1.0e6): comp(e->first), 
-						block(b), 
-						links(l),
-						EoPin_cut(EoPcut) { 
+		     const float EoPcut=1.0e6,
+		     const PFEGammaAlgo::GSFLinksOfECAL* g=nullptr): 
+      comp(e->first), 
+      block(b), 
+      links(l),
+      EoPin_cut(EoPcut),
+      gsfLinks(g) { 
     }
     NotCloserToOther(const reco::PFBlockRef& b,
 		     const reco::PFBlock::LinkData& l,
 		     const reco::PFBlockElement* e,
-		     const float EoPcut=1.0e6): comp(e), 
-						block(b), 
-						links(l),
-						EoPin_cut(EoPcut) {
+		     const float EoPcut=1.0e6,
+		     const PFEGammaAlgo::GSFLinksOfECAL* g=nullptr): 
+      comp(e), 
+      block(b), 
+      links(l),
+      EoPin_cut(EoPcut),
+      gsfLinks(g) {
     }
     bool operator () (const PFFlaggedElement& e) {        
       if( !e.second || valtype != e.first->type() ) return false;      
       return elementNotCloserToOther<useConv>(block,
 					      keytype,comp->index(),
 					      valtype,e.first->index(),
-					      EoPin_cut);
+					      EoPin_cut,gsfLinks);
     }
   };
 
@@ -826,18 +862,78 @@ bool PFEGammaAlgo::isAMuon(const reco::PFBlockElement& pfbe) {
   return false;
 }
 
+void PFEGammaAlgo::ProtoEGObject::clear() {
+  parentBlock = reco::PFBlockRef();
+  parentSC = nullptr;
+  electronSeed = reco::ElectronSeedRef();
+  ecalclusters.clear();
+  primaryGSFs.clear();
+  primaryKFs.clear();
+  brems.clear();
+  secondaryGSFs.clear();
+  secondaryKFs.clear();
+  hcalClusters.clear();
+  localMap.clear();
+  electronClusters.clear();
+  firstBrem = lateBrem = nBremsWithClusters = -1;
+  // new hash maps: the iteration order depends on the number of buckets
+  ecal2ps = ClusterMap();
+  boundKFTracks = GSFToTrackMap();
+  singleLegConversionMvaMap = KFValMap();
+}
+
+void PFEGammaAlgo::GSFLinksOfECAL::fill(const reco::PFBlock& block) {
+  const auto& elements = block.elements();
+  begin.assign(elements.size()+1,0);
+  links.clear();
+  gsfs.clear();
+  for( unsigned i = 0; i < elements.size(); ++i ) {
+    if( elements[i].type() == PFBlockElement::GSF ) gsfs.push_back(i);
+  }
+  for( unsigned i = 0; i < elements.size(); ++i ) {
+    begin[i] = links.size();
+    if( gsfs.empty() || elements[i].type() != PFBlockElement::ECAL ) continue;
+    for( const unsigned gsf : gsfs ) {
+      const double dist = block.dist(i,gsf,block.linkData());
+      if( dist >= 0 ) links.emplace_back(dist,gsf);
+    }
+    // by distance, then by index like the multimap of associatedElements
+    std::stable_sort(links.begin()+begin[i],links.end(),
+		     [](const std::pair<double,unsigned>& a,
+			const std::pair<double,unsigned>& b) {
+		       return a.first < b.first;
+		     });
+  }
+  begin[elements.size()] = links.size();
+}
+
+std::list<PFEGammaAlgo::ProtoEGObject>::iterator 
+PFEGammaAlgo::addRefinableObject() {
+  if( _protoObjectPool.empty() ) {
+    _refinableObjects.emplace_back();
+  } else {
+    _refinableObjects.splice(_refinableObjects.end(),_protoObjectPool,
+			     _protoObjectPool.begin());
+    _refinableObjects.back().clear();
+  }
+  return std::prev(_refinableObjects.end());
+}
+
 void PFEGammaAlgo::buildAndRefineEGObjects(const pfEGHelpers::HeavyObjectCache* hoc,
                                            const reco::PFBlockRef& block) {
   LOGVERB("PFEGammaAlgo") 
     << "Resetting PFEGammaAlgo for new block and running!" << std::endl;
-  _splayedblock.clear();
+  // keep the per-type element vectors, and their capacity, from block to block
+  for( auto& elements : _splayedblock ) elements.clear();
   _recoveredlinks.clear();
-  _refinableObjects.clear();
+  // the objects of the previous block go back to the pool
+  _protoObjectPool.splice(_protoObjectPool.end(),_refinableObjects);
   _finalCandidates.clear();  
   _splayedblock.resize(13); // make sure that we always have the HGCAL entry
 
   _currentblock = block;
   _currentlinks = block->linkData();
+  _gsfLinksOfECAL.fill(*block);
   //LOGDRESSED("PFEGammaAlgo") << *_currentblock << std::endl;
   LOGVERB("PFEGammaAlgo") << "Splaying block" << std::endl;  
   //unwrap the PF block into a fast access map
@@ -967,7 +1063,8 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
       << "\tSC at index: " << element.first->index() 
       << " has type: " << element.first->type() << std::endl;
     element.second = false;
-    ProtoEGObject fromSC;
+    auto scobj = addRefinableObject();
+    ProtoEGObject& fromSC = *scobj;
     fromSC.nBremsWithClusters = -1;
     fromSC.firstBrem = -1;
     fromSC.lateBrem = -1;
@@ -990,7 +1087,8 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
 					return a_en < b_en;
 				      });
       */
-      _refinableObjects.insert(_refinableObjects.end(),fromSC);
+    } else {
+      _protoObjectPool.splice(_protoObjectPool.end(),_refinableObjects,scobj);
     }
   }
   // step 2: build GSF-seed-based proto-candidates
@@ -1010,7 +1108,8 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
     }
     element.second = false;
     
-    ProtoEGObject fromGSF;  
+    auto gsfobj = addRefinableObject();
+    ProtoEGObject& fromGSF = *gsfobj;
     fromGSF.nBremsWithClusters = -1;
     fromGSF.firstBrem = -1;
     fromGSF.lateBrem = 0;
@@ -1065,14 +1164,15 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
 	 << std::endl;           
        SeedMatchesToProtoObject sctoseedmatch(fromGSF.electronSeed);      
        objsbegin = _refinableObjects.begin();
-       objsend   = _refinableObjects.end();
+       objsend   = gsfobj; // not this object itself
        // this auto is a std::list<ProtoEGObject>::iterator
        auto clusmatch = std::find_if(objsbegin,objsend,sctoseedmatch);
        if( clusmatch != objsend ) {
 	 fromGSF.parentSC = clusmatch->parentSC;
 	 fromGSF.ecalclusters = std::move(clusmatch->ecalclusters);
 	 fromGSF.ecal2ps  = std::move(clusmatch->ecal2ps);
-	 _refinableObjects.erase(clusmatch);	
+	 _protoObjectPool.splice(_protoObjectPool.end(),_refinableObjects,
+				 clusmatch);
        } else if (fromGSF.electronSeed.isAvailable()  && 
 		  fromGSF.electronSeed.isNonnull()) {
 	 // link tests in the gap region can current split a gap electron
@@ -1105,7 +1205,6 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
 				       return a_en < b_en;
 				     });   
      */
-     _refinableObjects.insert(_refinableObjects.end(),fromGSF);
    } // end loop on GSF elements of block
 }
 
@@ -1532,10 +1631,9 @@ initializeProtoCands(std::list<PFEGammaAlgo::ProtoEGObject>& egobjs) {
 	     << std::endl;
 	 }
        }      
-       ROs.erase(mergestart,nomerge);
+       _protoObjectPool.splice(_protoObjectPool.end(),ROs,mergestart,nomerge);
        // put the merged element in the back of the cleaned list
-       ROs.push_back(ROs.front());
-       ROs.pop_front();
+       ROs.splice(ROs.end(),ROs,ROs.begin());
      } else {       
        check_for_merge = false;    
      }
@@ -1632,7 +1730,8 @@ linkRefinableObjectPrimaryGSFTrackToECAL(ProtoEGObject& RO) {
   auto ECALend = _splayedblock[reco::PFBlockElement::ECAL].end();
   for( auto& primgsf : RO.primaryGSFs ) {    
     NotCloserToOther<reco::PFBlockElement::GSF,reco::PFBlockElement::ECAL>
-      gsfTracksToECALs(_currentblock,_currentlinks,primgsf.first);
+      gsfTracksToECALs(_currentblock,_currentlinks,primgsf.first,
+                       1.0e6,&_gsfLinksOfECAL);
     CompatibleEoPOut eoverp_test(primgsf.first);
     // get set of matching ecals not already in SC
     auto notmatched_blk = std::partition(ECALbegin,ECALend,gsfTracksToECALs);
@@ -1718,7 +1817,8 @@ PFEGammaAlgo::linkKFTrackToECAL(const KFFlaggedElement& kfflagged,
   NotCloserToOther<reco::PFBlockElement::TRACK,reco::PFBlockElement::ECAL>
     kfTrackToECALs(_currentblock,_currentlinks,kfflagged.first);      
   NotCloserToOther<reco::PFBlockElement::GSF,reco::PFBlockElement::ECAL>
-    kfTrackGSFToECALs(_currentblock,_currentlinks,kfflagged.first);
+    kfTrackGSFToECALs(_currentblock,_currentlinks,kfflagged.first,
+                      1.0e6,&_gsfLinksOfECAL);
   //get the ECAL elements not used and not closer to another KF
   auto notmatched_sc = std::partition(currentECAL.begin(),
 				      currentECAL.end(),
@@ -0,0 +1,211 @@
+// Check that PFBlockAlgo builds the same blocks when the candidate links of
+// the ECAL:HCAL, HCAL:HO, HFEM:HFHAD, TRACK:TRACK and ECAL:ECAL pairs come
+// from their KDTree linkers (useKDTree = True) as when all the pairs of
+// elements of these types are tested (useKDTree = False).  The elements are
+// random clusters, dense enough to give many links and some large blocks, and
+// tracks sharing displaced vertices, conversions and V0s.  The blocks are
+// compared in order, element by element, together with their link distances.
+
+#include "RecoParticleFlow/PFProducer/interface/PFBlockAlgo.h"
+
+#include "DataFormats/Common/interface/TestHandle.h"
+#include "DataFormats/Candidate/interface/VertexCompositeCandidate.h"
+#include "DataFormats/EgammaCandidates/interface/Conversion.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlock.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFBlockElementTrack.h"
+#include "DataFormats/ParticleFlowReco/interface/PFCluster.h"
+#include "DataFormats/ParticleFlowReco/interface/PFDisplacedTrackerVertex.h"
+#include "DataFormats/ParticleFlowReco/interface/PFRecTrack.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/PluginManager/interface/PluginManager.h"
+#include "FWCore/PluginManager/interface/standard.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  struct Input {
+    reco::PFClusterCollection ecal, hcal, ho, hfem, hfhad;
+    reco::PFRecTrackCollection tracks;
+    reco::SuperClusterCollection superClusters;
+    reco::PFDisplacedTrackerVertexCollection vertices;
+    reco::ConversionCollection conversions;
+    reco::VertexCompositeCandidateCollection v0s;
+    // index of the super cluster of each ECAL cluster, -1 if none
+    std::vector<int> ecalSuperCluster;
+    // index of the vertex, conversion and V0 of each track, -1 if none
+    std::vector<std::tuple<int,int,int>> trackRefs;
+  };
+
+  edm::ParameterSet linker(const std::string& name, const std::string& type, bool useKDTree) {
+    edm::ParameterSet conf;
+    conf.addParameter<std::string>("linkerName",name);
+    conf.addParameter<std::string>("linkType",type);
+    conf.addParameter<bool>("useKDTree",useKDTree);
+    return conf;
+  }
+
+  std::vector<edm::ParameterSet> linkers(bool useKDTree) {
+    return { linker("ECALAndHCALLinker","ECAL:HCAL",useKDTree),
+	     linker("HCALAndHOLinker","HCAL:HO",useKDTree),
+	     linker("HFEMAndHFHADLinker","HFEM:HFHAD",useKDTree),
+	     linker("TrackAndTrackLinker","TRACK:TRACK",useKDTree),
+	     linker("ECALAndECALLinker","ECAL:ECAL",useKDTree) };
+  }
+
+  reco::PFCluster cluster(PFLayer::Layer layer, double eta, double phi, double rho) {
+    return reco::PFCluster(layer,10.,rho*std::cos(phi),rho*std::sin(phi),rho*std::sinh(eta));
+  }
+
+  Input generate(std::mt19937& rng) {
+    Input in;
+    std::uniform_real_distribution<double> eta(-3.,3.), etaBarrel(-1.6,1.6), phi(-M_PI,M_PI);
+    std::uniform_real_distribution<double> xy(-8.,8.), shift(-0.4,0.4);
+    std::uniform_int_distribution<int> flip(0,1), pick(0,19), several(0,3);
+
+    in.superClusters.resize(20);
+    in.vertices.resize(20);
+    in.conversions.resize(20);
+    in.v0s.resize(20);
+
+    for( int i = 0; i < 400; ++i ) {
+      in.ecal.push_back(cluster(PFLayer::ECAL_ENDCAP,eta(rng),phi(rng),130.));
+      in.ecalSuperCluster.push_back(flip(rng) ? pick(rng) : -1);
+    }
+    for( int i = 0; i < 300; ++i ) {
+      in.hcal.push_back(cluster(PFLayer::HCAL_ENDCAP,eta(rng),phi(rng),180.));
+    }
+    for( int i = 0; i < 150; ++i ) {
+      in.ho.push_back(cluster(PFLayer::HCAL_BARREL2,etaBarrel(rng),phi(rng),400.));
+    }
+    for( int i = 0; i < 150; ++i ) {
+      const double x = xy(rng), y = xy(rng), z = flip(rng) ? 1100. : -1100.;
+      in.hfem.push_back(reco::PFCluster(PFLayer::HF_EM,10.,x,y,z));
+      // half of the HAD clusters next to an EM one, on either side
+      if( flip(rng) ) {
+	in.hfhad.push_back(reco::PFCluster(PFLayer::HF_HAD,10.,x+shift(rng),y+shift(rng),flip(rng) ? z : -z));
+      } else {
+	in.hfhad.push_back(reco::PFCluster(PFLayer::HF_HAD,10.,xy(rng),xy(rng),z));
+      }
+    }
+    for( int i = 0; i < 300; ++i ) {
+      // the extrapolated points needed by PFBlockElementTrack
+      reco::PFRecTrack track;
+      for( unsigned l = 0; l < reco::PFTrajectoryPoint::NLayers; ++l ) {
+	track.addPoint(reco::PFTrajectoryPoint());
+      }
+      in.tracks.push_back(track);
+      in.trackRefs.emplace_back(several(rng) ? -1 : pick(rng),
+				several(rng) ? -1 : pick(rng),
+				several(rng) ? -1 : pick(rng));
+    }
+    return in;
+  }
+
+  // fresh elements, refering to the collections of the input
+  PFBlockAlgo::ElementList elements(const Input& in) {
+    edm::TestHandle<reco::PFClusterCollection> ecal(&in.ecal,edm::ProductID(1,1));
+    edm::TestHandle<reco::PFClusterCollection> hcal(&in.hcal,edm::ProductID(1,2));
+    edm::TestHandle<reco::PFClusterCollection> ho(&in.ho,edm::ProductID(1,3));
+    edm::TestHandle<reco::PFClusterCollection> hfem(&in.hfem,edm::ProductID(1,4));
+    edm::TestHandle<reco::PFClusterCollection> hfhad(&in.hfhad,edm::ProductID(1,5));
+    edm::TestHandle<reco::PFRecTrackCollection> tracks(&in.tracks,edm::ProductID(1,6));
+    edm::TestHandle<reco::SuperClusterCollection> superClusters(&in.superClusters,edm::ProductID(1,7));
+    edm::TestHandle<reco::PFDisplacedTrackerVertexCollection> vertices(&in.vertices,edm::ProductID(1,8));
+    edm::TestHandle<reco::ConversionCollection> conversions(&in.conversions,edm::ProductID(1,9));
+    edm::TestHandle<reco::VertexCompositeCandidateCollection> v0s(&in.v0s,edm::ProductID(1,10));
+
+    PFBlockAlgo::ElementList elts;
+    auto addClusters = [&](const edm::TestHandle<reco::PFClusterCollection>& handle,
+			   reco::PFBlockElement::Type type) {
+      for( unsigned i = 0; i < handle->size(); ++i ) {
+	auto elt = std::make_unique<reco::PFBlockElementCluster>(reco::PFClusterRef(handle,i),type);
+	if( type == reco::PFBlockElement::ECAL && in.ecalSuperCluster[i] >= 0 ) {
+	  elt->setSuperClusterRef(reco::SuperClusterRef(superClusters,in.ecalSuperCluster[i]));
+	}
+	elts.emplace_back(std::move(elt));
+      }
+    };
+    addClusters(ecal,reco::PFBlockElement::ECAL);
+    addClusters(hcal,reco::PFBlockElement::HCAL);
+    addClusters(ho,reco::PFBlockElement::HO);
+    addClusters(hfem,reco::PFBlockElement::HFEM);
+    addClusters(hfhad,reco::PFBlockElement::HFHAD);
+    for( unsigned i = 0; i < in.tracks.size(); ++i ) {
+      auto elt = std::make_unique<reco::PFBlockElementTrack>(reco::PFRecTrackRef(tracks,i));
+      int vertex, conversion, v0;
+      std::tie(vertex,conversion,v0) = in.trackRefs[i];
+      if( vertex >= 0 ) {
+	elt->setDisplacedVertexRef(reco::PFDisplacedTrackerVertexRef(vertices,vertex),
+				   i%2 ? reco::PFBlockElement::T_TO_DISP : reco::PFBlockElement::T_FROM_DISP);
+      }
+      if( conversion >= 0 ) {
+	elt->setConversionRef(reco::ConversionRef(conversions,conversion),reco::PFBlockElement::T_FROM_GAMMACONV);
+      }
+      if( v0 >= 0 ) {
+	elt->setV0Ref(reco::VertexCompositeCandidateRef(v0s,v0),reco::PFBlockElement::T_FROM_V0);
+      }
+      elts.emplace_back(std::move(elt));
+    }
+    return elts;
+  }
+
+  std::unique_ptr<reco::PFBlockCollection> blocks(const Input& in, bool useKDTree) {
+    PFBlockAlgo algo;
+    algo.setLinkers(linkers(useKDTree));
+    algo.buildElements(elements(in));
+    algo.findBlocks();
+    return algo.transferBlocks();
+  }
+
+  bool same(const reco::PFBlockCollection& blocks1, const reco::PFBlockCollection& blocks2) {
+    if( blocks1.size() != blocks2.size() ) return false;
+    for( unsigned b = 0; b < blocks1.size(); ++b ) {
+      const auto& elts1 = blocks1[b].elements();
+      const auto& elts2 = blocks2[b].elements();
+      if( elts1.size() != elts2.size() ) return false;
+      for( unsigned i = 0; i < elts1.size(); ++i ) {
+	if( elts1[i].type() != elts2[i].type() ||
+	    elts1[i].clusterRef() != elts2[i].clusterRef() ||
+	    elts1[i].trackRefPF() != elts2[i].trackRefPF() ) return false;
+	for( unsigned j = 0; j < i; ++j ) {
+	  if( blocks1[b].dist(i,j,blocks1[b].linkData()) !=
+	      blocks2[b].dist(i,j,blocks2[b].linkData()) ) return false;
+	}
+      }
+    }
+    return true;
+  }
+
+}
+
+int main() {
+  edmplugin::PluginManager::configure(edmplugin::standard::config());
+
+  std::mt19937 rng(42);
+  bool ok = true;
+  for( int event = 0; event < 5; ++event ) {
+    const Input in = generate(rng);
+    const auto withKDTree = blocks(in,true);
+    const auto withoutKDTree = blocks(in,false);
+
+    std::size_t largest = 0;
+    for( const auto& block : *withoutKDTree ) largest = std::max(largest,block.elements().size());
+    const bool sameBlocks = same(*withKDTree,*withoutKDTree);
+    std::cout << "event " << event << ": " << withoutKDTree->size() << " blocks, largest "
+	      << largest << " elements" << (sameBlocks ? "" : " MISMATCH") << std::endl;
+    ok &= sameBlocks;
+  }
+
+  assert(ok);
+  return ok ? 0 : 1;
+}
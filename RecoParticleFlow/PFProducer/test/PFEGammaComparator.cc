@@ -0,0 +1,140 @@
+// Compares the outputs of two PFEGammaProducer modules run on the same
+// blocks, e.g. with nParallelBlocks = 0 and nParallelBlocks = 4 (see
+// pfEGammaParallelBlocks_cfg.py).  The e-gamma candidates, their extras and
+// the refined superclusters must be identical and in the same order; the
+// references are compared by key, and the elements in blocks by value.  The
+// number of events with differences is printed at the end of the job, and
+// an exception is thrown if there is any.
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/EgammaReco/interface/SuperCluster.h"
+#include "DataFormats/EgammaReco/interface/SuperClusterFwd.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidate.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateFwd.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateEGammaExtra.h"
+#include "DataFormats/ParticleFlowCandidate/interface/PFCandidateEGammaExtraFwd.h"
+
+#include <string>
+
+class PFEGammaComparator : public edm::EDAnalyzer {
+public:
+  explicit PFEGammaComparator(const edm::ParameterSet&);
+  ~PFEGammaComparator() override {}
+
+private:
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+  template<class R>
+  static bool sameKey(const R& a, const R& b) {
+    return a.isNull() == b.isNull() && (a.isNull() || a.key() == b.key());
+  }
+  static bool same(const reco::PFCandidate&, const reco::PFCandidate&);
+  static bool same(const reco::PFCandidateEGammaExtra&, const reco::PFCandidateEGammaExtra&);
+  static bool same(const reco::SuperCluster&, const reco::SuperCluster&);
+  template<class C>
+  static bool same(const C& reference, const C& test, const std::string& what, const edm::Event&);
+
+  edm::EDGetTokenT<reco::PFCandidateCollection> referenceCandidatesToken_, testCandidatesToken_;
+  edm::EDGetTokenT<reco::PFCandidateEGammaExtraCollection> referenceExtrasToken_, testExtrasToken_;
+  edm::EDGetTokenT<reco::SuperClusterCollection> referenceSCsToken_, testSCsToken_;
+
+  unsigned int nEvents_=0, nDifferent_=0, nCandidates_=0;
+};
+
+PFEGammaComparator::PFEGammaComparator(const edm::ParameterSet& conf) {
+  const edm::InputTag reference = conf.getParameter<edm::InputTag>("reference");
+  const edm::InputTag test = conf.getParameter<edm::InputTag>("test");
+  referenceCandidatesToken_ = consumes<reco::PFCandidateCollection>(reference);
+  testCandidatesToken_ = consumes<reco::PFCandidateCollection>(test);
+  referenceExtrasToken_ = consumes<reco::PFCandidateEGammaExtraCollection>(reference);
+  testExtrasToken_ = consumes<reco::PFCandidateEGammaExtraCollection>(test);
+  referenceSCsToken_ = consumes<reco::SuperClusterCollection>(reference);
+  testSCsToken_ = consumes<reco::SuperClusterCollection>(test);
+}
+
+bool PFEGammaComparator::same(const reco::PFCandidate& a, const reco::PFCandidate& b) {
+  if (a.particleId() != b.particleId() || a.charge() != b.charge() || a.p4() != b.p4() ||
+      a.ecalEnergy() != b.ecalEnergy() || a.rawEcalEnergy() != b.rawEcalEnergy() ||
+      a.mva_e_pi() != b.mva_e_pi() ||
+      !sameKey(a.superClusterRef(), b.superClusterRef()) ||
+      !sameKey(a.gsfTrackRef(), b.gsfTrackRef()) ||
+      !sameKey(a.egammaExtraRef(), b.egammaExtraRef()))
+    return false;
+  // both modules read the same blocks
+  return a.elementsInBlocks() == b.elementsInBlocks();
+}
+
+bool PFEGammaComparator::same(const reco::PFCandidateEGammaExtra& a, const reco::PFCandidateEGammaExtra& b) {
+  return sameKey(a.superClusterRef(), b.superClusterRef()) &&
+    sameKey(a.gsfTrackRef(), b.gsfTrackRef()) &&
+    sameKey(a.kfTrackRef(), b.kfTrackRef()) &&
+    a.electronStatus() == b.electronStatus() &&
+    a.mvaVariables() == b.mvaVariables() &&
+    a.hadEnergy() == b.hadEnergy() &&
+    a.sigmaEtaEta() == b.sigmaEtaEta() &&
+    a.singleLegConvTrackRefMva().size() == b.singleLegConvTrackRefMva().size();
+}
+
+bool PFEGammaComparator::same(const reco::SuperCluster& a, const reco::SuperCluster& b) {
+  return a.energy() == b.energy() && a.rawEnergy() == b.rawEnergy() &&
+    a.preshowerEnergy() == b.preshowerEnergy() && a.position() == b.position() &&
+    a.etaWidth() == b.etaWidth() && a.phiWidth() == b.phiWidth() &&
+    a.clustersSize() == b.clustersSize() && a.hitsAndFractions() == b.hitsAndFractions();
+}
+
+template<class C>
+bool PFEGammaComparator::same(const C& reference, const C& test, const std::string& what, const edm::Event& iEvent) {
+  if (reference.size() != test.size()) {
+    edm::LogError("PFEGammaComparator") << iEvent.id() << ": " << reference.size() << " " << what
+                                        << " in the reference, " << test.size() << " in the test";
+    return false;
+  }
+  for (unsigned int i = 0; i < reference.size(); ++i) {
+    if (!same(reference[i], test[i])) {
+      edm::LogError("PFEGammaComparator") << iEvent.id() << ": " << what << " " << i << " differ";
+      return false;
+    }
+  }
+  return true;
+}
+
+void PFEGammaComparator::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+  edm::Handle<reco::PFCandidateCollection> referenceCandidates, testCandidates;
+  iEvent.getByToken(referenceCandidatesToken_, referenceCandidates);
+  iEvent.getByToken(testCandidatesToken_, testCandidates);
+  edm::Handle<reco::PFCandidateEGammaExtraCollection> referenceExtras, testExtras;
+  iEvent.getByToken(referenceExtrasToken_, referenceExtras);
+  iEvent.getByToken(testExtrasToken_, testExtras);
+  edm::Handle<reco::SuperClusterCollection> referenceSCs, testSCs;
+  iEvent.getByToken(referenceSCsToken_, referenceSCs);
+  iEvent.getByToken(testSCsToken_, testSCs);
+
+  ++nEvents_;
+  nCandidates_ += referenceCandidates->size();
+  // evaluate all three, to report every collection that differs
+  const bool sameCandidates = same(*referenceCandidates, *testCandidates, "candidates", iEvent);
+  const bool sameExtras = same(*referenceExtras, *testExtras, "extras", iEvent);
+  const bool sameSCs = same(*referenceSCs, *testSCs, "superclusters", iEvent);
+  if (!(sameCandidates && sameExtras && sameSCs)) ++nDifferent_;
+}
+
+void PFEGammaComparator::endJob()
+{
+  edm::LogPrint("PFEGammaComparator")
+    << nEvents_ << " events, " << nCandidates_ << " e-gamma candidates in the reference: "
+    << nDifferent_ << " events with differences";
+  if (nDifferent_)
+    throw cms::Exception("PFEGammaComparator")
+      << nDifferent_ << " events with different e-gamma candidates, extras or superclusters";
+}
+
+DEFINE_FWK_MODULE(PFEGammaComparator);
@@ -0,0 +1,50 @@
+# Run PFEGammaProducer twice on the blocks of the same RAW events, serially
+# (nParallelBlocks = 0, as in the reconstruction) and with nParallelBlocks = 4,
+# and check with PFEGammaComparator that the e-gamma candidates, extras and
+# refined superclusters are identical.
+#
+#   cmsRun pfEGammaParallelBlocks_cfg.py inputFiles=file:raw.root maxEvents=100
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.StandardSequences.Eras import eras
+
+options = VarParsing('analysis')
+options.parseArguments()
+
+process = cms.Process("TEST",eras.Run2_2017)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+# threads for the blocks processed concurrently
+process.options = cms.untracked.PSet(
+    numberOfThreads = cms.untracked.uint32(4),
+    numberOfStreams = cms.untracked.uint32(1)
+)
+
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag,'auto:phase1_2017_realistic', '')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+
+process.particleFlowEGammaParallel = process.particleFlowEGamma.clone(
+    nParallelBlocks = 4
+)
+
+process.comparePFEGamma = cms.EDAnalyzer("PFEGammaComparator",
+    reference = cms.InputTag("particleFlowEGamma"),
+    test = cms.InputTag("particleFlowEGammaParallel")
+)
+
+process.p = cms.Path(process.RawToDigi
+                     * process.reconstruction
+                     * process.particleFlowEGammaParallel
+                     * process.comparePFEGamma)
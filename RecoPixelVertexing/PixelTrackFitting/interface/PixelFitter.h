@@ -16,6 +16,11 @@ public:
     return fitter_->run(hits, region);
   }
 
+  void runBatch(const std::vector<const TrackingRecHit *>& hits, const std::vector<unsigned int>& offsets,
+                const TrackingRegion& region, std::vector<std::unique_ptr<reco::Track>>& tracks) const {
+    fitter_->runBatch(hits, offsets, region, tracks);
+  }
+
 private:
   std::unique_ptr<PixelFitterBase> fitter_;
 };
@@ -28,5 +28,21 @@ public:
       const edm::EventSetup& es,
       const std::vector<const TrackingRecHit *>& hits,
       const TrackingRegion& region) const { return run(es,hits,region); }
+
+  /// fit all the hit sets of a region at once: the hits of set i are
+  /// hits[offsets[i]] ... hits[offsets[i+1]-1], tracks[i] is null if the fit failed.
+  /// By default the sets are fitted one by one.
+  virtual void runBatch(const std::vector<const TrackingRecHit *>& hits,
+                        const std::vector<unsigned int>& offsets,
+                        const TrackingRegion& region,
+                        std::vector<std::unique_ptr<reco::Track>>& tracks) const {
+    auto nSets = offsets.empty() ? 0 : offsets.size()-1;
+    tracks.resize(nSets);
+    std::vector<const TrackingRecHit *> set;
+    for (unsigned int i = 0; i != nSets; ++i) {
+      set.assign(hits.begin()+offsets[i], hits.begin()+offsets[i+1]);
+      tracks[i] = run(set, region);
+    }
+  }
 };
 #endif
@@ -0,0 +1,40 @@
+#ifndef PixelFitterByRiemannParaboloid_H
+#define PixelFitterByRiemannParaboloid_H
+
+#include "RecoPixelVertexing/PixelTrackFitting/interface/PixelFitterBase.h"
+#include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
+#include "RecoTracker/TkTrackingRegions/interface/TrackingRegion.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+
+#include <vector>
+
+class TrackerTopology;
+
+/** Fit of the pixel tracks with a weighted Riemann fit of the circle in the
+ *  transverse plane and a straight line fit of z versus the arc length,
+ *  using all the hits of the track (instead of three as PixelFitterByHelixProjections).
+ *  The hit sets of a region are fitted together: the hits are unpacked once
+ *  into flat arrays and the fits of the tracks run in parallel.
+ */
+class PixelFitterByRiemannParaboloid final : public PixelFitterBase {
+public:
+  explicit PixelFitterByRiemannParaboloid(const edm::EventSetup *es, const MagneticField *field,
+                                          bool scaleErrorsForBPix1, float scaleFactor);
+  ~PixelFitterByRiemannParaboloid() override {}
+  std::unique_ptr<reco::Track> run(const std::vector<const TrackingRecHit *>& hits,
+                                   const TrackingRegion& region) const override;
+
+  void runBatch(const std::vector<const TrackingRecHit *>& hits,
+                const std::vector<unsigned int>& offsets,
+                const TrackingRegion& region,
+                std::vector<std::unique_ptr<reco::Track>>& tracks) const override;
+
+private:
+  const edm::EventSetup *theES;
+  const MagneticField *theField;
+  const bool thescaleErrorsForBPix1;
+  const float thescaleFactor;
+  TrackerTopology const * theTopo=nullptr;
+};
+#endif
@@ -0,0 +1,8 @@
+import FWCore.ParameterSet.Config as cms
+from Configuration.Eras.Modifier_phase1Pixel_cff import phase1Pixel
+
+from RecoPixelVertexing.PixelTrackFitting.pixelFitterByRiemannParaboloidDefault_cfi import pixelFitterByRiemannParaboloidDefault
+
+pixelFitterByRiemannParaboloid = pixelFitterByRiemannParaboloidDefault.clone()
+
+phase1Pixel.toModify( pixelFitterByRiemannParaboloid, scaleErrorsForBPix1 = True)
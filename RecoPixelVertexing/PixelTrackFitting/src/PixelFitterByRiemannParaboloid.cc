@@ -0,0 +1,108 @@
+#include "RecoPixelVertexing/PixelTrackFitting/interface/PixelFitterByRiemannParaboloid.h"
+
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+
+#include "DataFormats/GeometryVector/interface/GlobalPoint.h"
+#include "DataFormats/GeometryCommonDetAlgo/interface/GlobalError.h"
+#include "DataFormats/GeometryCommonDetAlgo/interface/Measurement1D.h"
+#include "DataFormats/SiPixelDetId/interface/PixelSubdetector.h"
+#include "Geometry/CommonDetUnit/interface/GeomDet.h"
+#include "Geometry/CommonDetUnit/interface/GeomDetType.h"
+#include "RecoTracker/TkMSParametrization/interface/PixelRecoUtilities.h"
+
+#include "MagneticField/Engine/interface/MagneticField.h"
+
+#include "RiemannFit.h"
+#include "RecoPixelVertexing/PixelTrackFitting/interface/PixelTrackBuilder.h"
+#include "RecoPixelVertexing/PixelTrackFitting/interface/PixelTrackErrorParam.h"
+
+#include "DataFormats/TrackerCommon/interface/TrackerTopology.h"
+#include "Geometry/Records/interface/TrackerTopologyRcd.h"
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+#include <algorithm>
+#include <cmath>
+
+PixelFitterByRiemannParaboloid::PixelFitterByRiemannParaboloid(const edm::EventSetup *es,
+                                                               const MagneticField *field,
+                                                               bool scaleErrorsForBPix1,
+                                                               float scaleFactor):
+  theES(es), theField(field),
+  thescaleErrorsForBPix1(scaleErrorsForBPix1), thescaleFactor(scaleFactor)
+{
+  //Retrieve tracker topology from geometry
+  edm::ESHandle<TrackerTopology> tTopo;
+  es->get<TrackerTopologyRcd>().get(tTopo);
+  theTopo = tTopo.product();
+}
+
+std::unique_ptr<reco::Track> PixelFitterByRiemannParaboloid::run(
+    const std::vector<const TrackingRecHit * > & hits,
+    const TrackingRegion & region) const
+{
+  std::vector<unsigned int> offsets = {0, static_cast<unsigned int>(hits.size())};
+  std::vector<std::unique_ptr<reco::Track>> tracks;
+  runBatch(hits, offsets, region, tracks);
+  return std::move(tracks.front());
+}
+
+void PixelFitterByRiemannParaboloid::runBatch(const std::vector<const TrackingRecHit *>& hits,
+                                              const std::vector<unsigned int>& offsets,
+                                              const TrackingRegion& region,
+                                              std::vector<std::unique_ptr<reco::Track>>& tracks) const
+{
+  unsigned int nSets = offsets.empty() ? 0 : offsets.size()-1;
+  tracks.clear();
+  tracks.resize(nSets);
+  if (nSets == 0) return;
+
+  // unpack the hits once, the access to the hits and to the geometry stays serial
+  riemannFit::Hits soa;
+  soa.resize(hits.size());
+  for (unsigned int i = 0; i != hits.size(); ++i) {
+    GlobalPoint p(hits[i]->globalPosition().basicVector()-region.origin().basicVector());
+    GlobalError e = hits[i]->globalPositionError();
+    double r2 = std::max(double(p.perp2()), 1.e-6);
+    soa.x[i] = p.x(); soa.y[i] = p.y(); soa.z[i] = p.z();
+    soa.varRPhi[i] = std::max((p.y()*p.y()*e.cxx() - 2.*p.x()*p.y()*e.cyx() + p.x()*p.x()*e.cyy())/r2, 1.e-12);
+    soa.isBarrel[i] = hits[i]->detUnit()->type().isBarrel();
+    soa.varZ[i] = soa.isBarrel[i] ? e.czz() : e.rerr(p);
+  }
+
+  const float invPtPerCurvature = PixelRecoUtilities::fieldInInvGev(*theES);
+
+  std::vector<riemannFit::Helix> results(nSets);
+  tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nSets),
+                    [&](const tbb::blocked_range<unsigned int>& range) {
+                      for (unsigned int i = range.begin(); i != range.end(); ++i)
+                        results[i] = riemannFit::helix(soa, offsets[i], offsets[i+1]-offsets[i], invPtPerCurvature);
+                    });
+
+  PixelTrackBuilder builder;
+  std::vector<const TrackingRecHit *> setHits;
+  for (unsigned int i = 0; i != nSets; ++i) {
+    auto const & res = results[i];
+    if (!res.ok) continue;
+    setHits.assign(hits.begin()+offsets[i], hits.begin()+offsets[i+1]);
+
+    // Rescale down the error for the inner pixel barrel layer for PhaseI,
+    // as in PixelFitterByHelixProjections
+    float errFactor = 1.;
+    if ( thescaleErrorsForBPix1
+         && (setHits[0]->geographicalId().subdetId() == PixelSubdetector::PixelBarrel) &&
+         (theTopo->pxbLayer(setHits[0]->geographicalId()) == 1))
+      errFactor = thescaleFactor;
+
+    PixelTrackErrorParam param(std::asinh(res.cotTheta), res.pt);
+    Measurement1D pt(res.pt, errFactor*param.errPt());
+    Measurement1D phi(res.phi, errFactor*param.errPhi());
+    Measurement1D cotTheta(res.cotTheta, errFactor*param.errCot());
+    Measurement1D tip(res.tip, errFactor*param.errTip());
+    Measurement1D zip(res.zip, errFactor*param.errZip());
+
+    tracks[i].reset(builder.build(pt, phi, cotTheta, tip, zip, res.chi2, res.charge, setHits, theField, region.origin()));
+  }
+}
@@ -67,21 +67,35 @@ void PixelTrackReconstruction::run(TracksWithTTRHs& tracks, edm::Event& ev, cons
     filter = hfilter.product();
   }
   
-  std::vector<const TrackingRecHit *> hits;hits.reserve(4); 
+  // all the hit sets of a region are given to the fitter at once,
+  // the hits of set i being hits[offsets[i]] ... hits[offsets[i+1]-1]
+  std::vector<const TrackingRecHit *> hits;
+  std::vector<unsigned int> offsets;
+  std::vector<std::unique_ptr<reco::Track>> fitted;
+  std::vector<const TrackingRecHit *> setHits; setHits.reserve(4);
   for(const auto& regionHitSets: hitSets) {
     const TrackingRegion& region = regionHitSets.region();
 
+    hits.clear(); offsets.clear();
+    offsets.push_back(0);
     for(const SeedingHitSet& tuplet: regionHitSets) {
-      /// FIXME at some point we need to migrate the fitter...
-      auto nHits = tuplet.size(); hits.resize(nHits);
-      for (unsigned int iHit = 0; iHit < nHits; ++iHit) hits[iHit] = tuplet[iHit];
-   
-      // fitting
-      std::unique_ptr<reco::Track> track = fitter.run(hits, region);
+      for (unsigned int iHit = 0; iHit < tuplet.size(); ++iHit) hits.push_back(tuplet[iHit]);
+      offsets.push_back(hits.size());
+    }
+
+    // fitting
+    fitter.runBatch(hits, offsets, region, fitted);
+
+    unsigned int iSet = 0;
+    for(const SeedingHitSet& tuplet: regionHitSets) {
+      std::unique_ptr<reco::Track> track = std::move(fitted[iSet]);
+      auto first = hits.begin()+offsets[iSet], last = hits.begin()+offsets[iSet+1];
+      ++iSet;
       if (!track) continue;
 
       if (filter) {
-	if (!(*filter)(track.get(), hits)) {
+        setHits.assign(first, last);
+	if (!(*filter)(track.get(), setHits)) {
 	  continue;
 	}
       }
@@ -0,0 +1,184 @@
+#ifndef RecoPixelVertexing_PixelTrackFitting_RiemannFit_H
+#define RecoPixelVertexing_PixelTrackFitting_RiemannFit_H
+
+#include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+
+#include "CommonTools/Utils/interface/DynArray.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/** Riemann fit of a circle and straight line fit in (arc length, z)
+ *  of the hits of one pixel track, in the transverse plane centered on the
+ *  origin of the region.
+ *  The circle fit maps the points on the paraboloid (x, y, x^2+y^2): the points
+ *  of a circle lie in a plane, found as the eigenvector of the smallest eigenvalue
+ *  of the weighted covariance of the mapped points (Frühwirth, Strandlie, Waltenberger).
+ *  Only fixed size 3x3 and 2x2 matrices are used, built from sums over the hits:
+ *  there is no allocation and the fits of many tracks can run concurrently.
+ *  helix() combines the two into the track parameters used by
+ *  PixelFitterByRiemannParaboloid.
+ */
+namespace riemannFit {
+
+  struct Circle {
+    double xc, yc, r;  // center and radius
+    double chi2;
+    bool isLine;       // the points are aligned (no curvature)
+  };
+
+  struct Line {
+    double z0, cotTheta;  // z at zero arc length and dz/ds
+    double chi2;
+  };
+
+  /// weighted circle fit of n points, w being the inverse variances in the transverse direction
+  inline Circle circle(int n, const double * x, const double * y, const double * w) {
+    double sw = 0;
+    Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+    for (int i = 0; i != n; ++i) {
+      Eigen::Vector3d p(x[i], y[i], x[i]*x[i]+y[i]*y[i]);
+      mean += w[i]*p;
+      sw += w[i];
+    }
+    mean /= sw;
+    Eigen::Matrix3d a = Eigen::Matrix3d::Zero();
+    for (int i = 0; i != n; ++i) {
+      Eigen::Vector3d d(x[i]-mean(0), y[i]-mean(1), x[i]*x[i]+y[i]*y[i]-mean(2));
+      a.noalias() += w[i]*(d*d.transpose());
+    }
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(a);
+    Eigen::Vector3d norm = solver.eigenvectors().col(0);  // smallest eigenvalue first
+    double c = -norm.dot(mean);
+
+    Circle ret;
+    ret.chi2 = 0;
+    // plane parallel to the z axis of the paraboloid: straight line in the transverse plane
+    ret.isLine = std::abs(norm(2)) < 1.e-12*std::sqrt(norm(0)*norm(0)+norm(1)*norm(1));
+    if (ret.isLine) {
+      ret.xc = ret.yc = ret.r = 0;
+      return ret;
+    }
+    ret.xc = -norm(0)/(2.*norm(2));
+    ret.yc = -norm(1)/(2.*norm(2));
+    ret.r = std::sqrt(std::max(0., ret.xc*ret.xc + ret.yc*ret.yc - c/norm(2)));
+    for (int i = 0; i != n; ++i) {
+      double d = std::hypot(x[i]-ret.xc, y[i]-ret.yc) - ret.r;
+      ret.chi2 += w[i]*d*d;
+    }
+    return ret;
+  }
+
+  /// weighted fit z = z0 + cotTheta*s, w being the inverse variances in z
+  inline Line line(int n, const double * s, const double * z, const double * w) {
+    Eigen::Matrix2d a = Eigen::Matrix2d::Zero();
+    Eigen::Vector2d b = Eigen::Vector2d::Zero();
+    for (int i = 0; i != n; ++i) {
+      a(0,0) += w[i]; a(0,1) += w[i]*s[i]; a(1,1) += w[i]*s[i]*s[i];
+      b(0) += w[i]*z[i]; b(1) += w[i]*s[i]*z[i];
+    }
+    a(1,0) = a(0,1);
+    Line ret;
+    ret.chi2 = 0;
+    double det = a.determinant();
+    if (std::abs(det) < 1.e-12*a(0,0)*a(1,1)) {
+      ret.z0 = b(0)/a(0,0);
+      ret.cotTheta = 0;
+    } else {
+      Eigen::Vector2d par = a.inverse()*b;
+      ret.z0 = par(0);
+      ret.cotTheta = par(1);
+    }
+    for (int i = 0; i != n; ++i) {
+      double d = z[i] - ret.z0 - ret.cotTheta*s[i];
+      ret.chi2 += w[i]*d*d;
+    }
+    return ret;
+  }
+
+  // the hits of all the sets of a region, in the frame centered on the region origin
+  struct Hits {
+    std::vector<double> x, y, z;
+    std::vector<double> varRPhi;  // variance in the transverse direction
+    std::vector<double> varZ;     // variance in z (barrel) or r (endcap)
+    std::vector<bool> isBarrel;
+
+    void resize(unsigned int n) {
+      x.resize(n); y.resize(n); z.resize(n);
+      varRPhi.resize(n); varZ.resize(n); isBarrel.resize(n);
+    }
+  };
+
+  struct Helix {
+    float pt, phi, cotTheta, tip, zip, chi2;
+    int charge;
+    bool ok = false;
+  };
+
+  inline float phi(float xC, float yC, int charge) {
+    return  (charge>0) ? std::atan2(xC,-yC) :  std::atan2(-xC,yC);
+  }
+
+  /// fit of the n hits from first, ordered along the track; pt = invPtPerCurvature/curvature
+  inline Helix helix(const Hits & h, unsigned int first, unsigned int n, float invPtPerCurvature) {
+    Helix ret;
+    if (n < 3) return ret;
+
+    const double * x = &h.x[first];
+    const double * y = &h.y[first];
+    const double * z = &h.z[first];
+
+    // the cross product will tell me...
+    unsigned int mid = n/2;
+    double dir = (x[mid]-x[0])*(y[n-1]-y[mid]) - (y[mid]-y[0])*(x[n-1]-x[mid]);
+    ret.charge = (dir>0) ? -1 : 1;
+
+    declareDynArray(double, n, w);
+    for (unsigned int i = 0; i != n; ++i) w[i] = 1./h.varRPhi[first+i];
+    auto circ = circle(n, x, y, w.data());
+
+    // arc length from the point of closest approach to the origin
+    declareDynArray(double, n, s);
+    float curvature = circ.isLine ? 0.f : 1.f/circ.r;
+    if (curvature > 1.e-4f && invPtPerCurvature > 0.01f) {
+      float invPt = curvature*invPtPerCurvature;
+      ret.pt = (invPt > 1.e-4f) ? 1.f/invPt : 1.e4f;
+      double cMag = std::hypot(circ.xc, circ.yc);
+      ret.tip = ret.charge * (cMag-circ.r);
+      ret.phi = phi(circ.xc, circ.yc, ret.charge);
+      double ux = -circ.xc/cMag, uy = -circ.yc/cMag;
+      for (unsigned int i = 0; i != n; ++i) {
+        double vx = x[i]-circ.xc, vy = y[i]-circ.yc;
+        s[i] = circ.r*std::abs(std::atan2(ux*vy-uy*vx, ux*vx+uy*vy));
+      }
+    } else {
+      ret.pt = 1.e4f;
+      ret.phi = std::atan2(y[n-1]-y[0], x[n-1]-x[0]);
+      double ux = std::cos(ret.phi), uy = std::sin(ret.phi);
+      ret.tip = -x[0]*uy + y[0]*ux;
+      for (unsigned int i = 0; i != n; ++i) s[i] = x[i]*ux+y[i]*uy;
+    }
+
+    // the endcap hits measure r: the error in z follows from the slope
+    double ds = s[n-1]-s[0];
+    double simpleCot2 = std::abs(ds) > 1.e-3 ? (z[n-1]-z[0])*(z[n-1]-z[0])/(ds*ds) : 0.;
+    for (unsigned int i = 0; i != n; ++i) {
+      double var = h.isBarrel[first+i] ? h.varZ[first+i] : h.varZ[first+i]*simpleCot2;
+      w[i] = 1./std::max(var, 1.e-12);
+    }
+    auto lin = line(n, s.data(), z, w.data());
+
+    ret.cotTheta = lin.cotTheta;
+    ret.zip = lin.z0;
+    ret.chi2 = circ.chi2 + lin.chi2;
+    ret.ok = std::isfinite(ret.pt) && std::isfinite(ret.phi) && std::isfinite(ret.tip)
+      && std::isfinite(ret.cotTheta) && std::isfinite(ret.zip);
+    return ret;
+  }
+
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Fit with riemannFit::helix (the fit of PixelFitterByRiemannParaboloid) the
+// hits of tracks generated on known helices, of both charges and with
+// impact parameters, on four barrel layers.  Without smearing the generated
+// curvature, phi, tip, cot(theta) and zip must be recovered up to rounding;
+// with a smearing of the hits in r-phi and z the residuals must be unbiased
+// and their spread of the order of the expected resolution.
+
+#include "RecoPixelVertexing/PixelTrackFitting/src/RiemannFit.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace {
+
+  struct Track {
+    int charge;
+    double curvature, phi, tip, cotTheta, zip;
+  };
+
+  constexpr double sigmaRPhi = 15.e-4, sigmaZ = 20.e-4;  // cm
+  constexpr unsigned int nHits = 4;
+  constexpr double arcLengths[nHits] = {4.4, 7.3, 10.2, 16.0};  // cm
+
+  // the hits of the track, in the order of the arc length
+  void generate(const Track & t, std::mt19937 * rng, riemannFit::Hits & hits) {
+    std::normal_distribution<double> gauss(0.,1.);
+    const double r = 1./t.curvature;
+    // point of closest approach and center: positive tracks turn clockwise
+    const double ux = std::sin(t.phi), uy = -std::cos(t.phi);
+    const double px = t.tip*ux, py = t.tip*uy;
+    const double cx = px + t.charge*r*ux, cy = py + t.charge*r*uy;
+    hits.resize(nHits);
+    for (unsigned int i = 0; i != nHits; ++i) {
+      const double s = arcLengths[i];
+      const double a = -t.charge*s/r;
+      const double dx = px-cx, dy = py-cy;
+      double x = cx + dx*std::cos(a) - dy*std::sin(a);
+      double y = cy + dx*std::sin(a) + dy*std::cos(a);
+      double z = t.zip + t.cotTheta*s;
+      if (rng) {
+        const double rho = std::hypot(x,y), d = sigmaRPhi*gauss(*rng);
+        const double ex = -y/rho, ey = x/rho;
+        x += d*ex;
+        y += d*ey;
+        z += sigmaZ*gauss(*rng);
+      }
+      hits.x[i] = x; hits.y[i] = y; hits.z[i] = z;
+      hits.varRPhi[i] = sigmaRPhi*sigmaRPhi;
+      hits.varZ[i] = sigmaZ*sigmaZ;
+      hits.isBarrel[i] = true;
+    }
+  }
+
+  double dPhi(double a, double b) {
+    return std::remainder(a-b, 2.*M_PI);
+  }
+
+  Track randomTrack(std::mt19937 & rng) {
+    std::uniform_real_distribution<double> flat(0.,1.);
+    Track t;
+    t.charge = flat(rng) < 0.5 ? -1 : 1;
+    t.curvature = 1./(50.+2000.*flat(rng));
+    t.phi = M_PI*(2.*flat(rng)-1.);
+    t.tip = 0.2*(2.*flat(rng)-1.);
+    t.cotTheta = 3.*(2.*flat(rng)-1.);
+    t.zip = 10.*(2.*flat(rng)-1.);
+    return t;
+  }
+
+  struct Stat {
+    double sum = 0, sum2 = 0;
+    int n = 0;
+    void fill(double x) { sum += x; sum2 += x*x; ++n; }
+    double mean() const { return sum/n; }
+    double rms() const { return std::sqrt(sum2/n - mean()*mean()); }
+    // the mean is compatible with zero and the spread below maxRms
+    bool ok(double maxRms) const { return std::abs(mean()) < 5.*rms()/std::sqrt(n) && rms() < maxRms; }
+  };
+
+}
+
+int main() {
+  std::mt19937 rng(42);
+  riemannFit::Hits hits;
+  bool ok = true;
+
+  // exact hits: with invPtPerCurvature = 1, pt is the radius
+  int failed = 0;
+  for (int i = 0; i != 1000; ++i) {
+    const Track t = randomTrack(rng);
+    generate(t, nullptr, hits);
+    const auto fit = riemannFit::helix(hits, 0, nHits, 1.f);
+    const bool good = fit.ok && fit.charge == t.charge
+      && std::abs(1./fit.pt - t.curvature) < 1.e-5*t.curvature
+      && std::abs(dPhi(fit.phi, t.phi)) < 1.e-5
+      && std::abs(fit.tip - t.tip) < 1.e-5
+      && std::abs(fit.cotTheta - t.cotTheta) < 1.e-5
+      && std::abs(fit.zip - t.zip) < 1.e-4;
+    if (!good) {
+      ++failed;
+      std::cout << "exact hits: charge " << t.charge << '/' << fit.charge << " curvature " << t.curvature << '/' << 1./fit.pt
+                << " phi " << t.phi << '/' << fit.phi << " tip " << t.tip << '/' << fit.tip
+                << " cotTheta " << t.cotTheta << '/' << fit.cotTheta << " zip " << t.zip << '/' << fit.zip << std::endl;
+    }
+  }
+  std::cout << "exact hits: " << failed << " failed fits" << std::endl;
+  ok &= failed == 0;
+
+  // smeared hits: residuals of the parameters
+  Stat curvature, phi, tip, cotTheta, zip;
+  int wrongCharge = 0;
+  for (int i = 0; i != 10000; ++i) {
+    Track t = randomTrack(rng);
+    t.curvature = 1./(100.+400.*std::uniform_real_distribution<double>(0.,1.)(rng));
+    generate(t, &rng, hits);
+    const auto fit = riemannFit::helix(hits, 0, nHits, 1.f);
+    if (!fit.ok || fit.charge != t.charge) { ++wrongCharge; continue; }
+    curvature.fill(fit.charge/fit.pt - t.charge*t.curvature);
+    phi.fill(dPhi(fit.phi, t.phi));
+    tip.fill(fit.tip - t.tip);
+    cotTheta.fill(fit.cotTheta - t.cotTheta);
+    zip.fill(fit.zip - t.zip);
+  }
+  std::cout << "smeared hits: " << wrongCharge << " failed fits or wrong charges" << std::endl
+            << "  curvature " << curvature.mean() << " +- " << curvature.rms() << std::endl
+            << "  phi       " << phi.mean() << " +- " << phi.rms() << std::endl
+            << "  tip       " << tip.mean() << " +- " << tip.rms() << std::endl
+            << "  cotTheta  " << cotTheta.mean() << " +- " << cotTheta.rms() << std::endl
+            << "  zip       " << zip.mean() << " +- " << zip.rms() << std::endl;
+  ok &= wrongCharge == 0;
+  // about twice the resolutions expected for 15 um over a 12 cm lever arm
+  ok &= curvature.ok(2.e-4) && phi.ok(2.e-3) && tip.ok(1.e-2) && cotTheta.ok(5.e-4) && zip.ok(5.e-3);
+
+  assert(ok);
+  return ok ? 0 : 1;
+}
@@ -2,10 +2,21 @@
 
 #include<queue>
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+namespace {
+  constexpr unsigned int cellsPerTask = 256;
+}
+
 
 void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
 		const float thetaCut, const float phiCut, const float hardPtCut)
 {
+        if (isParallel) {
+          createAndConnectCellsParallel(hitDoublets, region, thetaCut, phiCut, hardPtCut);
+          return;
+        }
         int tsize=0;
         for ( auto hd :  hitDoublets) tsize+=hd->size();
         allCells.reserve(tsize);
@@ -101,6 +112,10 @@ void CellularAutomaton::createAndConnectCells(const std::vector<const HitDoublet
 
 void CellularAutomaton::evolve(const unsigned int minHitsPerNtuplet)
 {
+  if (isParallel) {
+    evolveParallel(minHitsPerNtuplet);
+    return;
+  }
   allStatus.resize(allCells.size());
   
   
@@ -154,6 +169,10 @@ void CellularAutomaton::findNtuplets(
 		std::vector<CACell::CAntuplet>& foundNtuplets,
 		const unsigned int minHitsPerNtuplet)
 {
+	if (isParallel) {
+		findNtupletsParallel(foundNtuplets, minHitsPerNtuplet);
+		return;
+	}
 	CACell::CAntuple tmpNtuplet;
 	tmpNtuplet.reserve(minHitsPerNtuplet);
 
@@ -263,3 +282,222 @@ void CellularAutomaton::findTriplets(const std::vector<const HitDoublets*>& hitD
 	}
 
 }
+
+
+// Same cells, neighbours and ntuplets as the serial version:
+// the cells are created serially in the same order, then every cell looks for its inner
+// neighbours concurrently, and the outer neighbour lists are filled in the order of the
+// cells, as tagAsOuterNeighbor does when the cells are created one after the other.
+void CellularAutomaton::createAndConnectCellsParallel(const std::vector<const HitDoublets *>& hitDoublets, const TrackingRegion& region,
+		const float thetaCut, const float phiCut, const float hardPtCut)
+{
+	int tsize=0;
+	for ( auto hd :  hitDoublets) tsize+=hd->size();
+	allCells.reserve(tsize);
+	theCellHits.resize(tsize);
+	// candidate inner neighbours of each cell
+	std::vector<const std::vector<unsigned int> *> innerCandidates;
+	innerCandidates.reserve(tsize);
+
+	unsigned int cellId = 0;
+	std::vector<bool> alreadyVisitedLayerPairs(theLayerGraph.theLayerPairs.size(), false);
+	for (int rootVertex : theLayerGraph.theRootLayers)
+	{
+		std::queue<int> LayerPairsToVisit;
+		for (int LayerPair : theLayerGraph.theLayers[rootVertex].theOuterLayerPairs)
+		{
+			LayerPairsToVisit.push(LayerPair);
+		}
+
+		while (!LayerPairsToVisit.empty())
+		{
+			auto currentLayerPair = LayerPairsToVisit.front();
+			auto & currentLayerPairRef = theLayerGraph.theLayerPairs[currentLayerPair];
+			auto & currentInnerLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[0]];
+			auto & currentOuterLayerRef = theLayerGraph.theLayers[currentLayerPairRef.theLayers[1]];
+			bool allInnerLayerPairsAlreadyVisited	{ true };
+
+			for (auto innerLayerPair : currentInnerLayerRef.theInnerLayerPairs)
+			{
+				allInnerLayerPairsAlreadyVisited &=
+						alreadyVisitedLayerPairs[innerLayerPair];
+			}
+
+			if (alreadyVisitedLayerPairs[currentLayerPair] == false
+					&& allInnerLayerPairsAlreadyVisited)
+			{
+				const HitDoublets* doubletLayerPairId =
+						hitDoublets[currentLayerPair];
+				auto numberOfDoublets = doubletLayerPairId->size();
+				currentLayerPairRef.theFoundCells[0] = cellId;
+				currentLayerPairRef.theFoundCells[1] = cellId+numberOfDoublets;
+				for (unsigned int i = 0; i < numberOfDoublets; ++i)
+				{
+					allCells.emplace_back(doubletLayerPairId, i,
+							      doubletLayerPairId->innerHitId(i),
+							      doubletLayerPairId->outerHitId(i));
+					auto const & cell = allCells.back();
+					theCellHits.innerX[cellId] = cell.getInnerX();
+					theCellHits.innerY[cellId] = cell.getInnerY();
+					theCellHits.innerZ[cellId] = cell.getInnerZ();
+					theCellHits.innerR[cellId] = cell.getInnerR();
+					theCellHits.outerX[cellId] = cell.getOuterX();
+					theCellHits.outerY[cellId] = cell.getOuterY();
+					theCellHits.outerZ[cellId] = cell.getOuterZ();
+					theCellHits.outerR[cellId] = cell.getOuterR();
+
+					currentOuterLayerRef.isOuterHitOfCell[doubletLayerPairId->outerHitId(i)].push_back(cellId);
+					// all the inner layer pairs are already visited: the list is complete
+					innerCandidates.push_back(&currentInnerLayerRef.isOuterHitOfCell[doubletLayerPairId->innerHitId(i)]);
+					cellId++;
+				}
+				for (auto outerLayerPair : currentOuterLayerRef.theOuterLayerPairs)
+				{
+					LayerPairsToVisit.push(outerLayerPair);
+				}
+
+				alreadyVisitedLayerPairs[currentLayerPair] = true;
+			}
+			LayerPairsToVisit.pop();
+		}
+	}
+	const unsigned int nCells = cellId;
+
+	// inner neighbours of cell i: innerNeighbors[candidatesBegin[i]..candidatesBegin[i]+nInnerNeighbors[i]]
+	std::vector<unsigned int> candidatesBegin(nCells+1, 0);
+	for (unsigned int i = 0; i < nCells; ++i)
+		candidatesBegin[i+1] = candidatesBegin[i] + innerCandidates[i]->size();
+	std::vector<unsigned int> innerNeighbors(candidatesBegin[nCells]);
+	std::vector<unsigned int> nInnerNeighbors(nCells, 0);
+
+	const float ptmin = region.ptMin();
+	const float region_origin_x = region.origin().x();
+	const float region_origin_y = region.origin().y();
+	const float region_origin_radius = region.originRBound();
+	auto const & h = theCellHits;
+	tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nCells, cellsPerTask),
+		[&](const tbb::blocked_range<unsigned int>& range) {
+			for (auto i = range.begin(); i < range.end(); ++i)
+			{
+				auto out = &innerNeighbors[candidatesBegin[i]];
+				unsigned int n = 0;
+				for (auto oc : *innerCandidates[i])
+				{
+					if (CACell::areAlignedRZ(h.innerR[oc], h.innerZ[oc], h.innerR[i], h.innerZ[i], h.outerR[i], h.outerZ[i], ptmin, thetaCut)
+					    && CACell::haveSimilarCurvature(h.innerX[oc], h.innerY[oc], h.innerX[i], h.innerY[i], h.outerX[i], h.outerY[i],
+									    ptmin, region_origin_x, region_origin_y, region_origin_radius, phiCut, hardPtCut))
+						out[n++] = oc;
+				}
+				nInnerNeighbors[i] = n;
+			}
+		});
+
+	// outer neighbours, ordered by cell
+	theOuterNeighborsBegin.assign(nCells+1, 0);
+	for (unsigned int i = 0; i < nCells; ++i)
+		for (unsigned int k = 0; k < nInnerNeighbors[i]; ++k)
+			++theOuterNeighborsBegin[innerNeighbors[candidatesBegin[i]+k]+1];
+	for (unsigned int i = 0; i < nCells; ++i)
+		theOuterNeighborsBegin[i+1] += theOuterNeighborsBegin[i];
+	theOuterNeighbors.resize(theOuterNeighborsBegin[nCells]);
+	std::vector<unsigned int> next(theOuterNeighborsBegin.begin(), theOuterNeighborsBegin.end()-1);
+	for (unsigned int i = 0; i < nCells; ++i)
+		for (unsigned int k = 0; k < nInnerNeighbors[i]; ++k)
+			theOuterNeighbors[next[innerNeighbors[candidatesBegin[i]+k]]++] = i;
+}
+
+
+// each step reads the states of the previous one only: the cells can be evolved in any order
+void CellularAutomaton::evolveParallel(const unsigned int minHitsPerNtuplet)
+{
+  const unsigned int nCells = allCells.size();
+  allStatus.resize(nCells);
+
+  auto evolveCell = [&](unsigned int i) {
+    auto & status = allStatus[i];
+    status.hasSameStateNeighbors = 0;
+    for (auto k = theOuterNeighborsBegin[i]; k < theOuterNeighborsBegin[i+1]; ++k)
+      if (allStatus[theOuterNeighbors[k]].getCAState() == status.theCAState) {
+	status.hasSameStateNeighbors = 1;
+	break;
+      }
+  };
+
+  unsigned int numberOfIterations = minHitsPerNtuplet - 2;
+  // keeping the last iteration for later
+  for (unsigned int iteration = 0; iteration < numberOfIterations - 1; ++iteration)
+    {
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nCells, cellsPerTask),
+			[&](const tbb::blocked_range<unsigned int>& range) {
+			  for (auto i = range.begin(); i < range.end(); ++i) evolveCell(i);
+			});
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nCells, cellsPerTask),
+			[&](const tbb::blocked_range<unsigned int>& range) {
+			  for (auto i = range.begin(); i < range.end(); ++i) allStatus[i].updateState();
+			});
+    }
+
+  //last iteration, on the cells of the root layer pairs (whose neighbours are not among them)
+  for(int rootLayerId : theLayerGraph.theRootLayers)
+    {
+      for(int rootLayerPair: theLayerGraph.theLayers[rootLayerId].theOuterLayerPairs)
+	{
+	  auto foundCells = theLayerGraph.theLayerPairs[rootLayerPair].theFoundCells;
+	  tbb::parallel_for(tbb::blocked_range<unsigned int>(foundCells[0], foundCells[1], cellsPerTask),
+			    [&](const tbb::blocked_range<unsigned int>& range) {
+			      for (auto i = range.begin(); i < range.end(); ++i) {
+				evolveCell(i);
+				allStatus[i].updateState();
+			      }
+			    });
+	  for (auto i =foundCells[0]; i<foundCells[1]; ++i)
+	    {
+	      if (allStatus[i].isRootCell(minHitsPerNtuplet - 2))
+		{
+		  theRootCells.push_back(i);
+		}
+	    }
+	}
+    }
+}
+
+
+// the ntuplets of each root cell are found concurrently and then appended in the order of the root cells
+void CellularAutomaton::findNtupletsParallel(
+		std::vector<CACell::CAntuplet>& foundNtuplets,
+		const unsigned int minHitsPerNtuplet)
+{
+	std::vector<std::vector<CACell::CAntuplet>> rootNtuplets(theRootCells.size());
+	tbb::parallel_for(tbb::blocked_range<unsigned int>(0, theRootCells.size()),
+		[&](const tbb::blocked_range<unsigned int>& range) {
+			CACell::CAntuple tmpNtuplet;
+			tmpNtuplet.reserve(minHitsPerNtuplet);
+			for (auto r = range.begin(); r < range.end(); ++r)
+			{
+				tmpNtuplet.clear();
+				tmpNtuplet.push_back(theRootCells[r]);
+				findNtuplets(theRootCells[r], rootNtuplets[r], tmpNtuplet, minHitsPerNtuplet);
+			}
+		});
+	for (auto & ntuplets : rootNtuplets)
+		for (auto & ntuplet : ntuplets)
+			foundNtuplets.push_back(std::move(ntuplet));
+}
+
+
+// as CACell::findNtuplets, on the flattened outer neighbours
+void CellularAutomaton::findNtuplets(unsigned int cell, std::vector<CACell::CAntuplet>& foundNtuplets,
+		CACell::CAntuple& tmpNtuplet, const unsigned int minHitsPerNtuplet) const
+{
+	if (tmpNtuplet.size() == minHitsPerNtuplet - 1)
+	{
+		foundNtuplets.push_back(tmpNtuplet);
+		return;
+	}
+	for (auto k = theOuterNeighborsBegin[cell]; k < theOuterNeighborsBegin[cell+1]; ++k)
+	{
+		tmpNtuplet.push_back(theOuterNeighbors[k]);
+		findNtuplets(theOuterNeighbors[k], foundNtuplets, tmpNtuplet, minHitsPerNtuplet);
+		tmpNtuplet.pop_back();
+	}
+}
@@ -8,8 +8,10 @@
 class CellularAutomaton
 {
 public:
-  CellularAutomaton(CAGraph& graph)
-    : theLayerGraph(graph)
+  // parallel: build the cells, their neighbours and the ntuplets with TBB,
+  // on the flattened cells and neighbours below (same ntuplets, same order)
+  CellularAutomaton(CAGraph& graph, bool parallel=false)
+    : theLayerGraph(graph), isParallel(parallel)
   {
     
   }
@@ -25,13 +27,34 @@ public:
 		    const float thetaCut, const float phiCut, const float hardPtCut);
   
 private:
+  void createAndConnectCellsParallel(const std::vector<const HitDoublets *>&,
+				     const TrackingRegion&, const float, const float, const float);
+  void evolveParallel(const unsigned int);
+  void findNtupletsParallel(std::vector<CACell::CAntuplet>&, const unsigned int);
+  void findNtuplets(unsigned int cell, std::vector<CACell::CAntuplet>&, CACell::CAntuple&, const unsigned int) const;
+
   CAGraph & theLayerGraph;
+  const bool isParallel;
 
   std::vector<CACell> allCells;
   std::vector<CACellStatus> allStatus;
 
   std::vector<unsigned int> theRootCells;
   std::vector<std::vector<CACell*> > theNtuplets;
+
+  // parallel evaluation: hit coordinates of the cells
+  struct CellHits {
+    void resize(unsigned int n) {
+      innerX.resize(n); innerY.resize(n); innerZ.resize(n); innerR.resize(n);
+      outerX.resize(n); outerY.resize(n); outerZ.resize(n); outerR.resize(n);
+    }
+    std::vector<float> innerX, innerY, innerZ, innerR;
+    std::vector<float> outerX, outerY, outerZ, outerR;
+  };
+  CellHits theCellHits;
+  // outer neighbours of cell i: theOuterNeighbors[theOuterNeighborsBegin[i]..theOuterNeighborsBegin[i+1]]
+  std::vector<unsigned int> theOuterNeighborsBegin;
+  std::vector<unsigned int> theOuterNeighbors;
   
 };
 
@@ -0,0 +1,144 @@
+// Check that the parallel evaluation of CellularAutomaton (CAParallel = True)
+// finds the same ntuplets, in the same order, as the serial one.  The hits
+// are generated on four barrel layers, along helices from the beam spot and
+// as random noise; the doublets are all the pairs of hits of the layer pairs
+// 1-2, 2-3, 3-4, 1-3 and 2-4 that are compatible in phi and z, so that the
+// cells have many candidate neighbours and several paths to the same hits.
+
+#include "RecoPixelVertexing/PixelTriplets/plugins/CellularAutomaton.cc"
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+#include "RecoTracker/TkTrackingRegions/interface/GlobalTrackingRegion.h"
+#include "TrackingTools/DetLayers/interface/BarrelDetLayer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+  // a barrel layer without geometry, for RecHitsSortedInPhi
+  class TestLayer final : public BarrelDetLayer {
+  public:
+    TestLayer() : BarrelDetLayer(false) {}
+    SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+    const std::vector<const GeometricSearchDet*>& components() const override { return theComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return theBasicComponents; }
+  private:
+    std::vector<const GeometricSearchDet*> theComponents;
+    std::vector<const GeomDet*> theBasicComponents;
+  };
+
+  struct Point { float x, y, z; };
+
+  constexpr unsigned int nLayers = 4;
+  constexpr float radii[nLayers] = {3., 7., 11., 16.};  // cm
+  const std::vector<std::pair<int,int>> layerPairs = {{0,1},{1,2},{2,3},{0,2},{1,3}};
+
+  std::vector<std::vector<Point>> generate(std::mt19937& rng, unsigned int nTracks, unsigned int nNoise) {
+    std::uniform_real_distribution<float> flat(0.,1.);
+    std::vector<std::vector<Point>> points(nLayers);
+    for (unsigned int t = 0; t < nTracks; ++t) {
+      const float phi = 2.f*M_PI*flat(rng), cotTheta = 2.f*flat(rng)-1.f;
+      const float curvature = 0.01f*(flat(rng)-0.5f), z0 = 10.f*(flat(rng)-0.5f);
+      for (unsigned int l = 0; l < nLayers; ++l) {
+	const float p = phi + curvature*radii[l];
+	points[l].push_back({radii[l]*std::cos(p), radii[l]*std::sin(p), z0+cotTheta*radii[l]});
+      }
+    }
+    for (unsigned int l = 0; l < nLayers; ++l) {
+      for (unsigned int k = 0; k < nNoise; ++k) {
+	const float p = 2.f*M_PI*flat(rng);
+	points[l].push_back({radii[l]*std::cos(p), radii[l]*std::sin(p), 60.f*(flat(rng)-0.5f)});
+      }
+    }
+    return points;
+  }
+
+  // the hits of a layer, sorted in phi as by the RecHitsSortedInPhi constructor
+  std::unique_ptr<RecHitsSortedInPhi> sortedHits(std::vector<Point> points, const DetLayer* layer) {
+    auto hits = std::make_unique<RecHitsSortedInPhi>(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0,0,0), layer);
+    std::sort(points.begin(), points.end(),
+	      [](const Point& a, const Point& b) { return std::atan2(a.y,a.x) < std::atan2(b.y,b.x); });
+    for (auto const& p : points) {
+      const float r = std::hypot(p.x,p.y);
+      hits->theHits.emplace_back(std::atan2(p.y,p.x));
+      hits->x.push_back(p.x); hits->y.push_back(p.y); hits->z.push_back(p.z);
+      hits->drphi.push_back(15.e-4);
+      hits->u.push_back(r); hits->v.push_back(p.z);
+      hits->du.push_back(0.); hits->dv.push_back(20.e-4);
+      hits->lphi.push_back(std::atan2(p.y,p.x));
+    }
+    return hits;
+  }
+
+  // all the pairs compatible in phi and with a straight line in rz within 8 cm at the outer layer, sorted by outer hit
+  std::unique_ptr<HitDoublets> doublets(const RecHitsSortedInPhi& inner, const RecHitsSortedInPhi& outer) {
+    auto result = std::make_unique<HitDoublets>(inner, outer);
+    for (unsigned int o = 0; o < outer.size(); ++o) {
+      for (unsigned int i = 0; i < inner.size(); ++i) {
+	const float dPhi = std::remainder(inner.phi(i)-outer.phi(o), float(2.*M_PI));
+	if (std::abs(dPhi) < 0.03f && std::abs(inner.z[i]/inner.u[i]*outer.u[o]-outer.z[o]) < 8.f) result->add(i,o);
+      }
+    }
+    return result;
+  }
+
+  CAGraph graph(const std::vector<std::unique_ptr<RecHitsSortedInPhi>>& hits) {
+    CAGraph g;
+    for (unsigned int l = 0; l < nLayers; ++l) g.theLayers.emplace_back(std::to_string(l), hits[l]->size());
+    for (unsigned int p = 0; p < layerPairs.size(); ++p) {
+      g.theLayerPairs.emplace_back(layerPairs[p].first, layerPairs[p].second);
+      g.theLayers[layerPairs[p].first].theOuterLayerPairs.push_back(p);
+      g.theLayers[layerPairs[p].second].theInnerLayerPairs.push_back(p);
+    }
+    g.theRootLayers.push_back(0);
+    return g;
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(42);
+  const GlobalTrackingRegion region(0.5, GlobalPoint(0,0,0), 0.2, 15.);
+  const float thetaCut = 0.002, phiCut = 0.2, hardPtCut = 0.;
+  std::vector<TestLayer> layers(nLayers);
+  bool ok = true;
+
+  for (int event = 0; event < 4; ++event) {
+    const auto points = generate(rng, 200+400*event, 300*event);
+    std::vector<std::unique_ptr<RecHitsSortedInPhi>> hits;
+    for (unsigned int l = 0; l < nLayers; ++l) hits.push_back(sortedHits(points[l], &layers[l]));
+    std::vector<std::unique_ptr<HitDoublets>> pairDoublets;
+    std::vector<const HitDoublets*> hitDoublets;
+    for (auto const& lp : layerPairs) {
+      pairDoublets.push_back(doublets(*hits[lp.first], *hits[lp.second]));
+      hitDoublets.push_back(pairDoublets.back().get());
+    }
+
+    for (unsigned int minHitsPerNtuplet : {3, 4}) {
+      std::vector<CACell::CAntuplet> ntuplets[2];
+      std::size_t nCells[2];
+      for (bool parallel : {false, true}) {
+	CAGraph g = graph(hits);
+	CellularAutomaton ca(g, parallel);
+	ca.createAndConnectCells(hitDoublets, region, thetaCut, phiCut, hardPtCut);
+	ca.evolve(minHitsPerNtuplet);
+	ca.findNtuplets(ntuplets[parallel], minHitsPerNtuplet);
+	nCells[parallel] = ca.getAllCells().size();
+      }
+      const bool same = nCells[0] == nCells[1] && ntuplets[0] == ntuplets[1];
+      std::cout << "event " << event << ", " << minHitsPerNtuplet << " hits: " << nCells[0] << " cells, "
+		<< ntuplets[0].size() << " ntuplets (serial), " << ntuplets[1].size() << " (parallel)"
+		<< (same ? "" : " MISMATCH") << std::endl;
+      ok &= same && !ntuplets[0].empty();
+    }
+  }
+
+  assert(ok);
+  return ok ? 0 : 1;
+}
@@ -53,6 +53,8 @@ namespace cms
     bool produceSeedStopReasons_;
 
     unsigned int theMaxNSeeds;
+    // if >0 the seeds are built in parallel in batches of this size (results independent of the number of threads)
+    unsigned int theSeedBatchSize;
 
     std::unique_ptr<BaseCkfTrajectoryBuilder> theTrajectoryBuilder;
 
@@ -81,6 +81,8 @@ public:
   unsigned int limitedCandidates(const boost::shared_ptr<const TrajectorySeed> & sharedSeed, TempTrajectoryContainer &candidates, TrajectoryContainer& result) const;
   
   void updateTrajectory( TempTrajectory& traj, TM && tm) const;
+  // with the updated state already computed (by TrajectoryStateUpdator::updateBatch)
+  void updateTrajectory( TempTrajectory& traj, TM && tm, TSOS && upState) const;
 
   /*  
       //not mature for integration.  
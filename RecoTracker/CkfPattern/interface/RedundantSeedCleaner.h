@@ -13,7 +13,8 @@ class RedundantSeedCleaner {
    /** \brief Provides the cleaner a pointer to the vector where trajectories are stored, in case it does not want to keep a local collection of trajectories */
    virtual void init(const std::vector<Trajectory> *vect) = 0;
 
-   /** \brief Returns true if the seed is not overlapping with another trajectory */
+   /** \brief Returns true if the seed is not overlapping with another trajectory.
+       Must be safe to call concurrently as long as no trajectory is added at the same time */
    virtual bool good(const TrajectorySeed *seed) = 0;
    
    /** \brief Tells the cleaner that the seeds are finished, and so it can clear any cache it has */
@@ -19,6 +19,7 @@
 #include "TrackingTools/DetLayers/interface/GeomDetCompatibilityChecker.h"
 #include "TrackingTools/MeasurementDet/interface/MeasurementDet.h"
 
+#include "CommonTools/Utils/interface/DynArray.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Utilities/interface/thread_safety_macros.h"
 
@@ -321,12 +322,27 @@ TrajectorySegmentBuilder::updateCandidates (TempTrajectory const & traj,
 {
   //
   // generate updated candidates with all valid hits
+  // (the hits are updated at once)
   //
+  unsigned int nm = measurements.size();
+  declareDynArray(TSOS, nm, predicted);
+  declareDynArray(const TrackingRecHit *, nm, hits);
+  declareDynArray(TSOS, nm, updated);
+  unsigned int nv=0;
+  for ( auto const & tm : measurements ) {
+    if ( !tm.recHit()->isValid() ) continue;
+    predicted[nv] = tm.predictedState();
+    hits[nv++] = tm.recHit().get();
+  }
+  theUpdator.updateBatch(predicted.begin(), hits.begin(), nv, updated.begin());
+
+  nv=0;
   for ( auto im=measurements.begin();
 	im!=measurements.end(); ++im ) {
     if ( im->recHit()->isValid() ) {
       candidates.push_back(traj);
-      updateTrajectory(candidates.back(),*im);
+      candidates.back().emplace(im->predictedState(), std::move(updated[nv++]),
+				im->recHit(), im->estimate(), im->layer());
       if ( theLockHits )  lockMeasurement(*im);
     }
   }
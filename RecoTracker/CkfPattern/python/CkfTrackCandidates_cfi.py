@@ -16,6 +16,8 @@ ckfTrackCandidates = cms.EDProducer("CkfTrackCandidateMaker",
 #    SeedLabel = cms.string(''),
     maxNSeeds = cms.uint32(500000),
     maxSeedsBeforeCleaning = cms.uint32(5000),
+# Build the seeds in parallel in batches of this size (0: sequential)
+    seedBatchSize = cms.uint32(0),
 # SeedProducer:SeedLabel descoped to src
     src = cms.InputTag('globalMixedSeeds'),                                  
     SimpleMagneticField = cms.string(''),                                    
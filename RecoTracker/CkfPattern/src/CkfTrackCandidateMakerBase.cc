@@ -38,12 +38,9 @@
 
 // #define VI_SORTSEED
 // #define VI_REPRODUCIBLE
-// #define VI_TBB
 
 #include <thread>
-#ifdef VI_TBB
 #include "tbb/parallel_for.h"
-#endif
 
 #include "RecoTracker/CkfPattern/interface/PrintoutHelper.h"
 
@@ -65,6 +62,7 @@ namespace cms{
     cleanTrajectoryAfterInOut(conf.getParameter<bool>("cleanTrajectoryAfterInOut")),
     reverseTrajectories(conf.existsAs<bool>("reverseTrajectories") && conf.getParameter<bool>("reverseTrajectories")),
     theMaxNSeeds(conf.getParameter<unsigned int>("maxNSeeds")),
+    theSeedBatchSize(conf.existsAs<unsigned int>("seedBatchSize") ? conf.getParameter<unsigned int>("seedBatchSize") : 0),
     theTrajectoryBuilder(createBaseCkfTrajectoryBuilder(conf.getParameter<edm::ParameterSet>("TrajectoryBuilderPSet"), iC)),
     theTrajectoryCleanerName(conf.getParameter<std::string>("TrajectoryCleaner")),
     theTrajectoryCleaner(nullptr),
@@ -267,38 +265,17 @@ namespace cms{
 #endif
 
       std::atomic<unsigned int> ntseed(0);
-      auto theLoop = [&](size_t ii) {
-        auto j = indeces[ii];
-
-        ntseed++;
-
-        // to be moved inside a par section (how with tbb??)
-        std::vector<Trajectory> theTmpTrajectories;
 
+      // Build and clean the trajectories from seed j.
+      // Touches no shared state, can be run concurrently for different seeds
+      auto buildFromSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories, unsigned int & nCandPerSeed) -> SeedStopReason {
 
 	LogDebug("CkfPattern") << "======== Begin to look for trajectories from seed " << j << " ========\n";
 
-        { Lock lock(theMutex);
-	// Check if seed hits already used by another track
-	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
-          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
-          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
-          return;  // from the lambda!
-        }}
-
-
 	// Build trajectory from seed outwards
         theTmpTrajectories.clear();
-        unsigned int nCandPerSeed = 0;
         auto const & startTraj = theTrajectoryBuilder->buildTrajectories( (*collseed)[j], theTmpTrajectories, nCandPerSeed, nullptr );
-        {
-          Lock lock(theMutex);
-          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
-          if(theTmpTrajectories.empty()) {
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::NO_TRAJECTORY);
-            return; // from the lambda!
-          }
-        }
+        if(theTmpTrajectories.empty()) return SeedStopReason::NO_TRAJECTORY;
 
 	LogDebug("CkfPattern") << "======== In-out trajectory building found " << theTmpTrajectories.size()
 			            << " trajectories from seed " << j << " ========\n"
@@ -324,11 +301,7 @@ namespace cms{
   	  LogDebug("CkfPattern") << "======== Out-in trajectory building found " << theTmpTrajectories.size()
   			              << " valid/invalid trajectories from seed " << j << " ========\n"
 				 <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
-          if(theTmpTrajectories.empty()) {
-            Lock lock(theMutex);
-            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_REGION_REBUILD);
-            return;
-          }
+          if(theTmpTrajectories.empty()) return SeedStopReason::SEED_REGION_REBUILD;
         }
 
 
@@ -339,7 +312,11 @@ namespace cms{
                                << j << " ========\n"
 			       <<PrintoutHelper::dumpCandidates(theTmpTrajectories);
 
-        { Lock lock(theMutex);
+        return SeedStopReason::NOT_STOPPED;
+      };
+
+      // Store the valid trajectories from seed j (to be called in a locked/serial section)
+      auto storeFromSeed = [&](unsigned int j, std::vector<Trajectory> & theTmpTrajectories) {
 	for(vector<Trajectory>::iterator it=theTmpTrajectories.begin();
 	    it!=theTmpTrajectories.end(); it++){
 	  if( it->isValid() ) {
@@ -352,13 +329,12 @@ namespace cms{
             if (theSeedCleaner && rawResult.back().foundHits()>3) theSeedCleaner->add( &rawResult.back() );
             //if (theSeedCleaner ) theSeedCleaner->add( & (*it) );
 	  }
-	}}
+	}
 
         theTmpTrajectories.clear();
 
 	LogDebug("CkfPattern") << "rawResult trajectories found so far = " << rawResult.size();
 
-        { Lock lock(theMutex);
 	if ( maxSeedsBeforeCleaning_ >0 && rawResult.size() > maxSeedsBeforeCleaning_+lastCleanResult) {
           theTrajectoryCleaner->clean(rawResult);
           rawResult.erase(std::remove_if(rawResult.begin()+lastCleanResult,rawResult.end(),
@@ -366,22 +342,83 @@ namespace cms{
 			  rawResult.end());
           lastCleanResult=rawResult.size();
         }
-        }
+      };
+
+      auto theLoop = [&](size_t ii) {
+        auto j = indeces[ii];
 
+        ntseed++;
+
+        { Lock lock(theMutex);
+	// Check if seed hits already used by another track
+	if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) {
+          LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+          (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+          return;  // from the lambda!
+        }}
+
+        std::vector<Trajectory> theTmpTrajectories;
+        unsigned int nCandPerSeed = 0;
+        auto stopReason = buildFromSeed(j, theTmpTrajectories, nCandPerSeed);
+
+        Lock lock(theMutex);
+        (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed);
+        if (stopReason!=SeedStopReason::NOT_STOPPED) {
+          (*outputSeedStopInfos)[j].setStopReason(stopReason);
+          return;
+        }
+        storeFromSeed(j, theTmpTrajectories);
       };
       // end of loop over seeds
 
+      // Parallel version: the seeds of a batch are built concurrently, skipping
+      // those already killed by the trajectories of the previous batches.
+      // The results are then stored in seed order, repeating the seed cleaning
+      // against the trajectories of the same batch: the output is identical to
+      // the sequential loop whatever the number of threads.
+      auto theBatchLoop = [&](size_t first, size_t last) {
+        auto nInBatch = last-first;
+        std::vector<std::vector<Trajectory>> tmpTrajectories(nInBatch);
+        std::vector<unsigned int> nCandPerSeed(nInBatch,0);
+        std::vector<SeedStopReason> stopReason(nInBatch,SeedStopReason::SEED_CLEANING);
+
+        tbb::parallel_for(size_t(0), nInBatch, [&](size_t k) {
+          auto j = indeces[first+k];
+          // the cleaner is only read during the parallel section
+          if (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j])) ) return;
+          stopReason[k] = buildFromSeed(j, tmpTrajectories[k], nCandPerSeed[k]);
+        });
+
+        for (size_t k=0; k<nInBatch; ++k) {
+          auto j = indeces[first+k];
+          ntseed++;
+          if (stopReason[k]==SeedStopReason::SEED_CLEANING ||
+              (theSeedCleaner && !theSeedCleaner->good( &((*collseed)[j]))) ) {
+            LogDebug("CkfTrackCandidateMakerBase")<<" Seed cleaning kills seed "<<j;
+            (*outputSeedStopInfos)[j].setStopReason(SeedStopReason::SEED_CLEANING);
+            continue;
+          }
+          (*outputSeedStopInfos)[j].setCandidatesPerSeed(nCandPerSeed[k]);
+          if (stopReason[k]!=SeedStopReason::NOT_STOPPED) {
+            (*outputSeedStopInfos)[j].setStopReason(stopReason[k]);
+            continue;
+          }
+          storeFromSeed(j, tmpTrajectories[k]);
+        }
+      };
+
 
-#ifdef VI_TBB
-     tbb::parallel_for(0UL,collseed_size,1UL,theLoop);
-#else
+      if (theSeedBatchSize>0) {
+        for (size_t first = 0; first < collseed_size; first+=theSeedBatchSize)
+          theBatchLoop(first, std::min(first+theSeedBatchSize, collseed_size));
+      } else {
 #ifdef VI_OMP
 #pragma omp parallel for schedule(dynamic,4)
 #endif
-      for (size_t j = 0; j < collseed_size; j++){
-       theLoop(j);
+        for (size_t j = 0; j < collseed_size; j++){
+          theLoop(j);
+        }
       }
-#endif
       assert(ntseed==collseed_size);
       if (theSeedCleaner) theSeedCleaner->done();
 
@@ -22,6 +22,7 @@
 #include "RecoTracker/TkDetLayers/interface/GeometricSearchTracker.h"
 
 #include "RecoTracker/CkfPattern/interface/IntermediateTrajectoryCleaner.h"
+#include "CommonTools/Utils/interface/DynArray.h"
 #include "TrackingTools/TrajectoryState/interface/TrajectoryStateTransform.h"
 #include "TrackingTools/PatternTools/interface/TransverseImpactPointExtrapolator.h"
 
@@ -224,9 +225,24 @@ limitedCandidates(const boost::shared_ptr<const TrajectorySeed> & sharedSeed, Te
 	  else last = meas.end();
 	}
 
+	// update all valid measurements at once
+	unsigned int nm = last-meas.begin();
+	declareDynArray(TSOS, nm, predicted);
+	declareDynArray(const TrackingRecHit *, nm, hits);
+	declareDynArray(TSOS, nm, updated);
+	unsigned int nv=0;
+	for(auto itm = meas.begin(); itm != last; itm++) {
+	  if (!itm->recHit()->isValid()) continue;
+	  predicted[nv] = itm->predictedState();
+	  hits[nv++] = itm->recHit().get();
+	}
+	theUpdator->updateBatch(predicted.begin(), hits.begin(), nv, updated.begin());
+
+	nv=0;
 	for(auto itm = meas.begin(); itm != last; itm++) {
 	  TempTrajectory newTraj = *traj;
-	  updateTrajectory( newTraj, std::move(*itm));
+	  if (itm->recHit()->isValid()) updateTrajectory( newTraj, std::move(*itm), std::move(updated[nv++]));
+	  else updateTrajectory( newTraj, std::move(*itm));
 
 	  if ( toBeContinued(newTraj)) {
 	    newCand.push_back(std::move(newTraj));  std::push_heap(newCand.begin(),newCand.end(),trajCandLess);
@@ -327,6 +343,16 @@ void CkfTrajectoryBuilder::updateTrajectory( TempTrajectory& traj,
   }
 }
 
+void CkfTrajectoryBuilder::updateTrajectory( TempTrajectory& traj,
+					     TM && tm, TSOS && upState) const
+{
+  auto && predictedState = tm.predictedState();
+  auto  && hit = tm.recHit();
+  traj.emplace( std::move(predictedState), std::move(upState),
+		std::move(hit), tm.estimate(), tm.layer());
+}
+
+
 
 void 
 CkfTrajectoryBuilder::findCompatibleMeasurements(const TrajectorySeed&seed,
@@ -30,6 +30,7 @@ public:
          theStripClustersToSkip(stripClustersToSkip), thePixelClustersToSkip(pixelClustersToSkip), thePhase2OTClustersToSkip(phase2OTClustersToSkip) {}
 
    /// Real constructor 2: with new cluster skips (checked)
+   /// the masks are not copied: they must live as long as this object (e.g. be event products)
    MeasurementTrackerEvent(const MeasurementTrackerEvent &trackerEvent,
                            const edm::ContainerMask<edmNew::DetSetVector<SiStripCluster> > & stripClustersToSkip,
                            const edm::ContainerMask<edmNew::DetSetVector<SiPixelCluster> > & pixelClustersToSkip) ;
@@ -49,9 +50,9 @@ public:
    const StMeasurementDetSet & stripData() const { return * theStripData; }
    const PxMeasurementDetSet & pixelData() const { return * thePixelData; }
    const Phase2OTMeasurementDetSet & phase2OTData() const { return * thePhase2OTData; }
-   const std::vector<bool> & stripClustersToSkip() const { return theStripClustersToSkip; }
-   const std::vector<bool> & pixelClustersToSkip() const { return thePixelClustersToSkip; }
-   const std::vector<bool> & phase2OTClustersToSkip() const { return thePhase2OTClustersToSkip; }
+   const std::vector<bool> & stripClustersToSkip() const { return *theStripMask; }
+   const std::vector<bool> & pixelClustersToSkip() const { return *thePixelMask; }
+   const std::vector<bool> & phase2OTClustersToSkip() const { return *thePhase2OTMask; }
 
    // forwarded calls
    const TrackingGeometry* geomTracker() const { return measurementTracker().geomTracker(); }
@@ -66,10 +67,17 @@ private:
    const PxMeasurementDetSet *thePixelData=nullptr;
    const Phase2OTMeasurementDetSet *thePhase2OTData=nullptr;
    bool  theOwner=false; // do I own the tree above?
-   // these  could be const pointers as well, but ContainerMask doesn't expose the vector
+   // owned skips (constructor 1)
    std::vector<bool> theStripClustersToSkip;
    std::vector<bool> thePixelClustersToSkip;
    std::vector<bool> thePhase2OTClustersToSkip;
+   // skips in use: the owned ones, or the vectors of the ContainerMasks (constructor 2),
+   // so that every iteration does not copy the masks of the previous ones
+   const std::vector<bool> * theStripMask = &theStripClustersToSkip;
+   const std::vector<bool> * thePixelMask = &thePixelClustersToSkip;
+   const std::vector<bool> * thePhase2OTMask = &thePhase2OTClustersToSkip;
+
+   void moveSkips(MeasurementTrackerEvent & other);
 };
 
 #endif // MeasurementTrackerEvent_H
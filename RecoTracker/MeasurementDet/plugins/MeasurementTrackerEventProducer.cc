@@ -16,7 +16,8 @@
 
 MeasurementTrackerEventProducer::MeasurementTrackerEventProducer(const edm::ParameterSet &iConfig) :
     measurementTrackerLabel_(iConfig.getParameter<std::string>("measurementTracker")),
-    switchOffPixelsIfEmpty_(iConfig.getParameter<bool>("switchOffPixelsIfEmpty"))
+    switchOffPixelsIfEmpty_(iConfig.getParameter<bool>("switchOffPixelsIfEmpty")),
+    precomputePixelHits_(iConfig.getParameter<bool>("precomputePixelHits"))
 {
     std::vector<edm::InputTag> inactivePixelDetectorTags(iConfig.getParameter<std::vector<edm::InputTag> >("inactivePixelDetectorLabels"));
     for (auto &t : inactivePixelDetectorTags) theInactivePixelDetectorLabels.push_back(consumes<DetIdCollection>(t));
@@ -68,6 +69,7 @@ void MeasurementTrackerEventProducer::fillDescriptions(edm::ConfigurationDescrip
   desc.add<std::vector<edm::InputTag>>("inactiveStripDetectorLabels", std::vector<edm::InputTag>{{edm::InputTag("siStripDigis")}})->setComment("One or more DetIdCollections of modules to mask on the fly for a given event");
 
   desc.add<bool>("switchOffPixelsIfEmpty", true)->setComment("let's keep it like this, for cosmics");
+  desc.add<bool>("precomputePixelHits", false)->setComment("compute once per event the track-independent position and error of all pixel clusters and use them to preselect the clusters while building tracks");
 
   descriptions.add("measurementTrackerEventDefault",desc);
 }
@@ -230,6 +232,8 @@ MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasur
 	    thePxDets.update(i,set);         
 	  }
 	}
+
+	if (precomputePixelHits_) fillPixelHitCache(thePxDets, *pixelCollection, trackerGeom);
       }
     } else {
       edm::EDConsumerBase::Labels labels;
@@ -239,6 +243,26 @@ MeasurementTrackerEventProducer::updatePixels( const edm::Event& event, PxMeasur
   }
 }
 
+void
+MeasurementTrackerEventProducer::fillPixelHitCache( PxMeasurementDetSet & thePxDets, const edmNew::DetSetVector<SiPixelCluster> & pixelCollection,
+						    const TrackerGeometry& trackerGeom) const
+{
+  auto const * cpe = thePxDets.conditions().pixelCPE();
+  if (cpe==nullptr) return;
+  auto & cache = thePxDets.hitCache();
+  cache.resize(pixelCollection.dataSize());
+  if (pixelCollection.dataSize()==0) return;
+  const SiPixelCluster * begin = &pixelCollection.data().front();
+  for (auto const & set : pixelCollection) {
+    if (set.empty()) continue;
+    auto const & gdu = *trackerGeom.idToDetUnit(set.id());
+    for (auto const & cl : set) {
+      auto && params = cpe->getParameters(cl, gdu);
+      cache.set(&cl-begin, std::get<0>(params), std::get<1>(params), std::get<2>(params));
+    }
+  }
+}
+
 void 
 MeasurementTrackerEventProducer::updateStrips( const edm::Event& event, StMeasurementDetSet & theStDets, std::vector<bool> & stripClustersToSkip ) const
 {
@@ -25,6 +25,9 @@ private:
 protected:
       void updatePixels( const edm::Event&, PxMeasurementDetSet & thePxDets, std::vector<bool> & pixelClustersToSkip, 
 			 const TrackerGeometry& trackerGeom, const edm::EventSetup& iSetup) const;
+      // track-independent position and error of all the pixel clusters, see PxMeasurementDetSet::HitCache
+      void fillPixelHitCache( PxMeasurementDetSet & thePxDets, const edmNew::DetSetVector<SiPixelCluster> & pixelCollection,
+			      const TrackerGeometry& trackerGeom) const;
       void updateStrips( const edm::Event&, StMeasurementDetSet & theStDets, std::vector<bool> & stripClustersToSkip ) const;
       void updatePhase2OT( const edm::Event&, Phase2OTMeasurementDetSet & thePh2OTDets ) const;
       //FIXME:: going to be updated soon
@@ -46,6 +49,7 @@ protected:
 
       bool selfUpdateSkipClusters_;
       bool switchOffPixelsIfEmpty_;
+      bool precomputePixelHits_;
       bool isPhase2;
 };
 
@@ -7,12 +7,16 @@
 #include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
 #include "TrackingTools/DetLayers/interface/MeasurementEstimator.h"
 #include "TrackingTools/PatternTools/interface/TrajMeasLessEstim.h"
+#include "CommonTools/Utils/interface/DynArray.h"
 
 
 namespace {
   // in cms units are in cm
   constexpr float theRocWidth  = 0.81/2;
   constexpr float theRocHeight = 0.81/2;
+  // the cached hits miss the track-angle corrections of the CPE (shifts of the order
+  // of the error for inclined tracks): preselect with errors twice as large
+  constexpr float thePreselectionErrorScale = 2.f;
 }
 
 TkPixelMeasurementDet::TkPixelMeasurementDet( const GeomDet* gdet,
@@ -25,6 +29,62 @@ TkPixelMeasurementDet::TkPixelMeasurementDet( const GeomDet* gdet,
     }
   }
 
+template<typename F>
+void
+TkPixelMeasurementDet::forEachCompCluster( const TrajectoryStateOnSurface& ts, const MeasurementTrackerEvent & data, float xl, float yl, F && f) const
+{
+  if (isEmpty(data.pixelData())== true ) return;
+  if (isActive(data) == false) return;
+  const SiPixelCluster* begin=nullptr;
+  if (!data.pixelData().handle()->data().empty()) {
+     begin = &(data.pixelData().handle()->data().front());
+  }
+  const detset & detSet = data.pixelData().detSet(index());
+
+  // pixel topology is rectangular, all positions are independent
+  LocalVector  maxD(xl,yl,0);
+  auto PMinus = specificGeomDet().specificTopology().measurementPosition(ts.localPosition()-maxD);
+  auto PPlus =  specificGeomDet().specificTopology().measurementPosition(ts.localPosition()+maxD);
+
+  int xminus = PMinus.x();
+  int yminus = PMinus.y();
+  int xplus = PPlus.x()+0.5f;
+  int yplus = PPlus.y()+0.5f;
+
+
+  // rechits are sorted in x...
+  auto rightCluster = 
+    std::find_if( detSet.begin(), detSet.end(), [xplus](const SiPixelCluster& cl) { return cl.minPixelRow() > xplus; });
+
+  // std::cout << "px xlim " << xl << ' ' << xminus << '/' << xplus << ' ' << rightCluster-detSet.begin() << ',' << detSet.end()-rightCluster << std::endl;
+  
+
+  // consider only compatible clusters
+ for (auto ci = detSet.begin(); ci != rightCluster; ++ci ) {    
+
+    if (ci < begin){
+      edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch.";
+      return;
+    }
+     unsigned int index = ci-begin;
+     if (!data.pixelClustersToSkip().empty() &&  index>=data.pixelClustersToSkip().size()){
+       edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch. i.e "<<index<<" >= "<<data.pixelClustersToSkip().size();
+       return;
+     }
+
+     if (ci->maxPixelRow()<xminus) continue;
+     // also check compatibility in y... (does not add much)
+     if (ci->minPixelCol()>yplus) continue;
+     if (ci->maxPixelCol()<yminus) continue;
+
+     if(data.pixelClustersToSkip().empty() or (not data.pixelClustersToSkip()[index]) ) {
+       f( detSet.makeRefTo( data.pixelData().handle(), ci ), index );
+     }else{   
+       LogDebug("TkPixelMeasurementDet")<<"skipping this cluster from last iteration on "<<fastGeomDet().geographicalId().rawId()<<" key: "<<index;
+     }
+  }
+}
+
 bool TkPixelMeasurementDet::measurements( const TrajectoryStateOnSurface& stateOnThisDet,
 					  const MeasurementEstimator& est, const MeasurementTrackerEvent & data,
 					  TempMeasurements & result) const {
@@ -54,11 +114,39 @@ bool TkPixelMeasurementDet::measurements( const TrajectoryStateOnSurface& stateO
   }
   
   auto oldSize = result.size();
-  MeasurementDet::RecHitContainer && allHits = compHits(stateOnThisDet, data,xl,yl);
-  for (auto && hit : allHits) {
-    std::pair<bool,double> diffEst = est.estimate( stateOnThisDet, *hit);
-    if ( diffEst.first)
-      result.add(std::move(hit), diffEst.second);
+  if (data.pixelData().hasHitCache()) {
+    // preselect the clusters with the track-independent hits of the per-event cache,
+    // built on the stack with larger errors, then build (with the track angles) and
+    // estimate only the hits of the clusters which pass
+    auto const & cache = data.pixelData().hitCache();
+    unInitDynArray(SiPixelRecHit, data.pixelData().detSet(index()).size(), cachedHits);
+    forEachCompCluster(stateOnThisDet, data, xl, yl, [&](SiPixelClusterRef const & cluster, unsigned int i) {
+	cachedHits.push_back( buildCachedRecHit( cluster, cache, i, thePreselectionErrorScale ) );
+      });
+    auto nHits = cachedHits.size();
+    declareDynArray(const TrackingRecHit *, nHits, hitPtrs);
+    declareDynArray(MeasurementEstimator::HitReturnType, nHits, diffEst);
+    for (unsigned int i=0; i<nHits; ++i) hitPtrs[i] = &cachedHits[i];
+    est.estimateBatch( stateOnThisDet, hitPtrs.begin(), nHits, diffEst.begin());
+    for (unsigned int i=0; i<nHits; ++i) {
+      if (!diffEst[i].first) continue;
+      auto && hit = buildRecHit( cachedHits[i].cluster(), stateOnThisDet.localParameters() );
+      auto && refinedEst = est.estimate( stateOnThisDet, *hit);
+      if ( refinedEst.first)
+	result.add(std::move(hit), refinedEst.second);
+    }
+  } else {
+    MeasurementDet::RecHitContainer && allHits = compHits(stateOnThisDet, data,xl,yl);
+    // estimate all hits at once
+    auto nHits = allHits.size();
+    declareDynArray(const TrackingRecHit *, nHits, hitPtrs);
+    declareDynArray(MeasurementEstimator::HitReturnType, nHits, diffEst);
+    for (unsigned int i=0; i<nHits; ++i) hitPtrs[i] = allHits[i].get();
+    est.estimateBatch( stateOnThisDet, hitPtrs.begin(), nHits, diffEst.begin());
+    for (unsigned int i=0; i<nHits; ++i) {
+      if ( diffEst[i].first)
+	result.add(std::move(allHits[i]), diffEst[i].second);
+    }
   }
 
   if (result.size()>oldSize) return true;
@@ -81,6 +169,13 @@ TkPixelMeasurementDet::buildRecHit( const SiPixelClusterRef & cluster,
   return std::make_shared<SiPixelRecHit>( std::get<0>(params), std::get<1>(params), std::get<2>(params), fastGeomDet(), cluster);
 }
 
+SiPixelRecHit
+TkPixelMeasurementDet::buildCachedRecHit( const SiPixelClusterRef & cluster,
+					  const PxMeasurementDetSet::HitCache & cache, unsigned int i, float errorScale) const
+{
+  return SiPixelRecHit( cache.position(i), cache.error(i).scale(errorScale), cache.qual[i], fastGeomDet(), cluster);
+}
+
 
 TkPixelMeasurementDet::RecHitContainer
 TkPixelMeasurementDet::recHits( const TrajectoryStateOnSurface& ts, const MeasurementTrackerEvent & data) const {
@@ -94,58 +189,10 @@ TkPixelMeasurementDet::RecHitContainer
 TkPixelMeasurementDet::compHits( const TrajectoryStateOnSurface& ts, const MeasurementTrackerEvent & data, float xl, float yl  ) const
 {
   RecHitContainer result;
-  if (isEmpty(data.pixelData())== true ) return result;
-  if (isActive(data) == false) return result;
-  const SiPixelCluster* begin=nullptr;
-  if (!data.pixelData().handle()->data().empty()) {
-     begin = &(data.pixelData().handle()->data().front());
-  }
-  const detset & detSet = data.pixelData().detSet(index());
-  result.reserve(detSet.size());
-
-  // pixel topology is rectangular, all positions are independent
-  LocalVector  maxD(xl,yl,0);
-  auto PMinus = specificGeomDet().specificTopology().measurementPosition(ts.localPosition()-maxD);
-  auto PPlus =  specificGeomDet().specificTopology().measurementPosition(ts.localPosition()+maxD);
-
-  int xminus = PMinus.x();
-  int yminus = PMinus.y();
-  int xplus = PPlus.x()+0.5f;
-  int yplus = PPlus.y()+0.5f;
-
-
-  // rechits are sorted in x...
-  auto rightCluster = 
-    std::find_if( detSet.begin(), detSet.end(), [xplus](const SiPixelCluster& cl) { return cl.minPixelRow() > xplus; });
-
-  // std::cout << "px xlim " << xl << ' ' << xminus << '/' << xplus << ' ' << rightCluster-detSet.begin() << ',' << detSet.end()-rightCluster << std::endl;
-  
-
-  // consider only compatible clusters
- for (auto ci = detSet.begin(); ci != rightCluster; ++ci ) {    
-
-    if (ci < begin){
-      edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch.";
-      return result;
-    }
-     unsigned int index = ci-begin;
-     if (!data.pixelClustersToSkip().empty() &&  index>=data.pixelClustersToSkip().size()){
-       edm::LogError("IndexMisMatch")<<"TkPixelMeasurementDet cannot create hit because of index mismatch. i.e "<<index<<" >= "<<data.pixelClustersToSkip().size();
-       return result;
-     }
-
-     if (ci->maxPixelRow()<xminus) continue;
-     // also check compatibility in y... (does not add much)
-     if (ci->minPixelCol()>yplus) continue;
-     if (ci->maxPixelCol()<yminus) continue;
-
-     if(data.pixelClustersToSkip().empty() or (not data.pixelClustersToSkip()[index]) ) {
-       SiPixelClusterRef cluster = detSet.makeRefTo( data.pixelData().handle(), ci );
-       result.push_back( buildRecHit( cluster, ts.localParameters() ) );
-     }else{   
-       LogDebug("TkPixelMeasurementDet")<<"skipping this cluster from last iteration on "<<fastGeomDet().geographicalId().rawId()<<" key: "<<index;
-     }
-  }
+  result.reserve(data.pixelData().detSet(index()).size());
+  forEachCompCluster(ts, data, xl, yl, [&](SiPixelClusterRef const & cluster, unsigned int) {
+      result.push_back( buildRecHit( cluster, ts.localParameters() ) );
+    });
   return result;
 }
 
@@ -8,6 +8,7 @@
 #include "DataFormats/Common/interface/Handle.h"
 #include "DataFormats/Common/interface/DetSetVector.h"
 #include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHit.h"
 #include "RecoTracker/MeasurementDet/interface/MeasurementTrackerEvent.h"
 #include "RecoTracker/MeasurementDet/src/TkMeasurementDetSet.h"
 
@@ -63,6 +64,12 @@ public:
   buildRecHit( const SiPixelClusterRef & cluster,
 	       const LocalTrajectoryParameters & ltp) const;
 
+  /// hit from the per-event precomputed (track-independent) parameters, with the
+  /// errors scaled by errorScale: only used to preselect the clusters in measurements()
+  SiPixelRecHit
+  buildCachedRecHit( const SiPixelClusterRef & cluster,
+		     const PxMeasurementDetSet::HitCache & cache, unsigned int i, float errorScale) const;
+
   /** \brief Turn on/off the module for reconstruction, for the full run or lumi (using info from DB, usually). */
   void setActive(bool active) { conditionSet().setActive(index(), active); }
   /** \brief Turn on/off the module for reconstruction for one events.
@@ -96,6 +103,11 @@ private:
 
   const PixelClusterParameterEstimator * cpe() const { return conditionSet().pixelCPE(); }
 
+  // calls f(cluster,index) for the clusters compatible with the state within xl, yl,
+  // index being the position of the cluster in the DetSetVector data
+  template<typename F>
+  void forEachCompCluster( const TrajectoryStateOnSurface&, const MeasurementTrackerEvent & dat, float xl, float yl, F && f) const;
+
  public:
 
   inline bool accept(SiPixelClusterRefNew & r, const std::vector<bool> skipClusters) const {
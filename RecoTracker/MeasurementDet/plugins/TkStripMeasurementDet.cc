@@ -72,25 +72,11 @@ bool TkStripMeasurementDet::recHits(SimpleHitContainer & result,
     std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
   
   
-  std::vector<SiStripRecHit2D> tmp;
-  if ( rightCluster != detSet.begin()) {
-    // there are hits on the left of the utraj
-    auto leftCluster = rightCluster;
-    while ( --leftCluster >=  detSet.begin()) {
-      SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), leftCluster); 
-      bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), tmp);
-      if(!isCompatible) break; // exit loop on first incompatible hit
-      for (auto && h: tmp) result.push_back(new SiStripRecHit2D(std::move(h)));
-      tmp.clear();								
-    }
-  }
-  for ( ; rightCluster != detSet.end(); rightCluster++) {
-    SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), rightCluster); 
-    bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), tmp);
-    if(!isCompatible) break; // exit loop on first incompatible hit
-    for (auto && h: tmp) result.push_back(new SiStripRecHit2D(std::move(h))); 
-    tmp.clear();
-  }
+  // the hits on the left of the utraj, then those on the right
+  auto add = [&](SiStripRecHit2D && h, double) { result.push_back(new SiStripRecHit2D(std::move(h))); };
+  const int right = rightCluster - detSet.begin();
+  filteredRecHits(detSet, data, right-1, -1, cpepar, stateOnThisDet, est, add);
+  filteredRecHits(detSet, data, right, +1, cpepar, stateOnThisDet, est, add);
   
   return result.size()>oldSize;
 }
@@ -112,20 +98,11 @@ bool TkStripMeasurementDet::simpleRecHits( const TrajectoryStateOnSurface& state
   auto rightCluster = 
     std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
   
-  if ( rightCluster != detSet.begin()) {
-    // there are hits on the left of the utraj
-    auto leftCluster = rightCluster;
-    while ( --leftCluster >=  detSet.begin()) {
-      SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), leftCluster); 
-      bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), result);
-      if(!isCompatible) break; // exit loop on first incompatible hit
-    }
-  }
-  for ( ; rightCluster != detSet.end(); rightCluster++) {
-    SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), rightCluster); 
-    bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), result);
-    if(!isCompatible) break; // exit loop on first incompatible hit
-  }
+  // the hits on the left of the utraj, then those on the right
+  auto add = [&](SiStripRecHit2D && h, double) { result.push_back(std::move(h)); };
+  const int right = rightCluster - detSet.begin();
+  filteredRecHits(detSet, data, right-1, -1, cpepar, stateOnThisDet, est, add);
+  filteredRecHits(detSet, data, right, +1, cpepar, stateOnThisDet, est, add);
   
   return result.size()>oldSize;
 }
@@ -146,20 +123,14 @@ TkStripMeasurementDet::recHits( const TrajectoryStateOnSurface& stateOnThisDet,
     auto rightCluster = 
       std::find_if( detSet.begin(), detSet.end(), [utraj](const SiStripCluster& hit) { return hit.firstStrip() > utraj; });
     
-    if ( rightCluster != detSet.begin()) {
-      // there are hits on the left of the utraj
-      auto leftCluster = rightCluster;
-      while ( --leftCluster >=  detSet.begin()) {
-	SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), leftCluster); 
-	bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), result, diffs);
-	if(!isCompatible) break; // exit loop on first incompatible hit
-      }
-    }
-    for ( ; rightCluster != detSet.end(); rightCluster++) {
-      SiStripClusterRef clusterref = detSet.makeRefTo( data.stripData().handle(), rightCluster); 
-      bool isCompatible = filteredRecHits(clusterref, cpepar, stateOnThisDet, est, data.stripClustersToSkip(), result,diffs);
-      if(!isCompatible) break; // exit loop on first incompatible hit
-    }
+    // the hits on the left of the utraj, then those on the right
+    auto add = [&](SiStripRecHit2D && h, double chi2) {
+      result.push_back(std::make_shared<SiStripRecHit2D>(std::move(h)));
+      diffs.push_back(chi2);
+    };
+    const int right = rightCluster - detSet.begin();
+    filteredRecHits(detSet, data, right-1, -1, cpepar, stateOnThisDet, est, add);
+    filteredRecHits(detSet, data, right, +1, cpepar, stateOnThisDet, est, add);
     
   return result.size()>oldSize;
 }
@@ -171,43 +171,43 @@ public:
   }
   
 
-  template<class ClusterRefT>
-  bool filteredRecHits( const ClusterRefT& cluster, StripCPE::AlgoParam const& cpepar,
-			const TrajectoryStateOnSurface& ltp,  const MeasurementEstimator& est, const std::vector<bool> & skipClusters,
-			RecHitContainer & result, std::vector<float> & diffs) const {
-    if (isMasked(*cluster)) return true;
-    if (!accept(cluster, skipClusters)) return true;
-    if (!est.preFilter(ltp, ClusterFilterPayload(rawId(),&*cluster) )) return true;  // avoids shadow; consistent with previous statement...
-    auto const & vl = cpe()->localParameters( *cluster, cpepar);
-    SiStripRecHit2D recHit(vl.first, vl.second, fastGeomDet(), cluster); // FIXME add cluster count in OmniRef (and move again to multiple sub-clusters..)
-    std::pair<bool,double> diffEst = est.estimate(ltp, recHit);
-    LogDebug("TkStripMeasurementDet")<<" chi2=" << diffEst.second;
-    if ( diffEst.first ) {
-      result.push_back(std::move(std::make_shared<SiStripRecHit2D>(recHit)));
-      diffs.push_back(diffEst.second);
+  // number of hits estimated at once by filteredRecHits
+  static constexpr unsigned int batchSize = 4;
+
+  // Builds the hits of the clusters of detSet from index first, walking with
+  // step (+1 or -1), and calls add(hit,chi2) for each of them in order, up to
+  // the first incompatible hit.  The hits are estimated batchSize at a time
+  // with MeasurementEstimator::estimateBatch.
+  template<class Add>
+  void filteredRecHits( const detset & detSet, const MeasurementTrackerEvent & data, int first, int step,
+			StripCPE::AlgoParam const& cpepar, const TrajectoryStateOnSurface& ltp,
+			const MeasurementEstimator& est, Add && add) const {
+    const int end = step>0 ? int(detSet.size()) : -1;
+    std::vector<SiStripRecHit2D> hits; hits.reserve(batchSize);  // no reallocation: hitPtrs stay valid
+    const TrackingRecHit * hitPtrs[batchSize];
+    MeasurementEstimator::HitReturnType diffEst[batchSize];
+    for (int i = first; i != end; ) {
+      hits.clear();
+      for ( ; i != end && hits.size() < batchSize; i += step) {
+	SiStripClusterRef cluster = detSet.makeRefTo( data.stripData().handle(), detSet.begin()+i);
+	if (isMasked(*cluster)) continue;
+	if (!accept(cluster, data.stripClustersToSkip())) continue;
+	if (!est.preFilter(ltp, ClusterFilterPayload(rawId(),&*cluster) )) continue;  // avoids shadow; consistent with previous statement...
+	auto const & vl = cpe()->localParameters( *cluster, cpepar);
+	hits.emplace_back( vl.first, vl.second, fastGeomDet(), cluster);   // FIXME add cluster count in OmniRef
+	hitPtrs[hits.size()-1] = &hits.back();
+      }
+      est.estimateBatch(ltp, hitPtrs, hits.size(), diffEst);
+      for (unsigned int k=0; k<hits.size(); ++k) {
+	LogDebug("TkStripMeasurementDet")<<" chi2=" << diffEst[k].second;
+	if (!diffEst[k].first) return; // exit loop on first incompatible hit
+	add(std::move(hits[k]), diffEst[k].second);
+      }
     }
-    return diffEst.first;
-  }
-
-
-  template<class ClusterRefT>
-    bool filteredRecHits( const ClusterRefT& cluster, StripCPE::AlgoParam const& cpepar,
-			  const TrajectoryStateOnSurface& ltp,  const MeasurementEstimator& est, const std::vector<bool> & skipClusters,
-			  std::vector<SiStripRecHit2D> & result) const {
-    if (isMasked(*cluster)) return true;
-    if (!accept(cluster, skipClusters)) return true;
-    if (!est.preFilter(ltp, ClusterFilterPayload(rawId(),&*cluster) )) return true;   // avoids shadow; consistent with previous statement...
-    auto const & vl = cpe()->localParameters( *cluster, cpepar);
-    result.emplace_back( vl.first, vl.second, fastGeomDet(), cluster);   // FIXME add cluster count in OmniRef
-    std::pair<bool,double> diffEst = est.estimate(ltp, result.back());
-    LogDebug("TkStripMeasurementDet")<<" chi2=" << diffEst.second;
-    if ( !diffEst.first ) result.pop_back();
-    return diffEst.first;
   }
 
 
 
-  
   /** \brief Turn on/off the module for reconstruction, for the full run or lumi (using info from DB, usually). */
   void setActiveThisPeriod(StMeasurementDetSet & theDets, bool active) { conditionSet().setActive(index(),active);}
 
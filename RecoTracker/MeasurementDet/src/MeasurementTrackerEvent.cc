@@ -17,8 +17,7 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(MeasurementTrackerEvent && othe
   thePhase2OTData = std::move(other.thePhase2OTData);
   theOwner = other.theOwner;
   other.theOwner = false; // make sure to fully transfer the ownership
-  theStripClustersToSkip = std::move(other.theStripClustersToSkip);
-  thePixelClustersToSkip = std::move(other.thePixelClustersToSkip);
+  moveSkips(other);
 }
 MeasurementTrackerEvent& MeasurementTrackerEvent::operator=(MeasurementTrackerEvent && other) {
   theTracker = std::move(other.theTracker);
@@ -27,9 +26,21 @@ MeasurementTrackerEvent& MeasurementTrackerEvent::operator=(MeasurementTrackerEv
   thePhase2OTData = std::move(other.thePhase2OTData);
   theOwner = other.theOwner;
   other.theOwner = false; // make sure to fully transfer the ownership
+  moveSkips(other);
+  return *this;
+}
+
+void MeasurementTrackerEvent::moveSkips(MeasurementTrackerEvent & other) {
+  // a pointer to the owned skips of other has to follow them
+  theStripMask = other.theStripMask==&other.theStripClustersToSkip ? &theStripClustersToSkip : other.theStripMask;
+  thePixelMask = other.thePixelMask==&other.thePixelClustersToSkip ? &thePixelClustersToSkip : other.thePixelMask;
+  thePhase2OTMask = other.thePhase2OTMask==&other.thePhase2OTClustersToSkip ? &thePhase2OTClustersToSkip : other.thePhase2OTMask;
   theStripClustersToSkip = std::move(other.theStripClustersToSkip);
   thePixelClustersToSkip = std::move(other.thePixelClustersToSkip);
-  return *this;
+  thePhase2OTClustersToSkip = std::move(other.thePhase2OTClustersToSkip);
+  other.theStripMask = &other.theStripClustersToSkip;
+  other.thePixelMask = &other.thePixelClustersToSkip;
+  other.thePhase2OTMask = &other.thePhase2OTClustersToSkip;
 }
 
 MeasurementTrackerEvent::MeasurementTrackerEvent(const MeasurementTrackerEvent &trackerEvent,
@@ -52,11 +63,8 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(const MeasurementTrackerEvent &
         throw cms::Exception("Configuration")<<"The pixel masking does not point to the proper collection of clusters: "<<pixelClustersToSkip.refProd().id()<<"!="<<thePixelData->handle().id()<<"\n";
     }
 
-    theStripClustersToSkip.resize(stripClustersToSkip.size());
-    stripClustersToSkip.copyMaskTo(theStripClustersToSkip);
-
-    thePixelClustersToSkip.resize(pixelClustersToSkip.size());
-    pixelClustersToSkip.copyMaskTo(thePixelClustersToSkip);
+    theStripMask = &stripClustersToSkip.maskVector();
+    thePixelMask = &pixelClustersToSkip.maskVector();
 }
 
 //FIXME:just temporary solution for phase2!
@@ -80,9 +88,6 @@ MeasurementTrackerEvent::MeasurementTrackerEvent(const MeasurementTrackerEvent &
         throw cms::Exception("Configuration")<<"The pixel masking does not point to the proper collection of clusters: "<<pixelClustersToSkip.refProd().id()<<"!="<<thePixelData->handle().id()<<"\n";
     }
 
-    thePixelClustersToSkip.resize(pixelClustersToSkip.size());
-    pixelClustersToSkip.copyMaskTo(thePixelClustersToSkip);
-
-    thePhase2OTClustersToSkip.resize(phase2OTClustersToSkip.size());
-    phase2OTClustersToSkip.copyMaskTo(thePhase2OTClustersToSkip);
+    thePixelMask = &pixelClustersToSkip.maskVector();
+    thePhase2OTMask = &phase2OTClustersToSkip.maskVector();
 }
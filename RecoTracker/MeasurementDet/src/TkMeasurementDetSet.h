@@ -13,6 +13,8 @@ class Phase2StripCPE;
 #include "DataFormats/Common/interface/DetSetVectorNew.h"
 #include "DataFormats/SiStripCluster/interface/SiStripCluster.h"
 #include "DataFormats/SiPixelCluster/interface/SiPixelCluster.h"
+#include "DataFormats/TrackerRecHit2D/interface/SiPixelRecHitQuality.h"
+#include "DataFormats/GeometrySurface/interface/LocalError.h"
 #include "DataFormats/Phase2TrackerCluster/interface/Phase2TrackerCluster1D.h"
 #include "RecoLocalTracker/Phase2TrackerRecHits/interface/Phase2StripCPE.h"
 #include "DataFormats/Common/interface/Handle.h"
@@ -341,6 +343,30 @@ public:
   typedef edmNew::DetSet<SiPixelCluster> PixelDetSet;
   typedef std::vector<std::pair<LocalPoint,LocalPoint> > BadFEDChannelPositions;
 
+  /* local parameters of all clusters of the event computed once with the
+   * track-independent CPE (getParameters(cluster,det)).
+   * Indexed as the cluster in the DetSetVector data: contiguous per det and thus per layer
+   */
+  struct HitCache {
+    std::vector<float> x, y, xx, xy, yy;
+    std::vector<SiPixelRecHitQuality::QualWordType> qual;
+
+    void resize(unsigned int n) {
+      x.resize(n); y.resize(n); xx.resize(n); xy.resize(n); yy.resize(n); qual.resize(n);
+    }
+    void clear() {
+      x.clear(); y.clear(); xx.clear(); xy.clear(); yy.clear(); qual.clear();
+    }
+    bool empty() const { return x.empty();}
+    void set(unsigned int i, LocalPoint const & lp, LocalError const & le, SiPixelRecHitQuality::QualWordType q) {
+      x[i]=lp.x(); y[i]=lp.y();
+      xx[i]=le.xx(); xy[i]=le.xy(); yy[i]=le.yy();
+      qual[i]=q;
+    }
+    LocalPoint position(unsigned int i) const { return LocalPoint(x[i],y[i]);}
+    LocalError error(unsigned int i) const { return LocalError(xx[i],xy[i],yy[i]);}
+  };
+
   PxMeasurementDetSet(const PxMeasurementConditionSet &cond) : 
     conditionSet_(&cond),
     detSet_(cond.nDet()),
@@ -377,6 +403,7 @@ public:
     std::fill(empty_.begin(),empty_.end(),true);
     std::fill(activeThisEvent_.begin(), activeThisEvent_.end(),true);
     badFEDChannelPositionsSet_.clear();
+    hitCache_.clear();
   }
   void setActiveThisEvent(bool active) {
     std::fill(activeThisEvent_.begin(), activeThisEvent_.end(),active);
@@ -404,6 +431,10 @@ public:
   const edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() const {  return handle_;}
   edm::Handle<edmNew::DetSetVector<SiPixelCluster> > & handle() {  return handle_;}
   const PixelDetSet & detSet(int i) const { return detSet_[i];}
+
+  bool hasHitCache() const { return !hitCache_.empty();}
+  const HitCache & hitCache() const { return hitCache_;}
+  HitCache & hitCache() { return hitCache_;}
 private:
   friend class MeasurementTrackerImpl;
 
@@ -411,6 +442,7 @@ private:
 
   // Globals, per-event
   edm::Handle<edmNew::DetSetVector<SiPixelCluster> > handle_;
+  HitCache hitCache_;
 
   // Locals, per-event
   std::vector<PixelDetSet> detSet_;
@@ -0,0 +1,100 @@
+// Compares two track collections built from the same clusters, e.g. with and
+// without MeasurementTrackerEvent.precomputePixelHits (see
+// precomputePixelHits_cfg.py).  The tracks are matched by their hits
+// (detector and local position); at the end of the job the numbers of tracks
+// found in both collections or in only one of them are printed, with the
+// largest difference of the parameters of the matched tracks, and an
+// exception is thrown if the fraction of unmatched tracks exceeds
+// maxUnmatchedFraction.
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/TrackReco/interface/Track.h"
+#include "DataFormats/TrackReco/interface/TrackFwd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class TrackCollectionComparator : public edm::EDAnalyzer {
+public:
+  explicit TrackCollectionComparator(const edm::ParameterSet&);
+  ~TrackCollectionComparator() override {}
+
+private:
+  void analyze(const edm::Event&, const edm::EventSetup&) override;
+  void endJob() override;
+
+  typedef std::vector<std::tuple<unsigned int,float,float> > HitKey;
+  static HitKey hitKey(const reco::Track & track);
+
+  edm::EDGetTokenT<reco::TrackCollection> referenceToken_, testToken_;
+  const double maxUnmatchedFraction_;
+
+  unsigned int nMatched_=0, nReferenceOnly_=0, nTestOnly_=0;
+  double maxDQoverP_=0, maxDPhi_=0, maxDEta_=0, maxDDxy_=0, maxDDz_=0;
+};
+
+TrackCollectionComparator::TrackCollectionComparator(const edm::ParameterSet& conf) :
+  referenceToken_(consumes<reco::TrackCollection>(conf.getParameter<edm::InputTag>("reference"))),
+  testToken_(consumes<reco::TrackCollection>(conf.getParameter<edm::InputTag>("test"))),
+  maxUnmatchedFraction_(conf.getParameter<double>("maxUnmatchedFraction"))
+{}
+
+TrackCollectionComparator::HitKey
+TrackCollectionComparator::hitKey(const reco::Track & track) {
+  HitKey key;
+  for (auto hit = track.recHitsBegin(); hit != track.recHitsEnd(); ++hit) {
+    if (!(*hit)->isValid()) continue;
+    key.emplace_back((*hit)->geographicalId().rawId(), (*hit)->localPosition().x(), (*hit)->localPosition().y());
+  }
+  return key;
+}
+
+void TrackCollectionComparator::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+  edm::Handle<reco::TrackCollection> reference, test;
+  iEvent.getByToken(referenceToken_, reference);
+  iEvent.getByToken(testToken_, test);
+
+  std::multimap<HitKey, const reco::Track *> testTracks;
+  for (auto const & track : *test) testTracks.emplace(hitKey(track), &track);
+
+  for (auto const & track : *reference) {
+    auto match = testTracks.find(hitKey(track));
+    if (match == testTracks.end()) { ++nReferenceOnly_; continue; }
+    auto const & other = *match->second;
+    ++nMatched_;
+    maxDQoverP_ = std::max(maxDQoverP_, std::abs(track.qoverp()-other.qoverp()));
+    maxDPhi_ = std::max(maxDPhi_, std::abs(track.phi()-other.phi()));
+    maxDEta_ = std::max(maxDEta_, std::abs(track.eta()-other.eta()));
+    maxDDxy_ = std::max(maxDDxy_, std::abs(track.dxy()-other.dxy()));
+    maxDDz_ = std::max(maxDDz_, std::abs(track.dz()-other.dz()));
+    testTracks.erase(match);
+  }
+  nTestOnly_ += testTracks.size();
+}
+
+void TrackCollectionComparator::endJob()
+{
+  const unsigned int nTotal = nMatched_ + std::max(nReferenceOnly_, nTestOnly_);
+  const double unmatchedFraction = nTotal ? double(std::max(nReferenceOnly_, nTestOnly_))/nTotal : 0.;
+  edm::LogPrint("TrackCollectionComparator")
+    << nMatched_ << " tracks with the same hits, " << nReferenceOnly_ << " only in the reference, "
+    << nTestOnly_ << " only in the test collection\n"
+    << "largest differences of the matched tracks: q/p " << maxDQoverP_ << " phi " << maxDPhi_
+    << " eta " << maxDEta_ << " dxy " << maxDDxy_ << " dz " << maxDDz_;
+  if (unmatchedFraction > maxUnmatchedFraction_)
+    throw cms::Exception("TrackCollectionComparator")
+      << "fraction of unmatched tracks " << unmatchedFraction << " larger than " << maxUnmatchedFraction_;
+}
+
+DEFINE_FWK_MODULE(TrackCollectionComparator);
@@ -0,0 +1,57 @@
+# Build the initial-step tracks twice from the same RAW events, with the
+# default MeasurementTrackerEvent and with precomputePixelHits = True, and
+# compare them with TrackCollectionComparator.
+#
+#   cmsRun precomputePixelHits_cfg.py inputFiles=file:raw.root maxEvents=100
+
+import FWCore.ParameterSet.Config as cms
+from FWCore.ParameterSet.VarParsing import VarParsing
+from Configuration.StandardSequences.Eras import eras
+
+options = VarParsing('analysis')
+options.parseArguments()
+
+process = cms.Process("TEST",eras.Run2_2017)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.load("Configuration.StandardSequences.Services_cff")
+process.load("Configuration.StandardSequences.FrontierConditions_GlobalTag_cff")
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag,'auto:phase1_2017_realistic', '')
+process.load('Configuration.StandardSequences.GeometryRecoDB_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.RawToDigi_cff')
+process.load('Configuration.StandardSequences.Reconstruction_cff')
+
+# the same initial step, with the pixel clusters preselected with the cached hits
+process.MeasurementTrackerEventPrecomputed = process.MeasurementTrackerEvent.clone(
+    precomputePixelHits = True
+)
+process.initialStepTrackCandidatesPrecomputed = process.initialStepTrackCandidates.clone(
+    MeasurementTrackerEvent = 'MeasurementTrackerEventPrecomputed'
+)
+process.initialStepTracksPrecomputed = process.initialStepTracks.clone(
+    src = 'initialStepTrackCandidatesPrecomputed',
+    MeasurementTrackerEvent = 'MeasurementTrackerEventPrecomputed'
+)
+
+process.compareTracks = cms.EDAnalyzer("TrackCollectionComparator",
+    reference = cms.InputTag("initialStepTracks"),
+    test = cms.InputTag("initialStepTracksPrecomputed"),
+    # the refined hits are the same, only clusters lost by the preselection
+    # with the cached hits can change the tracks
+    maxUnmatchedFraction = cms.double(0.01)
+)
+
+process.p = cms.Path(process.RawToDigi
+                     * process.reconstruction_trackingOnly
+                     * process.MeasurementTrackerEventPrecomputed
+                     * process.initialStepTrackCandidatesPrecomputed
+                     * process.initialStepTracksPrecomputed
+                     * process.compareTracks)
@@ -7,6 +7,7 @@
 
 class DetLayer;
 class TrackingRegion;
+class HitRZCompatibility;
 
 class HitPairGeneratorFromLayerPair {
 
@@ -54,6 +55,13 @@ public:
 						      const unsigned int theMaxElement,
 						      HitDoublets & result);
 
+  // The hits of innerHitsMap in the phi range compatible in rz with checkRZ, in increasing
+  // order in each of the (at most two) parts of the range.  With useGrid and HitZCheck the
+  // v bins of innerHitsMap.grid that checkRZ cannot reach are skipped: the result is the same.
+  static void innerHits(const RecHitsSortedInPhi & innerHitsMap,
+			const HitRZCompatibility & checkRZ,
+			float phiMin, float phiMax, bool useGrid,
+			std::vector<int> & result);
   
   
   Layer innerLayer(const Layers& layers) const { return layers[theInnerLayer]; }
@@ -3,9 +3,11 @@
 
 #include "DataFormats/TrackerRecHit2D/interface/BaseTrackerRecHit.h"
 #include "TrackingTools/DetLayers/interface/DetLayer.h"
+#include "DataFormats/GeometryVector/interface/Pi.h"
 
 #include <vector>
 #include<array>
+#include<algorithm>
 
 #include<cassert>
 
@@ -85,7 +87,9 @@ public:
     return Range(theHits.begin(), theHits.end());
   }
 
-public:
+  // (re)builds the grid below from the hits; done by the constructor for the layers with many hits
+  void buildGrid();
+
   float       phi(int i) const { return theHits[i].phi();}
   float       gv(int i) const { return isBarrel ? z[i] : gp(i).perp();}  // global v
   float       rv(int i) const { return isBarrel ? u[i] : v[i];}  // dispaced r
@@ -112,6 +116,22 @@ public:
   std::vector<float> dv;
   std::vector<float> lphi;
 
+  // Grid of the hit indices in (phi, v), built for the layers with many hits:
+  //  the hits of cell (p,iv) are cellHits[cellBegin[p*nV+iv]..cellBegin[p*nV+iv+1]], in increasing order.
+  //  The v bins are the same in all phi bins, vBinMin/vBinMax are the v extent of the hits in each of them.
+  struct Grid {
+    bool empty() const { return cellBegin.empty();}
+    int phiBin(float phi) const { return std::min(nPhi-1, std::max(0, int((phi+Geom::fpi())*phiScale)));}
+    int vBin(float vv) const { return std::min(nV-1, std::max(0, int((vv-vMin)*vScale)));}
+    int nPhi=0, nV=0;
+    float phiScale=0, vMin=0, vScale=0;
+    float uMin=0, uMax=0, dvMax=0;
+    std::vector<float> vBinMin, vBinMax;
+    std::vector<unsigned int> cellBegin;
+    std::vector<unsigned int> cellHits;
+  };
+  Grid grid;
+
   static void copyResult( const Range& range, std::vector<Hit>& result) {
     result.reserve(result.size()+(range.second-range.first));
     for (HitIter i = range.first; i != range.second; i++) result.push_back( i->hit());
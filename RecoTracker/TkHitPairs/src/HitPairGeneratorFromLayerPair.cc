@@ -62,6 +62,19 @@ namespace {
 	ok[i-b] = ! crossRange.empty() ;
       }
     }
+
+    // same on the n hits of index idx[0..n]
+    void operator()(int n, int const * idx, const RecHitsSortedInPhi & innerHitsMap, bool * ok) const {
+      constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+      for (int k=0; k!=n; ++k) {
+	int i = idx[k];
+	Range allowed = checkRZ->range(innerHitsMap.u[i]);
+	float vErr = nSigmaRZ * innerHitsMap.dv[i];
+	Range hitRZ(innerHitsMap.v[i]-vErr, innerHitsMap.v[i]+vErr);
+	Range crossRange = allowed.intersection(hitRZ);
+	ok[k] = ! crossRange.empty() ;
+      }
+    }
     Algo const * checkRZ;
     
   };
@@ -72,6 +85,81 @@ namespace {
 }
 
 
+void HitPairGeneratorFromLayerPair::innerHits(const RecHitsSortedInPhi & innerHitsMap,
+					      const HitRZCompatibility & checkRZ,
+					      float phiMin, float phiMax, bool useGrid,
+					      std::vector<int> & result) {
+  constexpr float nSigmaRZ = 3.46410161514f; // std::sqrt(12.f);
+  constexpr float gridMargin = 0.01f; // float rounding of the z range
+  result.clear();
+  Kernels<HitZCheck,HitRCheck,HitEtaCheck> kernels;
+  auto const & grid = innerHitsMap.grid;
+
+  // with HitZCheck the allowed z is linear in r: at any r of the inner layer it is inside
+  // the hull of the ones at its smallest and largest r, the v bins out of it can be skipped
+  int vb0=0, vb1=-1;
+  useGrid &= checkRZ.algo()==HitRZCompatibility::zAlgo && !grid.empty();
+  if (useGrid) {
+    auto r0 = checkRZ.range(grid.uMin);
+    auto r1 = checkRZ.range(grid.uMax);
+    float lo = std::min(r0.min(),r1.min()) - gridMargin;
+    float hi = std::max(r0.max(),r1.max()) + gridMargin;
+    float vErr = nSigmaRZ*grid.dvMax;
+    for (int iv=0; iv!=grid.nV; ++iv) {
+      if (grid.vBinMax[iv]+vErr < lo || grid.vBinMin[iv]-vErr > hi) continue;
+      if (vb1<0) vb0=iv;
+      vb1=iv;
+    }
+    if (vb1<0) return;
+    useGrid = vb1-vb0+1 < grid.nV;
+  }
+
+  auto innerRange = innerHitsMap.doubleRange(phiMin, phiMax);
+  for(int j=0; j<3; j+=2) {
+    auto b = innerRange[j]; auto e=innerRange[j+1];
+    if (b==e) continue;
+    if (useGrid) {
+      // hits of the selected v bins, in increasing order as without the grid
+      int first = result.size();
+      auto p1 = grid.phiBin(innerHitsMap.phi(e-1));
+      for (auto p=grid.phiBin(innerHitsMap.phi(b)); p<=p1; ++p) {
+	auto pFirst = result.size();
+	for (auto k=grid.cellBegin[p*grid.nV+vb0]; k!=grid.cellBegin[p*grid.nV+vb1+1]; ++k) {
+	  int i = grid.cellHits[k];
+	  if (i>=b && i<e) result.push_back(i);
+	}
+	std::sort(result.begin()+pFirst,result.end());
+      }
+      int n = result.size()-first;
+      if (n==0) continue;
+      bool ok[n];
+      std::get<0>(kernels).set(&checkRZ);
+      std::get<0>(kernels)(n, result.data()+first, innerHitsMap, ok);
+      int m = first;
+      for (int k=0; k!=n; ++k) if (ok[k]) result[m++] = result[first+k];
+      result.resize(m);
+      continue;
+    }
+    bool ok[e-b];
+    switch (checkRZ.algo()) {
+      case (HitRZCompatibility::zAlgo) :
+	std::get<0>(kernels).set(&checkRZ);
+	std::get<0>(kernels)(b,e,innerHitsMap, ok);
+	break;
+      case (HitRZCompatibility::rAlgo) :
+	std::get<1>(kernels).set(&checkRZ);
+	std::get<1>(kernels)(b,e,innerHitsMap, ok);
+	break;
+      case (HitRZCompatibility::etaAlgo) :
+	std::get<2>(kernels).set(&checkRZ);
+	std::get<2>(kernels)(b,e,innerHitsMap, ok);
+	break;
+    }
+    for (int i=0; i!=e-b; ++i) if (ok[i]) result.push_back(b+i);
+  }
+}
+
+
 void HitPairGeneratorFromLayerPair::hitPairs(
 					     const TrackingRegion & region, OrderedHitPairs & result,
 					     const edm::Event& iEvent, const edm::EventSetup& iSetup, Layers layers) {
@@ -121,6 +209,7 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 
   // constexpr float nSigmaRZ = std::sqrt(12.f);
   constexpr float nSigmaPhi = 3.f;
+  std::vector<int> inner;
   for (int io = 0; io!=int(outerHitsMap.theHits.size()); ++io) {
     if (!deltaPhi.prefilter(outerHitsMap.x[io],outerHitsMap.y[io])) continue;
     Hit const & ohit =  outerHitsMap.theHits[io].hit();
@@ -139,41 +228,18 @@ void HitPairGeneratorFromLayerPair::doublets(const TrackingRegion& region,
 						       );
     if(!checkRZ) continue;
 
-    Kernels<HitZCheck,HitRCheck,HitEtaCheck> kernels;
-
-    auto innerRange = innerHitsMap.doubleRange(phiRange.min(), phiRange.max());
+    innerHits(innerHitsMap, *checkRZ, phiRange.min(), phiRange.max(), true, inner);
+    delete checkRZ;
     LogDebug("HitPairGeneratorFromLayerPair")<<
-      "preparing for combination of: "<< innerRange[1]-innerRange[0]+innerRange[3]-innerRange[2]
-				      <<" inner and: "<< outerHitsMap.theHits.size()<<" outter";
-    for(int j=0; j<3; j+=2) {
-      auto b = innerRange[j]; auto e=innerRange[j+1];
-      bool ok[e-b];
-      switch (checkRZ->algo()) {
-	case (HitRZCompatibility::zAlgo) :
-	  std::get<0>(kernels).set(checkRZ);
-	  std::get<0>(kernels)(b,e,innerHitsMap, ok);
-	  break;
-	case (HitRZCompatibility::rAlgo) :
-	  std::get<1>(kernels).set(checkRZ);
-	  std::get<1>(kernels)(b,e,innerHitsMap, ok);
-	  break;
-	case (HitRZCompatibility::etaAlgo) :
-	  std::get<2>(kernels).set(checkRZ);
-	  std::get<2>(kernels)(b,e,innerHitsMap, ok);
-	  break;
-      }
-      for (int i=0; i!=e-b; ++i) {
-	if (!ok[i]) continue;
-	if (theMaxElement!=0 && result.size() >= theMaxElement){
-	  result.clear();
-	  edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
-	  delete checkRZ;
-	  return;
-	}
-        result.add(b+i,io);
+      "combining "<< inner.size() <<" compatible inner hits with outer hit "<< io <<" of "<< outerHitsMap.theHits.size();
+    for (auto i : inner) {
+      if (theMaxElement!=0 && result.size() >= theMaxElement){
+	result.clear();
+	edm::LogError("TooManyPairs")<<"number of pairs exceed maximum, no pairs produced";
+	return;
       }
+      result.add(i,io);
     }
-    delete checkRZ;
   }
   LogDebug("HitPairGeneratorFromLayerPair")<<" total number of pairs provided back: "<<result.size();
   result.shrink_to_fit();
@@ -3,7 +3,13 @@
 
 #include <algorithm>
 #include<cassert>
+#include<limits>
 
+namespace {
+  constexpr unsigned int minHitsForGrid = 64;
+  constexpr int maxPhiBins = 128;
+  constexpr int maxVBins = 8;
+}
 
 
 RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint const & origin, DetLayer const * il) :
@@ -44,10 +50,44 @@ RecHitsSortedInPhi::RecHitsSortedInPhi(const std::vector<Hit>& hits, GlobalPoint
     dv[i] = isBarrel ? dz : dr;
     lphi[i] = loc.barePhi();
   }
+
+  if (theHits.size()>=minHitsForGrid) buildGrid();
   
 }
 
 
+void RecHitsSortedInPhi::buildGrid() {
+  int n = theHits.size();
+  auto & g = grid;
+  g.nPhi = std::min(maxPhiBins, n/16);
+  g.phiScale = g.nPhi/Geom::ftwoPi();
+  auto vRange = std::minmax_element(v.begin(),v.end());
+  g.vMin = *vRange.first;
+  float vSpan = *vRange.second - g.vMin;
+  g.nV = vSpan>0 ? std::min(maxVBins, std::max(1, n/(2*g.nPhi))) : 1;
+  g.vScale = vSpan>0 ? g.nV/vSpan : 0;
+  auto uRange = std::minmax_element(u.begin(),u.end());
+  g.uMin = *uRange.first; g.uMax = *uRange.second;
+  g.dvMax = *std::max_element(dv.begin(),dv.end());
+
+  g.vBinMin.assign(g.nV, std::numeric_limits<float>::max());
+  g.vBinMax.assign(g.nV, -std::numeric_limits<float>::max());
+  std::vector<unsigned int> cell(n);
+  g.cellBegin.assign(g.nPhi*g.nV+1, 0);
+  for (int i=0; i!=n; ++i) {
+    auto iv = g.vBin(v[i]);
+    g.vBinMin[iv] = std::min(g.vBinMin[iv],v[i]);
+    g.vBinMax[iv] = std::max(g.vBinMax[iv],v[i]);
+    cell[i] = g.phiBin(phi(i))*g.nV + iv;
+    ++g.cellBegin[cell[i]+1];
+  }
+  for (int c=0; c!=g.nPhi*g.nV; ++c) g.cellBegin[c+1] += g.cellBegin[c];
+  g.cellHits.resize(n);
+  std::vector<unsigned int> next(g.cellBegin.begin(), g.cellBegin.end()-1);
+  for (int i=0; i!=n; ++i) g.cellHits[next[cell[i]]++] = i;
+}
+
+
 RecHitsSortedInPhi::DoubleRange RecHitsSortedInPhi::doubleRange(float phiMin, float phiMax) const {
   Range r1,r2;
   if ( phiMin < phiMax) {
@@ -0,0 +1,168 @@
+// Check that HitPairGeneratorFromLayerPair::innerHits gives the same inner
+// hits, in the same order, when the v bins of the RecHitsSortedInPhi grid that
+// a HitZCheck cannot reach are skipped (useGrid = true) as when all the hits of
+// the phi range are tested (useGrid = false).  The hits are on a barrel layer
+// with modules at different radii; the phi ranges cross -pi/pi in the three
+// ways accepted by RecHitsSortedInPhi::doubleRange, and the rz constraints are
+// random, outside the layer, covering the whole layer, or with their edge
+// exactly at the error of a hit: of the hit at the smallest or largest radius,
+// where the hull of the allowed ranges is computed, or, with nearly flat
+// lines, of the lowest or highest hit of a v bin with the largest error, so
+// that the bin is kept only if the hull (with its margin) reaches it.
+
+#include "RecoTracker/TkHitPairs/interface/HitPairGeneratorFromLayerPair.h"
+#include "RecoTracker/TkHitPairs/interface/RecHitsSortedInPhi.h"
+#include "RecoTracker/TkTrackingRegions/interface/HitZCheck.h"
+#include "TrackingTools/DetLayers/interface/BarrelDetLayer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+  // a barrel layer without geometry, for RecHitsSortedInPhi
+  class TestLayer final : public BarrelDetLayer {
+  public:
+    TestLayer() : BarrelDetLayer(false) {}
+    SubDetector subDetector() const override { return GeomDetEnumerators::PixelBarrel; }
+    const std::vector<const GeometricSearchDet*>& components() const override { return theComponents; }
+    const std::vector<const GeomDet*>& basicComponents() const override { return theBasicComponents; }
+  private:
+    std::vector<const GeometricSearchDet*> theComponents;
+    std::vector<const GeomDet*> theBasicComponents;
+  };
+
+  constexpr float nSigmaRZ = 3.46410161514f; // as in HitPairGeneratorFromLayerPair
+
+  struct Hit { float phi, r, z, dz; };
+
+  // the hits sorted in phi, and their grid, as by the RecHitsSortedInPhi constructor
+  void fill(std::vector<Hit> hits, RecHitsSortedInPhi& map) {
+    std::sort(hits.begin(), hits.end(), [](const Hit& a, const Hit& b) { return a.phi < b.phi; });
+    for (auto const& h : hits) {
+      map.theHits.emplace_back(h.phi);
+      map.x.push_back(h.r*std::cos(h.phi)); map.y.push_back(h.r*std::sin(h.phi)); map.z.push_back(h.z);
+      map.drphi.push_back(15.e-4);
+      map.u.push_back(h.r); map.v.push_back(h.z);
+      map.du.push_back(0.); map.dv.push_back(h.dz);
+      map.lphi.push_back(h.phi);
+    }
+    map.buildGrid();
+  }
+
+  std::vector<Hit> generate(std::mt19937& rng, unsigned int n) {
+    std::uniform_real_distribution<float> phi(-M_PI,M_PI), r(6.5,7.5), z(-26.,26.), dz(0.002,0.05);
+    std::vector<Hit> hits;
+    // half of the hits with the largest error, used for the v extent of the grid bins
+    for (unsigned int i = 0; i < n; ++i) hits.push_back({phi(rng), r(rng), z(rng), i%2 ? 0.05f : dz(rng)});
+    // hits at the ends of the phi range, and at the same phi
+    hits.push_back({float(-M_PI), r(rng), z(rng), dz(rng)});
+    hits.push_back({float(M_PI), r(rng), z(rng), dz(rng)});
+    for (int i = 0; i < 4; ++i) hits.push_back({0.5f, r(rng), z(rng), dz(rng)});
+    return hits;
+  }
+
+  HitZCheck check(float z0Left, float cotLeft, float z0Right, float cotRight) {
+    return HitZCheck(HitRZConstraint(PixelRecoPointRZ(0.f,z0Left), cotLeft, PixelRecoPointRZ(0.f,z0Right), cotRight));
+  }
+
+  // a line of slope cot through (r, z)
+  float z0(float r, float z, float cot) { return z - cot*r; }
+
+  // the smallest z0 for which the z at r of the line of slope cot, in float, is not below z
+  float z0Above(float r, float z, float cot) {
+    float z0 = z - cot*r;
+    while (check(z0,cot,z0,cot).range(r).min() < z) z0 = std::nextafter(z0,1.e9f);
+    while (check(z0,cot,z0,cot).range(r).min() >= z) z0 = std::nextafter(z0,-1.e9f);
+    return std::nextafter(z0,1.e9f);
+  }
+
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> flat(0.,1.);
+  TestLayer layer;
+  RecHitsSortedInPhi map(std::vector<RecHitsSortedInPhi::Hit>(), GlobalPoint(0,0,0), &layer);
+  fill(generate(rng,3000), map);
+  assert(!map.grid.empty());
+  std::cout << map.size() << " hits, grid of " << map.grid.nPhi << " x " << map.grid.nV << " cells" << std::endl;
+
+  const auto rMin = std::min_element(map.u.begin(), map.u.end()) - map.u.begin();
+  const auto rMax = std::max_element(map.u.begin(), map.u.end()) - map.u.begin();
+
+  std::vector<int> withGrid, withoutGrid;
+  int failed = 0, nonEmpty = 0, wrapped = 0;
+  unsigned long nHits = 0;
+  for (int q = 0; q < 40000; ++q) {
+    // phi ranges up to 0.6 wide anywhere, in the forms (-4,-3), (3,4) and (3,-3)
+    const float phiC = M_PI*(2.f*flat(rng)-1.f), dPhi = 0.3f*flat(rng);
+    float phiMin = phiC-dPhi, phiMax = phiC+dPhi;
+    if (phiMax > float(M_PI) && q%2) phiMax -= 2.f*M_PI;
+    wrapped += phiMin < -float(M_PI) || phiMax > float(M_PI) || phiMax < phiMin;
+
+    const float cot = 6.f*(flat(rng)-0.5f), cotRight = cot + 0.2f*flat(rng);
+    const float zc = 40.f*(flat(rng)-0.5f), dz = 3.f*flat(rng);
+    HitZCheck checkRZ;
+    switch (q%7) {
+      case 0: // random
+      case 1:
+	checkRZ = check(zc-dz, cot, zc+dz, cotRight);
+	break;
+      case 2: // whole layer, or out of it
+	checkRZ = q%3 ? check(-100.f, 0.f, 100.f, 0.f) : check(60.f+zc, 0.f, 80.f+zc, 0.f);
+	break;
+      case 3: { // upper edge at the lower error of the hit at the smallest or largest r
+	const int i = q%2 ? rMin : rMax;
+	const float edge = map.v[i] - nSigmaRZ*map.dv[i];
+	checkRZ = check(z0(map.u[i],edge-dz,cot), cot, z0(map.u[i],edge,cotRight), cotRight);
+	break;
+      }
+      case 4: { // lower edge at the upper error of the hit at the smallest or largest r
+	const int i = q%2 ? rMin : rMax;
+	const float edge = map.v[i] + nSigmaRZ*map.dv[i];
+	checkRZ = check(z0(map.u[i],edge,cot), cot, z0(map.u[i],edge+dz,cotRight), cotRight);
+	break;
+      }
+      case 5: // nearly flat, upper edge exactly at the lower error of the lowest hit of a v bin,
+      case 6: { // or lower edge at the upper error of the highest one
+	const auto& g = map.grid;
+	const int iv = q % g.nV;
+	const bool lower = q%7 == 5;
+	const int i = std::find(map.v.begin(), map.v.end(), lower ? g.vBinMin[iv] : g.vBinMax[iv]) - map.v.begin();
+	const float flatCot = 1.e-6f*(flat(rng)-0.5f);
+	if (lower) {
+	  const float edge = map.v[i] - nSigmaRZ*map.dv[i];
+	  checkRZ = check(edge-dz, flatCot, z0Above(map.u[i],edge,flatCot), flatCot);
+	} else {
+	  const float edge = map.v[i] + nSigmaRZ*map.dv[i];
+	  // the largest z0 for which the lower edge at the hit is not above its upper error
+	  float zLeft = z0Above(map.u[i],edge,flatCot);
+	  while (check(zLeft,flatCot,zLeft,flatCot).range(map.u[i]).min() > edge) zLeft = std::nextafter(zLeft,-1.e9f);
+	  checkRZ = check(zLeft, flatCot, edge+dz, flatCot);
+	}
+	break;
+      }
+    }
+
+    HitPairGeneratorFromLayerPair::innerHits(map, checkRZ, phiMin, phiMax, true, withGrid);
+    HitPairGeneratorFromLayerPair::innerHits(map, checkRZ, phiMin, phiMax, false, withoutGrid);
+    nonEmpty += !withoutGrid.empty();
+    nHits += withoutGrid.size();
+    if (withGrid != withoutGrid) {
+      ++failed;
+      std::cout << "phi (" << phiMin << ", " << phiMax << "), query " << q << ": "
+		<< withGrid.size() << " hits with the grid, " << withoutGrid.size() << " without" << std::endl;
+    }
+  }
+  std::cout << "40000 queries, " << wrapped << " across -pi/pi, " << nonEmpty << " with hits (" << nHits
+	    << " in total): " << failed << " differences" << std::endl;
+
+  const bool ok = failed == 0 && wrapped > 0 && nonEmpty > 0;
+  assert(ok);
+  return ok ? 0 : 1;
+}
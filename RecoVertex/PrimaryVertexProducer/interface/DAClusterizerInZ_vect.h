@@ -7,6 +7,11 @@
 
 	Version which auto-vectorizes with gcc 4.6 or newer
 
+	With runInBlocks the tracks are updated in blocks of consecutive z, processed in
+	parallel: each block only loops on the vertices it can reach (the others have
+	exactly zero weight) and the sums of the blocks are added in a fixed order, so the
+	result does not depend on the number of threads
+
  */
 
 #include "RecoVertex/PrimaryVertexProducer/interface/TrackClusterizerInZ.h"
@@ -63,6 +68,13 @@ public:
     
     std::vector<double> Z_sum; // Z[i]   for DA clustering
     std::vector<double> pi; // track weight
+
+    // runInBlocks: blocks of tracks consecutive in z (the tracks themselves are not reordered)
+    std::vector<unsigned int> zorder; // track indices in increasing z
+    std::vector<unsigned int> block_begin; // first position in zorder of each block, and the end
+    std::vector<double> block_zmin; // z range of the block
+    std::vector<double> block_zmax;
+    std::vector<double> block_dz2min; // smallest 1/error^2 of the block
   };
   
   struct vertex_t {
@@ -181,6 +193,8 @@ public:
   double update(double beta, track_t & gtracks,
 		vertex_t & gvertices, bool useRho0, const double & rho0) const;
 
+  void makeBlocks(track_t & tks) const;
+
   void dump(const double beta, const vertex_t & y,
 	    const track_t & tks, const int verbosity = 0) const;
   bool merge(vertex_t & y, double & beta)const;
@@ -211,6 +225,9 @@ private:
   double zmerge_;
   double betapurge_;
 
+  bool runInBlocks_; // update the tracks in z blocks, in parallel
+  unsigned int blockSize_;
+
 };
 
 
@@ -81,6 +81,7 @@ private:
 
   edm::ParameterSet theConfig;
   bool fVerbose;
+  bool fFitInParallel; // fit the clusters concurrently
 
   edm::EDGetTokenT<reco::BeamSpot> bsToken;
   edm::EDGetTokenT<reco::TrackCollection> trkToken;
@@ -18,11 +18,16 @@
 
 #include "RecoVertex/VertexTools/interface/GeometricAnnealing.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+
 PrimaryVertexProducer::PrimaryVertexProducer(const edm::ParameterSet& conf)
   :theConfig(conf)
 {
 
   fVerbose   = conf.getUntrackedParameter<bool>("verbose", false);
+  fFitInParallel = conf.existsAs<bool>("fitInParallel") ? conf.getParameter<bool>("fitInParallel") : false;
 
   trkToken = consumes<reco::TrackCollection>(conf.getParameter<edm::InputTag>("TrackLabel"));
   bsToken = consumes<reco::BeamSpot>(conf.getParameter<edm::InputTag>("beamSpotLabel"));
@@ -189,10 +194,8 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
     reco::VertexCollection & vColl = (*result);
 
 
-    std::vector<TransientVertex> pvs;
-    for (std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus
-	   = clusters.begin(); iclus != clusters.end(); iclus++) {
-      
+    auto fitCluster = [&](const VertexFitter<5> & fitter,
+			  std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus) {
       double meantime = 0.;
       double expv_x2 = 0.;
       double normw = 0.;  
@@ -214,7 +217,7 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
       TransientVertex v; 
       if( algorithm->useBeamConstraint && validBS &&((*iclus).size()>1) ){
         
-	v = algorithm->fitter->vertex(*iclus, beamSpot);
+	v = fitter.vertex(*iclus, beamSpot);
 	
         if( f4D ) {
           if( v.isValid() ) {
@@ -226,7 +229,7 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
 	
       }else if( !(algorithm->useBeamConstraint) && ((*iclus).size()>1) ) {
               
-	v = algorithm->fitter->vertex(*iclus);
+	v = fitter.vertex(*iclus);
         
         if( f4D ) {
           if( v.isValid() ) {
@@ -237,6 +240,28 @@ PrimaryVertexProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup
         }
 	
       }// else: no fit ==> v.isValid()=False
+      return v;
+    };
+
+    // the clusters are independent: they can be fitted concurrently, each thread with its own fitter,
+    // the selection below keeps the order of the clusters
+    std::vector<TransientVertex> fitted(clusters.size());
+    if (fFitInParallel && clusters.size()>1) {
+      tbb::enumerable_thread_specific<std::unique_ptr<VertexFitter<5> > > fitters(
+	[&algorithm](){ return std::unique_ptr<VertexFitter<5> >(algorithm->fitter->clone()); });
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, clusters.size()),
+			[&](const tbb::blocked_range<size_t> & r) {
+	auto const & fitter = *fitters.local();
+	for (auto i = r.begin(); i != r.end(); ++i) fitted[i] = fitCluster(fitter, clusters.begin()+i);
+      });
+    } else {
+      for (size_t i = 0; i < clusters.size(); ++i) fitted[i] = fitCluster(*algorithm->fitter, clusters.begin()+i);
+    }
+
+    std::vector<TransientVertex> pvs;
+    for (std::vector< std::vector<reco::TransientTrack> >::const_iterator iclus
+	   = clusters.begin(); iclus != clusters.end(); iclus++) {
+      TransientVertex const & v = fitted[iclus-clusters.begin()];
 
 
       if (fVerbose){
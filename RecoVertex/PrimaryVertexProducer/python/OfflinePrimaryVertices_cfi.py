@@ -8,6 +8,7 @@ offlinePrimaryVertices = cms.EDProducer(
     verbose = cms.untracked.bool(False),
     TrackLabel = cms.InputTag("generalTracks"),
     beamSpotLabel = cms.InputTag("offlineBeamSpot"),
+    fitInParallel = cms.bool(False), # fit the vertex candidates concurrently
     
     TkFilterParameters = cms.PSet(
         algorithm=cms.string('filter'),
@@ -11,7 +11,9 @@ DA_vectParameters = cms.PSet(
         d0CutOff = cms.double(3.),        # downweight high IP tracks 
         dzCutOff = cms.double(3.),        # outlier rejection after freeze-out (T<Tmin)       
         zmerge = cms.double(1e-2),        # merge intermediat clusters separated by less than zmerge
-        uniquetrkweight = cms.double(0.8) # require at least two tracks with this weight at T=Tpurge
+        uniquetrkweight = cms.double(0.8),# require at least two tracks with this weight at T=Tpurge
+        runInBlocks = cms.bool(False),    # update blocks of tracks consecutive in z in parallel
+        blockSize = cms.uint32(512)       # number of tracks per block
         )
 )
 
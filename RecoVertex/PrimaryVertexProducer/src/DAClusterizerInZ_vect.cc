@@ -10,6 +10,9 @@
 #include "FWCore/Utilities/interface/isFinite.h"
 #include "vdt/vdtMath.h"
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace std;
 
 DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
@@ -39,6 +42,9 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
   dzCutOff_ = conf.getParameter<double> ("dzCutOff");
   uniquetrkweight_ = conf.getParameter<double>("uniquetrkweight");
   zmerge_ = conf.getParameter<double>("zmerge");
+  runInBlocks_ = conf.existsAs<bool>("runInBlocks") ? conf.getParameter<bool>("runInBlocks") : false;
+  blockSize_ = conf.existsAs<unsigned int>("blockSize") ? conf.getParameter<unsigned int>("blockSize") : 512;
+  if (blockSize_ == 0) blockSize_ = 512;
 
   if(verbose_){
     std::cout << "DAClusterizerinZ_vect: mintrkweight = " << mintrkweight_ << std::endl;
@@ -51,6 +57,7 @@ DAClusterizerInZ_vect::DAClusterizerInZ_vect(const edm::ParameterSet& conf) {
     std::cout << "DAClusterizerinZ_vect: coolingFactor = " << coolingFactor_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: d0CutOff = " << d0CutOff_ << std::endl;
     std::cout << "DAClusterizerinZ_vect: dzCutOff = " << dzCutOff_ << std::endl;
+    std::cout << "DAClusterizerinZ_vect: runInBlocks = " << runInBlocks_ << " blockSize = " << blockSize_ << std::endl;
   }
 
 
@@ -121,6 +128,7 @@ DAClusterizerInZ_vect::fill(const vector<reco::TransientTrack> & tracks) const {
     tks.AddItem(t_z, t_dz2, &(*it), t_pi);
   }
   tks.ExtractRaw();
+  if (runInBlocks_) makeBlocks(tks);
   
   if (verbose_) {
     std::cout << "Track count " << tks.GetSize() << std::endl;
@@ -130,11 +138,125 @@ DAClusterizerInZ_vect::fill(const vector<reco::TransientTrack> & tracks) const {
 }
 
 
+void DAClusterizerInZ_vect::makeBlocks(track_t & tks) const {
+  // cut the tracks, ordered in z, in blocks of blockSize_
+  const unsigned int nt = tks.GetSize();
+  tks.zorder.resize(nt);
+  for (unsigned int i = 0; i < nt; ++i) tks.zorder[i] = i;
+  std::stable_sort(tks.zorder.begin(), tks.zorder.end(),
+		   [&tks](unsigned int a, unsigned int b) { return tks.z[a] < tks.z[b]; });
+
+  tks.block_begin.clear();
+  tks.block_zmin.clear();
+  tks.block_zmax.clear();
+  tks.block_dz2min.clear();
+  for (unsigned int b = 0; b < nt; b += blockSize_) {
+    const unsigned int e = std::min(nt, b + blockSize_);
+    double dz2min = tks.dz2[tks.zorder[b]];
+    for (unsigned int j = b + 1; j < e; ++j) dz2min = std::min(dz2min, tks.dz2[tks.zorder[j]]);
+    tks.block_begin.push_back(b);
+    tks.block_zmin.push_back(tks.z[tks.zorder[b]]);
+    tks.block_zmax.push_back(tks.z[tks.zorder[e - 1]]);
+    tks.block_dz2min.push_back(dz2min);
+  }
+  tks.block_begin.push_back(nt);
+}
+
+
 namespace {
   inline
   double Eik(double t_z, double k_z, double t_dz2) {
     return std::pow(t_z - k_z, 2) * t_dz2;
   }
+
+  // vdt::fast_exp is exactly 0 below -708
+  constexpr double maxBlockExpArg = 710.;
+
+  // the track loop of update() on the blocks of runInBlocks, in parallel
+  // the vertices of the sums must have been reset
+  void updateInBlocks(const double beta, const double Z_init,
+		      DAClusterizerInZ_vect::track_t & tks, DAClusterizerInZ_vect::vertex_t & y) {
+    const unsigned int nv = y.GetSize();
+    const unsigned int nblocks = tks.block_begin.size() - 1;
+    const double obeta = -1./beta;
+
+    // per block: ei_cache, ei, se, sw, swz, swE and the range of vertices used
+    std::vector<double> buffer(6*nv*nblocks, 0.);
+    std::vector<unsigned int> vrange(2*nblocks);
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, nblocks, 1),
+		      [&](const tbb::blocked_range<unsigned int> & r) {
+      for (auto ib = r.begin(); ib != r.end(); ++ib) {
+	// the vertices whose exp() underflows for all the tracks of the block do not contribute
+	unsigned int k0 = nv, k1 = 0;
+	for (unsigned int k = 0; k < nv; ++k) {
+	  double d = std::max(0., std::max(tks.block_zmin[ib] - y._z[k], y._z[k] - tks.block_zmax[ib]));
+	  if (beta * tks.block_dz2min[ib] * d * d < maxBlockExpArg) {
+	    k0 = std::min(k0, k);
+	    k1 = k + 1;
+	  }
+	}
+	vrange[2*ib] = k0;
+	vrange[2*ib+1] = k1;
+	if (k1 <= k0) k1 = k0 = 0;
+	const unsigned int n = k1 - k0;
+
+	double * __restrict__ ei_cache = &buffer[6*nv*ib];
+	double * __restrict__ ei = ei_cache + nv;
+	double * __restrict__ se = ei + nv;
+	double * __restrict__ sw = se + nv;
+	double * __restrict__ swz = sw + nv;
+	double * __restrict__ swE = swz + nv;
+	const double * __restrict__ vz = y._z + k0;
+	const double * __restrict__ pk = y._pk + k0;
+
+	for (auto j = tks.block_begin[ib]; j != tks.block_begin[ib+1]; ++j) {
+	  const unsigned int i = tks.zorder[j];
+	  const double track_z = tks._z[i];
+	  const double botrack_dz2 = -beta*tks._dz2[i];
+
+	  for (unsigned int k = 0; k < n; ++k) {
+	    auto mult_res = track_z - vz[k];
+	    ei_cache[k] = botrack_dz2 * (mult_res * mult_res);
+	  }
+	  for (unsigned int k = 0; k < n; ++k) ei[k] = vdt::fast_exp(ei_cache[k]);
+
+	  double ZTemp = Z_init;
+	  for (unsigned int k = 0; k < n; ++k) ZTemp += pk[k] * ei[k];
+	  if (edm::isNotFinite(ZTemp)) ZTemp = 0.0;
+	  tks._Z_sum[i] = ZTemp;
+
+	  if (ZTemp > 1.e-100) {
+	    auto tmp_trk_pi = tks._pi[i];
+	    auto o_trk_Z_sum = 1./ZTemp;
+	    auto o_trk_dz2 = tks._dz2[i];
+	    for (unsigned int k = 0; k < n; ++k) {
+	      se[k] += ei[k] * (tmp_trk_pi * o_trk_Z_sum);
+	      auto w = pk[k] * ei[k] * (tmp_trk_pi * o_trk_Z_sum * o_trk_dz2);
+	      sw[k] += w;
+	      swz[k] += w * track_z;
+	      swE[k] += w * ei_cache[k] * obeta;
+	    }
+	  }
+	}
+      }
+    });
+
+    // add the sums of the blocks, always in the same order
+    for (unsigned int ib = 0; ib < nblocks; ++ib) {
+      const unsigned int k0 = vrange[2*ib], k1 = vrange[2*ib+1];
+      const double * se = &buffer[6*nv*ib + 2*nv];
+      const double * sw = se + nv;
+      const double * swz = sw + nv;
+      const double * swE = swz + nv;
+      for (unsigned int k = k0; k < k1; ++k) {
+	y._se[k] += se[k-k0];
+	y._sw[k] += sw[k-k0];
+	y._swz[k] += swz[k-k0];
+	y._swE[k] += swE[k-k0];
+      }
+    }
+  }
 }
 
 double DAClusterizerInZ_vect::update(double beta, track_t & gtracks,
@@ -214,18 +336,24 @@ double DAClusterizerInZ_vect::update(double beta, track_t & gtracks,
   
   
   
-  // loop over tracks
-  for (auto itrack = 0U; itrack < nt; ++itrack) {
-    kernel_calc_exp_arg(itrack, gtracks, gvertices);
-    local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
-    
-    gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
-    if (edm::isNotFinite(gtracks._Z_sum[itrack])) gtracks._Z_sum[itrack] = 0.0;
-    // used in the next major loop to follow
-    sumpi += gtracks._pi[itrack];
-    
-    if (gtracks._Z_sum[itrack] > 1.e-100){
-      kernel_calc_normalization(itrack, gtracks, gvertices);
+  if (runInBlocks_ && gtracks.block_begin.size() > 2) {
+    // same as below, blocks of tracks in parallel
+    for (auto itrack = 0U; itrack < nt; ++itrack) sumpi += gtracks._pi[itrack];
+    updateInBlocks(beta, Z_init, gtracks, gvertices);
+  } else {
+    // loop over tracks
+    for (auto itrack = 0U; itrack < nt; ++itrack) {
+      kernel_calc_exp_arg(itrack, gtracks, gvertices);
+      local_exp_list(gvertices._ei_cache, gvertices._ei, nv);
+      
+      gtracks._Z_sum[itrack] = kernel_add_Z(gvertices);
+      if (edm::isNotFinite(gtracks._Z_sum[itrack])) gtracks._Z_sum[itrack] = 0.0;
+      // used in the next major loop to follow
+      sumpi += gtracks._pi[itrack];
+      
+      if (gtracks._Z_sum[itrack] > 1.e-100){
+	kernel_calc_normalization(itrack, gtracks, gvertices);
+      }
     }
   }
   
@@ -0,0 +1,99 @@
+// Compare the update of DAClusterizerInZ_vect run in blocks (runInBlocks) to the serial one
+// on a toy event of 200 pile-up vertices, and time both.
+// usage: DAClusterizerInZ_vect_t [number of vertices] [number of threads]
+
+#include "RecoVertex/PrimaryVertexProducer/interface/DAClusterizerInZ_vect.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "tbb/task_scheduler_init.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace {
+  edm::ParameterSet daParameters(bool runInBlocks) {
+    edm::ParameterSet conf;
+    conf.addParameter<double>("Tmin", 2.0);
+    conf.addParameter<double>("Tpurge", 2.0);
+    conf.addParameter<double>("Tstop", 0.5);
+    conf.addParameter<double>("vertexSize", 0.006);
+    conf.addParameter<double>("coolingFactor", 0.6);
+    conf.addParameter<double>("d0CutOff", 3.);
+    conf.addParameter<double>("dzCutOff", 3.);
+    conf.addParameter<double>("zmerge", 1e-2);
+    conf.addParameter<double>("uniquetrkweight", 0.8);
+    conf.addParameter<bool>("runInBlocks", runInBlocks);
+    conf.addParameter<unsigned int>("blockSize", 256);
+    return conf;
+  }
+}
+
+int main(int argc, char ** argv) {
+  int npu = argc > 1 ? std::atoi(argv[1]) : 200;
+  int nthreads = argc > 2 ? std::atoi(argv[2]) : tbb::task_scheduler_init::default_num_threads();
+  tbb::task_scheduler_init init(nthreads);
+
+  DAClusterizerInZ_vect serial(daParameters(false));
+  DAClusterizerInZ_vect blocks(daParameters(true));
+
+  // toy tracks: gaussian beam spot, 5 to 45 tracks per vertex, 50 to 550 um resolution
+  std::mt19937 rng(3);
+  std::normal_distribution<double> gauss(0, 1);
+  std::uniform_real_distribution<double> flat(0, 1);
+  DAClusterizerInZ_vect::track_t tks;
+  for (int v = 0; v < npu; ++v) {
+    double zv = 4. * gauss(rng);
+    int n = 5 + int(40 * flat(rng));
+    for (int i = 0; i < n; ++i) {
+      double sigma = 0.005 + 0.05 * flat(rng);
+      tks.AddItem(zv + sigma * gauss(rng), 1. / (sigma * sigma + 0.006 * 0.006), nullptr, 1.);
+    }
+  }
+  tks.ExtractRaw();
+  blocks.makeBlocks(tks);
+  const unsigned int nt = tks.GetSize();
+
+  // prototypes spread over the luminous region
+  DAClusterizerInZ_vect::vertex_t y;
+  const int nv = 3 * npu / 2;
+  for (int k = 0; k < nv; ++k) y.AddItem(-15. + 30. * (k + 0.5) / nv, 1. / nv);
+
+  std::cout << nt << " tracks, " << nv << " prototypes, " << nthreads << " threads" << std::endl;
+
+  bool ok = true;
+  for (double T : {25., 4., 1., 0.5}) {
+    double tSerial = 0, tBlocks = 0, maxdz = 0, maxdpk = 0, maxdZ = 0;
+    for (int it = 0; it < 20; ++it) {
+      // both start from the same state: the differences come from the order of the sums only
+      auto tks2 = tks;
+      tks2.ExtractRaw();
+      auto y2 = y;
+      y2.ExtractRaw();
+      bool useRho0 = it > 10;
+      auto t0 = std::chrono::steady_clock::now();
+      serial.update(1. / T, tks, y, useRho0, 1. / nt);
+      auto t1 = std::chrono::steady_clock::now();
+      blocks.update(1. / T, tks2, y2, useRho0, 1. / nt);
+      auto t2 = std::chrono::steady_clock::now();
+      tSerial += std::chrono::duration<double, std::milli>(t1 - t0).count();
+      tBlocks += std::chrono::duration<double, std::milli>(t2 - t1).count();
+
+      for (int k = 0; k < nv; ++k) {
+	maxdz = std::max(maxdz, std::abs(y._z[k] - y2._z[k]));
+	if (y._pk[k] > 0) maxdpk = std::max(maxdpk, std::abs(y._pk[k] - y2._pk[k]) / y._pk[k]);
+      }
+      for (unsigned int i = 0; i < nt; ++i)
+	if (tks._Z_sum[i] > 1.e-100) maxdZ = std::max(maxdZ, std::abs(tks._Z_sum[i] - tks2._Z_sum[i]) / tks._Z_sum[i]);
+    }
+    std::cout << "T=" << T << "  20 updates: serial " << tSerial << " ms, blocks " << tBlocks << " ms"
+	      << "  max |dz| " << maxdz << " max rel dpk " << maxdpk << " max rel dZ " << maxdZ << std::endl;
+    if (maxdz > 1.e-9 || maxdpk > 1.e-9 || maxdZ > 1.e-9) ok = false;
+  }
+
+  if (!ok) std::cout << "blocks and serial updates differ" << std::endl;
+  return ok ? 0 : 1;
+}
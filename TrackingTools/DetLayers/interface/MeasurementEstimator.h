@@ -46,6 +46,16 @@ public:
   virtual HitReturnType estimate( const TrajectoryStateOnSurface& ts, 
 				  const TrackingRecHit& hit) const = 0;
 
+  /** Fills result[i] with estimate(ts,*hits[i]) for the n hits.
+   *  Estimators able to process several hits at once (e.g. in SIMD lanes)
+   *  override it; the default just loops.
+   */
+  virtual void estimateBatch( const TrajectoryStateOnSurface& ts,
+			      const TrackingRecHit * const * hits, unsigned int n,
+			      HitReturnType * result) const {
+    for (unsigned int i=0; i<n; ++i) result[i] = estimate(ts,*hits[i]);
+  }
+
   /* verify the compatibility of the Hit with the Trajectory based
    * on hit properties other than those used in estimate 
    * (that usually computes the compatibility of the Trajectory with the Hit)
@@ -0,0 +1,68 @@
+#ifndef HelixArbitraryPlaneCrossingSoA_H
+#define HelixArbitraryPlaneCrossingSoA_H
+
+#include "DataFormats/TrajectorySeed/interface/PropagationDirection.h"
+#include "TrackingTools/GeomPropagators/interface/HelixPlaneCrossing.h"
+
+#include <vector>
+
+class Plane;
+
+/** Structure-of-arrays version of HelixArbitraryPlaneCrossing:
+ *  intersections of a batch of helices with planes (one plane per helix
+ *  or one plane for all of them).
+ *  Same algorithm as the scalar class (2nd order start followed by
+ *  2nd order corrections from the full helix) with all helices
+ *  iterated together, lanes that converged are just masked.
+ *  The inner loops are written to be auto-vectorized.
+ */
+
+class HelixArbitraryPlaneCrossingSoA {
+public:
+  typedef HelixPlaneCrossing::PositionType  PositionType;
+  typedef HelixPlaneCrossing::DirectionType DirectionType;
+
+  explicit HelixArbitraryPlaneCrossingSoA(const PropagationDirection propDir = alongMomentum) :
+    thePropDir(propDir) {}
+
+  void reserve(unsigned int n);
+  void clear();
+  unsigned int size() const { return theX0.size();}
+
+  /// add a helix (point, direction and transverse curvature)
+  void push_back(const PositionType& point, const DirectionType& direction, const float curvature);
+
+  /// path lengths of all helices to the same plane
+  void pathLength(const Plane& plane, double * s, bool * ok) const;
+
+  /// path length of helix i to planes[i]
+  void pathLength(const Plane * const * planes, double * s, bool * ok) const;
+
+  /// position and direction of all helices at path length s
+  void positionAndDirection(const double * s, PositionType * pos, DirectionType * dir) const;
+
+private:
+  void solve(double * s, bool * ok) const;
+
+  // as Plane::localZ (single precision, as in the scalar iteration)
+  float localZ(unsigned int k, double x, double y, double z) const {
+    return theNx[k]*(float(x)-thePx[k]) + theNy[k]*(float(y)-thePy[k]) + theNz[k]*(float(z)-thePz[k]);
+  }
+
+  const PropagationDirection thePropDir;
+
+  // helices
+  std::vector<double> theX0, theY0, theZ0;
+  std::vector<double> theCosPhi0, theSinPhi0;
+  std::vector<double> theCosTheta, theSinTheta;
+  std::vector<double> theRho;
+
+  // planes (normal and position) for the current solve
+  mutable std::vector<float> theNx, theNy, theNz, thePx, thePy, thePz;
+  mutable std::vector<float> theMaxDist;
+
+  static const float theNumericalPrecision;
+  static const float theMaxDistToPlane;
+};
+
+#endif
@@ -0,0 +1,244 @@
+#include "TrackingTools/GeomPropagators/interface/HelixArbitraryPlaneCrossingSoA.h"
+#include "DataFormats/GeometrySurface/interface/Plane.h"
+
+#include <cmath>
+#include <cfloat>
+#include <vdt/vdtMath.h>
+#include "FWCore/Utilities/interface/isFinite.h"
+
+namespace {
+
+  // same as HelixArbitraryPlaneCrossing2Order::solutionByDirection
+  inline bool solutionByDirection(const double dS1, const double dS2,
+				  const PropagationDirection propDir, double & path) {
+    bool valid = false;
+    path = 0;
+    if ( propDir == anyDirection ) {
+      valid = true;
+      path = std::abs(dS1)<std::abs(dS2) ? dS1 : dS2;
+    }
+    else {
+      double propSign = propDir==alongMomentum ? 1 : -1;
+      double s1(propSign*dS1);
+      double s2(propSign*dS2);
+      if ( s1 > s2 ) std::swap(s1,s2);
+      if ( (s1<0) & (s2>=0) ) {
+	valid = true;
+	path = propSign*s2;
+      }
+      else if ( s1>=0 ) {
+	valid = true;
+	path = propSign*s1;
+      }
+    }
+    if (edm::isNotFinite(path)) valid = false;
+    return valid;
+  }
+
+  // same as HelixArbitraryPlaneCrossing2Order::pathLength
+  inline bool quadraticPathLength(double cP, double nPx, double nPy, double nPz,
+				  double cosPhi0, double sinPhi0, double cosTheta, double sinThetaI,
+				  double rho, const PropagationDirection propDir, double & path) {
+    double ceq1 = rho*(nPx*sinPhi0-nPy*cosPhi0);
+    double ceq2 = nPx*cosPhi0 + nPy*sinPhi0 + nPz*cosTheta*sinThetaI;
+    double ceq3 = cP;
+    double dS1,dS2;
+    if ( std::abs(ceq1)>FLT_MIN ) {
+      double deq1 = ceq2*ceq2;
+      double deq2 = ceq1*ceq3;
+      if ( std::abs(deq1)<FLT_MIN || std::abs(deq2/deq1)>1.e-6 ) {
+	double deq = deq1+2*deq2;
+	if ( deq<0. ) { path=0; return false;}
+	double ceq =  ceq2+std::copysign(std::sqrt(deq),ceq2);
+	dS1 = (ceq/ceq1)*sinThetaI;
+	dS2 = -2.*(ceq3/ceq)*sinThetaI;
+      }
+      else {
+	double ceq = (ceq2/ceq1)*sinThetaI;
+	double deq = deq2/deq1;
+	deq *= (1-0.5*deq);
+	dS1 = -ceq*deq;
+	dS2 = ceq*(2+deq);
+      }
+    }
+    else {
+      dS1 = dS2 = -(ceq3/ceq2)*sinThetaI;
+    }
+    return solutionByDirection(dS1,dS2,propDir,path);
+  }
+
+}
+
+
+void HelixArbitraryPlaneCrossingSoA::reserve(unsigned int n) {
+  theX0.reserve(n); theY0.reserve(n); theZ0.reserve(n);
+  theCosPhi0.reserve(n); theSinPhi0.reserve(n);
+  theCosTheta.reserve(n); theSinTheta.reserve(n);
+  theRho.reserve(n);
+}
+
+void HelixArbitraryPlaneCrossingSoA::clear() {
+  theX0.clear(); theY0.clear(); theZ0.clear();
+  theCosPhi0.clear(); theSinPhi0.clear();
+  theCosTheta.clear(); theSinTheta.clear();
+  theRho.clear();
+}
+
+void HelixArbitraryPlaneCrossingSoA::push_back(const PositionType& point,
+					       const DirectionType& direction,
+					       const float curvature) {
+  // as in HelixArbitraryPlaneCrossing constructor
+  double px = direction.x();
+  double py = direction.y();
+  double pz = direction.z();
+  double pt2 = px*px+py*py;
+  double p2 = pt2+pz*pz;
+  double pI = 1./sqrt(p2);
+  double ptI = 1./sqrt(pt2);
+  theX0.push_back(point.x());
+  theY0.push_back(point.y());
+  theZ0.push_back(point.z());
+  theCosPhi0.push_back(px*ptI);
+  theSinPhi0.push_back(py*ptI);
+  theCosTheta.push_back(pz*pI);
+  theSinTheta.push_back(pt2*ptI*pI);
+  theRho.push_back(curvature);
+}
+
+void HelixArbitraryPlaneCrossingSoA::pathLength(const Plane& plane, double * s, bool * ok) const {
+  auto n = size();
+  GlobalVector u = plane.normalVector();
+  float maxNumDz = theNumericalPrecision*plane.position().mag();
+  float safeMaxDist = (theMaxDistToPlane>maxNumDz?theMaxDistToPlane:maxNumDz);
+  theNx.assign(n,u.x()); theNy.assign(n,u.y()); theNz.assign(n,u.z());
+  thePx.assign(n,plane.position().x()); thePy.assign(n,plane.position().y()); thePz.assign(n,plane.position().z());
+  theMaxDist.assign(n,safeMaxDist);
+  solve(s,ok);
+}
+
+void HelixArbitraryPlaneCrossingSoA::pathLength(const Plane * const * planes, double * s, bool * ok) const {
+  auto n = size();
+  theNx.resize(n); theNy.resize(n); theNz.resize(n);
+  thePx.resize(n); thePy.resize(n); thePz.resize(n);
+  theMaxDist.resize(n);
+  for (unsigned int k=0; k<n; ++k) {
+    auto const & plane = *planes[k];
+    GlobalVector u = plane.normalVector();
+    float maxNumDz = theNumericalPrecision*plane.position().mag();
+    theMaxDist[k] = (theMaxDistToPlane>maxNumDz?theMaxDistToPlane:maxNumDz);
+    theNx[k]=u.x(); theNy[k]=u.y(); theNz[k]=u.z();
+    thePx[k]=plane.position().x(); thePy[k]=plane.position().y(); thePz[k]=plane.position().z();
+  }
+  solve(s,ok);
+}
+
+void HelixArbitraryPlaneCrossingSoA::solve(double * s, bool * ok) const {
+  constexpr int maxIterations = 20;
+  const unsigned int n = size();
+
+  std::vector<PropagationDirection> propDir(n,thePropDir);
+  std::vector<char> active(n,0);
+  std::vector<double> xn(n), yn(n), zn(n), cn(n), sn(n);
+
+  // first pass: 2nd order from the starting point
+  for (unsigned int k=0; k<n; ++k) {
+    s[k]=0; ok[k]=true;
+    float dz = localZ(k,theX0[k],theY0[k],theZ0[k]);
+    if (std::abs(dz)<theMaxDist[k]) continue;
+    ok[k] = quadraticPathLength(dz,theNx[k],theNy[k],theNz[k],
+				theCosPhi0[k],theSinPhi0[k],theCosTheta[k],1./theSinTheta[k],
+				theRho[k],thePropDir,s[k]);
+    if (!ok[k]) continue;
+    auto newDir = s[k]>=0 ? alongMomentum : oppositeToMomentum;
+    if (propDir[k]==anyDirection) propDir[k]=newDir;
+    else if (newDir!=propDir[k]) { ok[k]=false; s[k]=0; continue;}
+    active[k]=1;
+  }
+
+  for (int iteration=maxIterations; iteration>0; --iteration) {
+    // position and direction at the current path length (all lanes, vectorizable)
+    for (unsigned int k=0; k<n; ++k) {
+      double sinTheta = theSinTheta[k];
+      double sinThetaI = 1./sinTheta;
+      double dphi = s[k]*theRho[k]*sinTheta;
+      double sdphi, cdphi;
+      vdt::fast_sincos(dphi,sdphi,cdphi);
+      double o = 1./theRho[k];
+      double cp = theCosPhi0[k], sp = theSinPhi0[k];
+      // full helix
+      double xh = theX0[k]+(-sp*(1.-cdphi)+cp*sdphi)*o;
+      double yh = theY0[k]+( cp*(1.-cdphi)+sp*sdphi)*o;
+      double ch = cp*cdphi-sp*sdphi;
+      double shh = sp*cdphi+cp*sdphi;
+      // 2nd order from start
+      double st = s[k]*sinTheta;
+      double x2 = theX0[k]+(cp-(st*0.5*theRho[k])*sp)*st;
+      double y2 = theY0[k]+(sp+(st*0.5*theRho[k])*cp)*st;
+      double dph = s[k]*theRho[k]*sinTheta;
+      double c2 = cp-(sp+0.5*dph*cp)*dph;
+      double s2 = sp+(cp-0.5*dph*sp)*dph;
+      bool full = std::abs(dphi)>1.e-4;
+      xn[k] = full ? xh : x2;
+      yn[k] = full ? yh : y2;
+      zn[k] = full ? theZ0[k]+s[k]*theCosTheta[k] : theZ0[k]+st*theCosTheta[k]*sinThetaI;
+      cn[k] = full ? ch : c2;
+      sn[k] = full ? shh : s2;
+    }
+
+    // convergence and next 2nd order step
+    unsigned int nActive=0;
+    for (unsigned int k=0; k<n; ++k) {
+      if (!active[k]) continue;
+      float dz = localZ(k,xn[k],yn[k],zn[k]);
+      if (std::abs(dz)<=theMaxDist[k]) { active[k]=0; continue;}
+      if (iteration==1) { ok[k]=false; s[k]=0; active[k]=0; continue;}   // no convergence
+      double ds=0;
+      if (!quadraticPathLength(dz,theNx[k],theNy[k],theNz[k],
+			       cn[k],sn[k],theCosTheta[k],1./theSinTheta[k],
+			       theRho[k],anyDirection,ds)) {
+	ok[k]=false; s[k]=ds; active[k]=0; continue;
+      }
+      s[k] += ds;
+      auto newDir = s[k]>=0 ? alongMomentum : oppositeToMomentum;
+      if (propDir[k]==anyDirection) propDir[k]=newDir;
+      else if (newDir!=propDir[k]) { ok[k]=false; s[k]=0; active[k]=0; continue;}
+      ++nActive;
+    }
+    if (nActive==0) break;
+  }
+}
+
+void HelixArbitraryPlaneCrossingSoA::positionAndDirection(const double * s,
+							  PositionType * pos, DirectionType * dir) const {
+  const unsigned int n = size();
+  for (unsigned int k=0; k<n; ++k) {
+    double sinTheta = theSinTheta[k];
+    double sinThetaI = 1./sinTheta;
+    double dphi = s[k]*theRho[k]*sinTheta;
+    double sdphi, cdphi;
+    vdt::fast_sincos(dphi,sdphi,cdphi);
+    double cp = theCosPhi0[k], sp = theSinPhi0[k];
+    if ( std::abs(dphi)>1.e-4 ) {
+      double o = 1./theRho[k];
+      pos[k] = PositionType(theX0[k]+(-sp*(1.-cdphi)+cp*sdphi)*o,
+			    theY0[k]+( cp*(1.-cdphi)+sp*sdphi)*o,
+			    theZ0[k]+s[k]*theCosTheta[k]);
+      dir[k] = DirectionType(cp*cdphi-sp*sdphi,
+			     sp*cdphi+cp*sdphi,
+			     theCosTheta[k]/sinTheta);
+    }
+    else {
+      double st = s[k]*sinTheta;
+      pos[k] = PositionType(theX0[k]+(cp-(st*0.5*theRho[k])*sp)*st,
+			    theY0[k]+(sp+(st*0.5*theRho[k])*cp)*st,
+			    theZ0[k]+st*theCosTheta[k]*sinThetaI);
+      double dph = s[k]*theRho[k]*sinTheta;
+      dir[k] = DirectionType(cp-(sp+0.5*dph*cp)*dph,
+			     sp+(cp-0.5*dph*sp)*dph,
+			     theCosTheta[k]*sinThetaI);
+    }
+  }
+}
+
+const float HelixArbitraryPlaneCrossingSoA::theNumericalPrecision = 5.e-7f;
+const float HelixArbitraryPlaneCrossingSoA::theMaxDistToPlane = 1.e-4f;
@@ -3,11 +3,16 @@
 #include "TrackingTools/GeomPropagators/interface/HelixBarrelPlaneCrossing2OrderLocal.h"
 #include "TrackingTools/GeomPropagators/interface/HelixBarrelPlaneCrossingByCircle.h"
 #include "TrackingTools/GeomPropagators/interface/OptimalHelixPlaneCrossing.h"
+#include "TrackingTools/GeomPropagators/interface/HelixArbitraryPlaneCrossingSoA.h"
 
 
 #include <algorithm>
 #include <cmath>
 #include<tuple>
+#include<vector>
+#include<memory>
+#include<chrono>
+#include<cassert>
 
 #include<iostream>
 
@@ -205,11 +210,163 @@ void testHelixBarrelPlaneCrossing2OrderLocal() {
 }
 
 
+// batch vs scalar HelixArbitraryPlaneCrossing: many helices to one plane and one helix to many planes
+void testHelixArbitraryPlaneCrossingSoA() {
+
+  GlobalPoint startingPos(-8.12604,-50.829,9.82116);
+  GlobalPoint  pos(-2.96723,-51.4573,14.8322);
+  Surface::RotationType rot(0.995041,0.0994701,0.000124443,
+			    0.000108324,-0.00233467,0.999997,
+			    0.0994701,-0.995038,-0.00233387);
+  Plane plane(pos,rot);
+
+  constexpr unsigned int N = 4096;
+  std::vector<HelixPlaneCrossing::DirectionType> dirs; dirs.reserve(N);
+  std::vector<double> rhos; rhos.reserve(N);
+  HelixArbitraryPlaneCrossingSoA batch(alongMomentum);
+  batch.reserve(N);
+  for (unsigned int i=0; i<N; ++i) {
+    float phi = -1.67f + 0.2f*float(i)/float(N);
+    float eta = -0.5f + float(i%64)/64.f;
+    HelixPlaneCrossing::DirectionType dir(std::cos(phi),std::sin(phi),std::sinh(eta));
+    double rho = (i&1 ? 1. : -1.)*(0.0005+0.02*float(i%37)/37.);
+    dirs.push_back(dir); rhos.push_back(rho);
+    batch.push_back(HelixPlaneCrossing::PositionType(startingPos),dir,rho);
+  }
+
+  std::vector<double> s(N);
+  std::unique_ptr<bool[]> ok(new bool[N]);
+  std::vector<HelixPlaneCrossing::PositionType> bpos(N);
+  std::vector<HelixPlaneCrossing::DirectionType> bdir(N);
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+  batch.pathLength(plane,s.data(),ok.get());
+  batch.positionAndDirection(s.data(),bpos.data(),bdir.data());
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  double maxdx=0;
+  unsigned int nok=0, nmis=0;
+  for (unsigned int i=0; i<N; ++i) {
+    HelixArbitraryPlaneCrossing crossing(HelixPlaneCrossing::PositionType(startingPos),dirs[i],rhos[i],alongMomentum);
+    bool cross; double ss;
+    std::tie(cross,ss) = crossing.pathLength(plane);
+    if (cross!=ok[i]) { ++nmis; continue;}
+    if (!cross) continue;
+    ++nok;
+    maxdx = std::max(maxdx,double((crossing.position(ss)-bpos[i]).mag()));
+  }
+  auto t2 = std::chrono::high_resolution_clock::now();
+  std::cout << "SoA crossing: " << nok << " valid, " << nmis << " status mismatches, max distance " << maxdx << std::endl;
+  std::cout << "batch " << std::chrono::duration_cast<std::chrono::nanoseconds>(t1-t0).count()/double(N)
+	    << " ns/helix, scalar " << std::chrono::duration_cast<std::chrono::nanoseconds>(t2-t1).count()/double(N)
+	    << " ns/helix" << std::endl;
+  assert(nmis==0);
+  assert(maxdx<1.e-4);
+
+  // one helix to many planes
+  std::vector<std::unique_ptr<Plane> > planes;
+  std::vector<const Plane *> pplanes;
+  HelixArbitraryPlaneCrossingSoA one(alongMomentum);
+  for (unsigned int i=0; i<64; ++i) {
+    planes.emplace_back(new Plane(GlobalPoint(pos.x(),pos.y()-0.5f*float(i),pos.z()),rot));
+    pplanes.push_back(planes.back().get());
+    one.push_back(HelixPlaneCrossing::PositionType(startingPos),dirs[0],rhos[0]);
+  }
+  one.pathLength(pplanes.data(),s.data(),ok.get());
+  maxdx=0; nmis=0;
+  for (unsigned int i=0; i<64; ++i) {
+    HelixArbitraryPlaneCrossing crossing(HelixPlaneCrossing::PositionType(startingPos),dirs[0],rhos[0],alongMomentum);
+    auto res = crossing.pathLength(*planes[i]);
+    if (res.first!=ok[i]) ++nmis;
+    else if (res.first) maxdx = std::max(maxdx,std::abs(res.second-s[i]));
+  }
+  std::cout << "SoA crossing to many planes: " << nmis << " status mismatches, max path difference " << maxdx << std::endl;
+  assert(nmis==0);
+  assert(maxdx<1.e-4);
+}
+
+
+// batch SoA crossing vs the crossing used by AnalyticalPropagator::propagateWithPath
+// (OptimalHelixPlaneCrossing: by circle for barrel planes, forward crossing for
+// planes normal to z, arbitrary crossing otherwise), helix by helix on barrel,
+// forward and tilted planes
+void testHelixArbitraryPlaneCrossingSoAVsOptimal() {
+
+  // tolerances on the position (cm), direction (rad) and path length (cm): both
+  // iterations stop within 1 micron of the plane (theMaxDistToPlane), possibly on
+  // opposite sides for helices crossing at moderate angles
+  constexpr double maxDistance = 2.e-4, maxAngle = 1.e-6, maxPath = 2.e-4;
+
+  constexpr float phi0 = 0.7f, tilt = 0.35f;
+  const float c = std::cos(phi0), s = std::sin(phi0), ct = std::cos(tilt), st = std::sin(tilt);
+  Plane barrel(GlobalPoint(10.f*c,10.f*s,0.f),
+	       Surface::RotationType(-s,c,0.f, 0.f,0.f,1.f, c,s,0.f));
+  Plane forward(GlobalPoint(0.f,0.f,50.f),Surface::RotationType());
+  Plane tilted(GlobalPoint(10.f*c,10.f*s,20.f),
+	       Surface::RotationType(-s,c,0.f, -st*c,-st*s,ct, ct*c,ct*s,st));
+
+  const char * names[3] = {"barrel","forward","tilted"};
+  const Plane * planes[3] = {&barrel,&forward,&tilted};
+  // polar angle of the helices crossing each plane
+  const float thetas[3] = {1.5708f,0.2f,1.1f};
+
+  constexpr unsigned int N = 2048;
+  for (unsigned int ip=0; ip<3; ++ip) {
+    const Plane & plane = *planes[ip];
+    std::vector<HelixPlaneCrossing::PositionType> starts; starts.reserve(N);
+    std::vector<HelixPlaneCrossing::DirectionType> dirs; dirs.reserve(N);
+    std::vector<double> rhos; rhos.reserve(N);
+    HelixArbitraryPlaneCrossingSoA batch(alongMomentum);
+    batch.reserve(N);
+    for (unsigned int i=0; i<N; ++i) {
+      HelixPlaneCrossing::PositionType start(0.01f*float(int(i%7)-3),0.01f*float(int(i%5)-2),0.5f*float(int(i%11)-5));
+      float phi = phi0 - 0.1f + 0.2f*float(i)/float(N);
+      float theta = thetas[ip] - 0.1f + 0.2f*float(i%64)/64.f;
+      HelixPlaneCrossing::DirectionType dir(std::sin(theta)*std::cos(phi),std::sin(theta)*std::sin(phi),std::cos(theta));
+      double rho = (i&1 ? 1. : -1.)*(0.0002+0.01*float(i%37)/37.);
+      starts.push_back(start); dirs.push_back(dir); rhos.push_back(rho);
+      batch.push_back(start,dir,rho);
+    }
+
+    std::vector<double> sb(N);
+    std::unique_ptr<bool[]> ok(new bool[N]);
+    std::vector<HelixPlaneCrossing::PositionType> bpos(N);
+    std::vector<HelixPlaneCrossing::DirectionType> bdir(N);
+    batch.pathLength(plane,sb.data(),ok.get());
+    batch.positionAndDirection(sb.data(),bpos.data(),bdir.data());
+
+    double maxdx=0, maxda=0, maxds=0;
+    unsigned int nok=0, nmis=0;
+    for (unsigned int i=0; i<N; ++i) {
+      OptimalHelixPlaneCrossing crossing(plane,starts[i],dirs[i],rhos[i],alongMomentum);
+      auto res = (*crossing).pathLength(plane);
+      if (res.first!=ok[i]) { ++nmis; continue;}
+      if (!res.first) continue;
+      ++nok;
+      maxdx = std::max(maxdx,double(((*crossing).position(res.second)-bpos[i]).mag()));
+      auto d = (*crossing).direction(res.second);
+      maxda = std::max(maxda,double((d.unit()-bdir[i].unit()).mag()));
+      maxds = std::max(maxds,std::abs(res.second-sb[i]));
+    }
+    std::cout << "SoA vs optimal crossing, " << names[ip] << " plane: " << nok << " valid, " << nmis
+	      << " status mismatches, max distance " << maxdx << " angle " << maxda << " path " << maxds << std::endl;
+    assert(nok>N/2);
+    assert(nmis==0);
+    assert(maxdx<maxDistance);
+    assert(maxda<maxAngle);
+    assert(maxds<maxPath);
+  }
+}
+
 
 int main() {
 
 
   testHelixBarrelPlaneCrossing2OrderLocal();
 
+  testHelixArbitraryPlaneCrossingSoA();
+
+  testHelixArbitraryPlaneCrossingSoAVsOptimal();
+
   return 0;
 }
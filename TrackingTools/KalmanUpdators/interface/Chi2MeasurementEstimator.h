@@ -20,6 +20,11 @@ public:
   std::pair<bool,double> estimate(const TrajectoryStateOnSurface&,
 				     const TrackingRecHit&) const override;
 
+  // 1D and 2D hits in SIMD lanes
+  void estimateBatch(const TrajectoryStateOnSurface&,
+		     const TrackingRecHit * const * hits, unsigned int n,
+		     HitReturnType * result) const override;
+
   Chi2MeasurementEstimator* clone() const override {
     return new Chi2MeasurementEstimator(*this);
   }
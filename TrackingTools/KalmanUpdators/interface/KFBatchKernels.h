@@ -0,0 +1,164 @@
+#ifndef TrackingTools_KalmanUpdators_KFBatchKernels_H
+#define TrackingTools_KalmanUpdators_KFBatchKernels_H
+
+/** Structure-of-arrays kernels for the Kalman update and the chi2 estimate
+ *  of a batch of (state, hit) pairs of the same hit dimension D (1 or 2).
+ *
+ *  The gather (getKfComponents) stays scalar; the algebra runs over
+ *  lanes of Vec4<double> (DataFormats/Math/interface/ExtVec.h).
+ *  The filtered covariance is computed in the expanded Joseph form
+ *     C - K*CH^T - CH*K^T + K*R*K^T
+ *  (CH = C*H^T, R = V + H*C*H^T) which is algebraically identical to
+ *  the (I-KH)C(I-KH)^T + KVK^T used by KFUpdator and stays symmetric.
+ *  Symmetric 5x5 matrices use the packed lower storage of MatRepSym.
+ */
+
+#include "DataFormats/Math/interface/ExtVec.h"
+
+namespace kfBatch {
+
+  using VecD = Vec4<double>;
+  constexpr unsigned int nLanes = 4;
+  // number of pairs processed per call, multiple of nLanes
+  constexpr unsigned int chunkSize = 16;
+
+  constexpr unsigned int symIndex(unsigned int i, unsigned int j) {
+    return i>=j ? i*(i+1)/2+j : j*(j+1)/2+i;
+  }
+  constexpr unsigned int symSize(unsigned int d) { return d*(d+1)/2;}
+
+  template<unsigned int D>
+  struct Chi2Soa {
+    alignas(32) double r[D][chunkSize];          // hit - predicted
+    alignas(32) double s[symSize(D)][chunkSize]; // V + H*C*H^T
+    alignas(32) double chi2[chunkSize];
+
+    // make the unused lanes harmless
+    void pad(unsigned int n) {
+      for (unsigned int k=n; k<chunkSize; ++k) {
+        for (unsigned int a=0; a<D; ++a) r[a][k]=0;
+        for (unsigned int a=0; a<symSize(D); ++a) s[a][k]=0;
+        for (unsigned int a=0; a<D; ++a) s[symIndex(a,a)][k]=1.;
+      }
+    }
+  };
+
+  template<unsigned int D>
+  struct UpdateSoa {
+    // input
+    alignas(32) double x[5][chunkSize];
+    alignas(32) double c[15][chunkSize];
+    alignas(32) double ch[5*D][chunkSize];       // C*H^T, row major 5xD
+    alignas(32) double r[D][chunkSize];          // hit - predicted
+    alignas(32) double v[symSize(D)][chunkSize]; // hit error
+    alignas(32) double s[symSize(D)][chunkSize]; // H*C*H^T
+    // output
+    alignas(32) double fx[5][chunkSize];
+    alignas(32) double fc[15][chunkSize];
+    alignas(32) double det[chunkSize];           // >0 if the residual covariance was invertible
+
+    void pad(unsigned int n) {
+      for (unsigned int k=n; k<chunkSize; ++k) {
+        for (unsigned int a=0; a<5; ++a) x[a][k]=0;
+        for (unsigned int a=0; a<15; ++a) c[a][k]=0;
+        for (unsigned int a=0; a<5*D; ++a) ch[a][k]=0;
+        for (unsigned int a=0; a<D; ++a) r[a][k]=0;
+        for (unsigned int a=0; a<symSize(D); ++a) { v[a][k]=0; s[a][k]=0;}
+        for (unsigned int a=0; a<D; ++a) v[symIndex(a,a)][k]=1.;
+      }
+    }
+  };
+
+  namespace detail {
+    inline VecD load(double const * p) { return *reinterpret_cast<VecD const *>(p);}
+    inline void store(double * p, VecD v) { *reinterpret_cast<VecD *>(p) = v;}
+
+    // inverse of a symmetric DxD matrix (packed), returns the determinant
+    template<unsigned int D> struct SymInverse;
+
+    template<> struct SymInverse<1> {
+      static VecD invert(VecD const * m, VecD * im) {
+	im[0] = VecD{1.,1.,1.,1.}/m[0];
+	return m[0];
+      }
+    };
+
+    template<> struct SymInverse<2> {
+      static VecD invert(VecD const * m, VecD * im) {
+	auto det = m[0]*m[2] - m[1]*m[1];
+	auto idet = VecD{1.,1.,1.,1.}/det;
+	im[0] = m[2]*idet;
+	im[1] = -m[1]*idet;
+	im[2] = m[0]*idet;
+	return det;
+      }
+    };
+  }
+
+  /// chi2 = r^T * S^-1 * r for the first n entries of the batch
+  template<unsigned int D>
+  inline void chi2(Chi2Soa<D> & b, unsigned int n) {
+    using namespace detail;
+    for (unsigned int k=0; k<n; k+=nLanes) {
+      VecD r[D], s[symSize(D)], is[symSize(D)];
+      for (unsigned int a=0; a<D; ++a) r[a]=load(b.r[a]+k);
+      for (unsigned int a=0; a<symSize(D); ++a) s[a]=load(b.s[a]+k);
+      SymInverse<D>::invert(s,is);
+      VecD res = VecD{0.,0.,0.,0.};
+      for (unsigned int a=0; a<D; ++a)
+	for (unsigned int e=0; e<D; ++e)
+	  res += r[a]*is[symIndex(a,e)]*r[e];
+      store(b.chi2+k,res);
+    }
+  }
+
+  /// Kalman filter update for the first n entries of the batch
+  template<unsigned int D>
+  inline void update(UpdateSoa<D> & b, unsigned int n) {
+    using namespace detail;
+    for (unsigned int k=0; k<n; k+=nLanes) {
+      VecD ch[5][D], r[D], rr[symSize(D)], ir[symSize(D)], kg[5][D];
+      for (unsigned int i=0; i<5; ++i)
+	for (unsigned int a=0; a<D; ++a) ch[i][a] = load(b.ch[i*D+a]+k);
+      for (unsigned int a=0; a<D; ++a) r[a]=load(b.r[a]+k);
+      for (unsigned int a=0; a<symSize(D); ++a) rr[a]=load(b.v[a]+k)+load(b.s[a]+k);
+      store(b.det+k, SymInverse<D>::invert(rr,ir));
+
+      // Kalman gain K = C*H^T*R^-1
+      for (unsigned int i=0; i<5; ++i)
+	for (unsigned int a=0; a<D; ++a) {
+	  VecD t = VecD{0.,0.,0.,0.};
+	  for (unsigned int e=0; e<D; ++e) t += ch[i][e]*ir[symIndex(e,a)];
+	  kg[i][a] = t;
+	}
+
+      // filtered state
+      for (unsigned int i=0; i<5; ++i) {
+	VecD t = load(b.x[i]+k);
+	for (unsigned int a=0; a<D; ++a) t += kg[i][a]*r[a];
+	store(b.fx[i]+k,t);
+      }
+
+      // R*K^T, column j
+      VecD rk[5][D];
+      for (unsigned int j=0; j<5; ++j)
+	for (unsigned int a=0; a<D; ++a) {
+	  VecD t = VecD{0.,0.,0.,0.};
+	  for (unsigned int e=0; e<D; ++e) t += rr[symIndex(a,e)]*kg[j][e];
+	  rk[j][a] = t;
+	}
+
+      // filtered covariance
+      for (unsigned int i=0; i<5; ++i)
+	for (unsigned int j=0; j<=i; ++j) {
+	  VecD t = load(b.c[symIndex(i,j)]+k);
+	  for (unsigned int a=0; a<D; ++a)
+	    t += kg[i][a]*(rk[j][a]-ch[j][a]) - ch[i][a]*kg[j][a];
+	  store(b.fc[symIndex(i,j)]+k,t);
+	}
+    }
+  }
+
+}
+
+#endif
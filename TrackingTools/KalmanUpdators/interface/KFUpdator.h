@@ -40,6 +40,11 @@ public:
   TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&,
                                   const TrackingRecHit&) const override;
 
+  /// 1D and 2D hits are updated in SIMD lanes (see KFBatchKernels.h), others one by one
+  void updateBatch(const TrajectoryStateOnSurface * tsos,
+                   const TrackingRecHit * const * hits, unsigned int n,
+                   TrajectoryStateOnSurface * result) const override;
+
 
   KFUpdator * clone() const override {
     return new KFUpdator(*this);
@@ -4,6 +4,7 @@
 #include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
 #include "DataFormats/GeometrySurface/interface/Plane.h"
 #include "DataFormats/Math/interface/invertPosDefMatrix.h"
+#include "KFBatchGather.h"
 
 
 namespace {
@@ -43,3 +44,46 @@ Chi2MeasurementEstimator::estimate(const TrajectoryStateOnSurface& tsos,
     }
     throw cms::Exception("RecHit of invalid size (not 1,2,3,4,5)");
 }
+
+namespace {
+  template <unsigned int D>
+  struct Chi2Batch {
+    kfBatch::Chi2Soa<D> soa;
+    unsigned int index[kfBatch::chunkSize];
+    unsigned int n=0;
+
+    template<typename F>
+    void add(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit, unsigned int i, F const & ret) {
+      kfBatch::gather(soa,n,tsos,hit);
+      index[n++]=i;
+      if (n==kfBatch::chunkSize) flush(ret);
+    }
+
+    template<typename F>
+    void flush(F const & ret) {
+      if (n==0) return;
+      soa.pad(n);
+      kfBatch::chi2(soa,n);
+      for (unsigned int k=0; k<n; ++k) ret(index[k],soa.chi2[k]);
+      n=0;
+    }
+  };
+}
+
+void
+Chi2MeasurementEstimator::estimateBatch(const TrajectoryStateOnSurface& tsos,
+					const TrackingRecHit * const * hits, unsigned int n,
+					HitReturnType * result) const {
+  auto ret = [&](unsigned int i, double chi2) { result[i] = returnIt(chi2); };
+  Chi2Batch<1> b1;
+  Chi2Batch<2> b2;
+  for (unsigned int i=0; i<n; ++i) {
+    switch (hits[i]->dimension()) {
+      case 1: b1.add(tsos,*hits[i],i,ret); break;
+      case 2: b2.add(tsos,*hits[i],i,ret); break;
+      default: result[i] = estimate(tsos,*hits[i]);
+    }
+  }
+  b1.flush(ret);
+  b2.flush(ret);
+}
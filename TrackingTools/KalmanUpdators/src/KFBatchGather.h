@@ -0,0 +1,60 @@
+#ifndef TrackingTools_KalmanUpdators_KFBatchGather_H
+#define TrackingTools_KalmanUpdators_KFBatchGather_H
+
+// scalar gather of the Kf components of one (state, hit) pair into lane k of the batch SoA
+
+#include "TrackingTools/KalmanUpdators/interface/KFBatchKernels.h"
+#include "TrackingTools/TrajectoryState/interface/TrajectoryStateOnSurface.h"
+#include "DataFormats/TrackingRecHit/interface/KfComponentsHolder.h"
+#include "DataFormats/TrackingRecHit/interface/TrackingRecHit.h"
+
+namespace kfBatch {
+
+  template<unsigned int D>
+  struct KfComponents {
+    typename AlgebraicROOTObject<D>::Vector r, rMeas;
+    typename AlgebraicROOTObject<D,D>::SymMatrix V, VMeas;
+    ProjectMatrix<double,5,D> pf;
+
+    KfComponents(const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit) :
+      V(ROOT::Math::SMatrixNoInit{}), VMeas(ROOT::Math::SMatrixNoInit{}) {
+      KfComponentsHolder holder;
+      holder.template setup<D>(&r, &V, &pf, &rMeas, &VMeas,
+			       tsos.localParameters().vector(), tsos.localError().matrix());
+      hit.getKfComponents(holder);
+    }
+  };
+
+  template<unsigned int D>
+  inline void gather(Chi2Soa<D> & b, unsigned int k,
+		     const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit) {
+    KfComponents<D> kf(tsos,hit);
+    for (unsigned int a=0; a<D; ++a) {
+      b.r[a][k] = kf.r[a]-kf.rMeas[a];
+      for (unsigned int e=0; e<=a; ++e) b.s[symIndex(a,e)][k] = kf.V(a,e)+kf.VMeas(a,e);
+    }
+  }
+
+  template<unsigned int D>
+  inline void gather(UpdateSoa<D> & b, unsigned int k,
+		     const TrajectoryStateOnSurface& tsos, const TrackingRecHit& hit) {
+    KfComponents<D> kf(tsos,hit);
+    auto && x = tsos.localParameters().vector();
+    auto && C = tsos.localError().matrix();
+    for (unsigned int i=0; i<5; ++i) {
+      b.x[i][k] = x[i];
+      for (unsigned int j=0; j<=i; ++j) b.c[symIndex(i,j)][k] = C(i,j);
+      for (unsigned int a=0; a<D; ++a) b.ch[i*D+a][k] = C(i,kf.pf.index[a]);
+    }
+    for (unsigned int a=0; a<D; ++a) {
+      b.r[a][k] = kf.r[a]-kf.rMeas[a];
+      for (unsigned int e=0; e<=a; ++e) {
+	b.v[symIndex(a,e)][k] = kf.V(a,e);
+	b.s[symIndex(a,e)][k] = kf.VMeas(a,e);
+      }
+    }
+  }
+
+}
+
+#endif
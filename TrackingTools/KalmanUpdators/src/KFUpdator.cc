@@ -6,6 +6,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "DataFormats/Math/interface/invertPosDefMatrix.h"
 #include "DataFormats/Math/interface/ProjectMatrix.h"
+#include "KFBatchGather.h"
 
 
 // test of joseph form
@@ -180,3 +181,61 @@ TrajectoryStateOnSurface KFUpdator::update(const TrajectoryStateOnSurface& tsos,
         ", type is " << typeid(aRecHit).name() << "\n";
 }
 
+
+namespace {
+
+  template <unsigned int D>
+  struct UpdateBatch {
+    kfBatch::UpdateSoa<D> soa;
+    unsigned int index[kfBatch::chunkSize];
+    unsigned int n=0;
+
+    void add(const TrajectoryStateOnSurface * tsos, const TrackingRecHit * const * hits, unsigned int i,
+             TrajectoryStateOnSurface * result) {
+      kfBatch::gather(soa,n,tsos[i],*hits[i]);
+      index[n++]=i;
+      if (n==kfBatch::chunkSize) flush(tsos,result);
+    }
+
+    void flush(const TrajectoryStateOnSurface * tsos, TrajectoryStateOnSurface * result) {
+      if (n==0) return;
+      soa.pad(n);
+      kfBatch::update(soa,n);
+      for (unsigned int k=0; k<n; ++k) {
+        auto const & ts = tsos[index[k]];
+        if ( !(soa.det[k]>0 && soa.v[0][k]+soa.s[0][k]>0) ) {
+          edm::LogError("KFUpdator")<<" could not invert martix in batch update";
+          result[index[k]] = TrajectoryStateOnSurface();
+          continue;
+        }
+        AlgebraicVector5 fsv;
+        AlgebraicSymMatrix55 fse(ROOT::Math::SMatrixNoInit{});
+        for (unsigned int i=0; i<5; ++i) {
+          fsv[i] = soa.fx[i][k];
+          for (unsigned int j=0; j<=i; ++j) fse(i,j) = soa.fc[kfBatch::symIndex(i,j)][k];
+        }
+        result[index[k]] = TrajectoryStateOnSurface( LocalTrajectoryParameters(fsv, ts.localParameters().pzSign()),
+                                                     LocalTrajectoryError(fse), ts.surface(),
+                                                     &(ts.globalParameters().magneticField()), ts.surfaceSide() );
+      }
+      n=0;
+    }
+  };
+
+}
+
+void KFUpdator::updateBatch(const TrajectoryStateOnSurface * tsos,
+                            const TrackingRecHit * const * hits, unsigned int n,
+                            TrajectoryStateOnSurface * result) const {
+  UpdateBatch<1> b1;
+  UpdateBatch<2> b2;
+  for (unsigned int i=0; i<n; ++i) {
+    switch (hits[i]->dimension()) {
+      case 1: b1.add(tsos,hits,i,result); break;
+      case 2: b2.add(tsos,hits,i,result); break;
+      default: result[i] = update(tsos[i],*hits[i]);
+    }
+  }
+  b1.flush(tsos,result);
+  b2.flush(tsos,result);
+}
@@ -102,6 +102,9 @@ void print(TrajectoryStateOnSurface const & ts) {
 #include "FWCore/Utilities/interface/HRRealTime.h"
 #include<iostream>
 #include<vector>
+#include<cassert>
+#include<cmath>
+#include<algorithm>
 
 bool isAligned(const void* data, long alignment)
 {
@@ -257,6 +260,62 @@ int main() {
   chi2.time(ts2,*thit);
 
 
+  std::cout << "\n** batch ** \n" << std::endl;
+
+  // compare batch and scalar path and measure updates/s
+  {
+    constexpr unsigned int N = 1024;
+    std::vector<TrajectoryStateOnSurface> tss; tss.reserve(N);
+    std::vector<const TrackingRecHit *> hits; hits.reserve(N);
+    const TrackingRecHit * hitList[] = {&hitpx, &hit1d, &hit2d, &hitpx};
+    for (unsigned int i=0; i<N; ++i) {
+      tss.push_back( (i&1) ? ts : ts2 );
+      hits.push_back(hitList[i%4]);
+    }
+
+    KFUpdator kfu;
+    Chi2MeasurementEstimator est(10.);
+    std::vector<TrajectoryStateOnSurface> ref(N), res(N);
+    std::vector<std::pair<bool,double> > cref(N), cres(N);
+
+    double maxd=0, maxc=0;
+    kfu.updateBatch(tss.data(), hits.data(), N, res.data());
+    est.estimateBatch(ts, hits.data(), N, cres.data());
+    for (unsigned int i=0; i<N; ++i) {
+      ref[i] = kfu.update(tss[i],*hits[i]);
+      cref[i] = est.estimate(ts,*hits[i]);
+      maxc = std::max(maxc,std::abs(cref[i].second-cres[i].second)/std::max(1.,cref[i].second));
+      auto const & a = ref[i].localError().matrix();
+      auto const & b = res[i].localError().matrix();
+      for (int j=0; j<5; ++j) {
+        maxd = std::max(maxd,std::abs(ref[i].localParameters().vector()[j]-res[i].localParameters().vector()[j]));
+        for (int k=0; k<=j; ++k) maxd = std::max(maxd,std::abs(a(j,k)-b(j,k))/std::sqrt(a(j,j)*a(k,k)));
+      }
+    }
+    std::cout << "max diff update " << maxd << " chi2 " << maxc << std::endl;
+    assert(maxd<1.e-6 && maxc<1.e-6);
+
+    constexpr int nLoop = 100;
+    edm::HRTimeType s= edm::hrRealTime();
+    for (int l=0; l<nLoop; ++l)
+      for (unsigned int i=0; i<N; ++i) ref[i] = kfu.update(tss[i],*hits[i]);
+    edm::HRTimeType e= edm::hrRealTime();
+    for (int l=0; l<nLoop; ++l)
+      kfu.updateBatch(tss.data(), hits.data(), N, res.data());
+    edm::HRTimeType eb= edm::hrRealTime();
+    std::cout << "scalar updates/clock " << double(nLoop*N)/double(e-s)
+	      << " batch updates/clock " << double(nLoop*N)/double(eb-e) << std::endl;
+
+    s= edm::hrRealTime();
+    for (int l=0; l<nLoop; ++l)
+      for (unsigned int i=0; i<N; ++i) cref[i] = est.estimate(ts,*hits[i]);
+    e= edm::hrRealTime();
+    for (int l=0; l<nLoop; ++l)
+      est.estimateBatch(ts, hits.data(), N, cres.data());
+    eb= edm::hrRealTime();
+    std::cout << "scalar chi2/clock " << double(nLoop*N)/double(e-s)
+	      << " batch chi2/clock " << double(nLoop*N)/double(eb-e) << std::endl;
+  }
 
   return 0;
 
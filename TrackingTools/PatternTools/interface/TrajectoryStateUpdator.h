@@ -19,6 +19,13 @@ class TrajectoryStateUpdator {
   
   virtual TrajectoryStateOnSurface update(const TrajectoryStateOnSurface&,
 					  const TrackingRecHit&) const = 0;
+
+  /// result[i] = update(tsos[i],*hits[i]) for n (state, hit) pairs
+  virtual void updateBatch(const TrajectoryStateOnSurface * tsos,
+			   const TrackingRecHit * const * hits, unsigned int n,
+			   TrajectoryStateOnSurface * result) const {
+    for (unsigned int i=0; i<n; ++i) result[i] = update(tsos[i],*hits[i]);
+  }
   
   virtual TrajectoryStateUpdator * clone() const = 0;
   